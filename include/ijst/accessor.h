@@ -121,6 +121,18 @@ public:
 	virtual bool EndObject(rapidjson::SizeType memberCount = 0)= 0;
 	virtual bool StartArray()= 0;
 	virtual bool EndArray(rapidjson::SizeType elementCount = 0)= 0;
+
+	//! Write a whole array of numbers. Default implementations generate the events one by one
+	virtual bool IntArray(const int* vals, rapidjson::SizeType count)
+	{ return detail::WriteNumberArray(*this, vals, count); }
+	virtual bool UintArray(const unsigned* vals, rapidjson::SizeType count)
+	{ return detail::WriteNumberArray(*this, vals, count); }
+	virtual bool Int64Array(const int64_t* vals, rapidjson::SizeType count)
+	{ return detail::WriteNumberArray(*this, vals, count); }
+	virtual bool Uint64Array(const uint64_t* vals, rapidjson::SizeType count)
+	{ return detail::WriteNumberArray(*this, vals, count); }
+	virtual bool DoubleArray(const double* vals, rapidjson::SizeType count)
+	{ return detail::WriteNumberArray(*this, vals, count); }
 };
 
 
@@ -165,8 +177,25 @@ public:
 	{ return h.StartArray(); }
 	bool EndArray(rapidjson::SizeType elementCount = 0) IJSTI_OVERRIDE
 	{ return h.EndArray(elementCount); }
+	bool IntArray(const int* vals, rapidjson::SizeType count) IJSTI_OVERRIDE
+	{ return detail::WriteNumberArray(h, vals, count); }
+	bool UintArray(const unsigned* vals, rapidjson::SizeType count) IJSTI_OVERRIDE
+	{ return detail::WriteNumberArray(h, vals, count); }
+	bool Int64Array(const int64_t* vals, rapidjson::SizeType count) IJSTI_OVERRIDE
+	{ return detail::WriteNumberArray(h, vals, count); }
+	bool Uint64Array(const uint64_t* vals, rapidjson::SizeType count) IJSTI_OVERRIDE
+	{ return detail::WriteNumberArray(h, vals, count); }
+	bool DoubleArray(const double* vals, rapidjson::SizeType count) IJSTI_OVERRIDE
+	{ return detail::WriteNumberArray(h, vals, count); }
 };
 
+namespace detail {
+
+//! (De)serializer of MessagePack and schema-indexed binary encoding of Accessor, defined in "msgpack.h"
+template<typename Encoding> class MsgPackCodec;
+
+}	// namespace detail
+
 #define IJSTI_OPTIONAL_BASE_DEFINE(T)						\
 	public:													\
 		/** @brief Constructor */ 							\
@@ -235,6 +264,74 @@ const MetaClassInfo<typename T::_ijst_Ch>& GetMetaInfo()
 	return detail::Singleton<detail::MetaClassInfoTyped<T> >().metaClass;
 }
 
+/**
+ * @brief Arena of allocations when deserializing object trees.
+ *
+ * While an ArenaScope is alive, the ijst structs and T_raw fields in the same thread that choose their allocator
+ * (e.g., in Deserialize(), or the first time GetAllocator() is called) use the allocator of the arena instead of
+ * creating their own ones. Deserialize() also creates the intermediate document in the arena and moves values from it.
+ * So all unknown fields and T_raw values of the tree are allocated by bumping a pointer, and released at once
+ * when the scope is destroyed. Scopes could be nested, and the innermost one is used.
+ *
+ * @note	The objects that use the arena must not be accessed after the scope is destroyed,
+ * 			unless ShrinkAllocator() is called to copy their values to own allocators.
+ *
+ * @see Accessor::GetAllocator(), Accessor::ShrinkAllocator()
+ */
+class ArenaScope {
+public:
+	//! Default size of chunk allocated by the arena
+	static const size_t kDefaultChunkCapacity = 64 * 1024;
+
+	explicit ArenaScope(size_t chunkSize = kDefaultChunkCapacity)
+		: m_allocator(chunkSize), m_pPrev(Current())
+	{
+		Current() = this;
+	}
+
+	/**
+	 * @brief Construct arena that allocates from user buffer first.
+	 *
+	 * @param buffer		User buffer, which must outlive the scope
+	 * @param size			Size of buffer
+	 * @param chunkSize		Size of chunk allocated when buffer is used up
+	 */
+	ArenaScope(void* buffer, size_t size, size_t chunkSize = kDefaultChunkCapacity)
+		: m_allocator(buffer, size, chunkSize), m_pPrev(Current())
+	{
+		Current() = this;
+	}
+
+	~ArenaScope()
+	{
+		IJST_ASSERT(Current() == this);
+		Current() = m_pPrev;
+	}
+
+	//! Get allocator of arena
+	rapidjson::MemoryPoolAllocator<>& GetAllocator() { return m_allocator; }
+
+	//! Get allocator of the innermost scope in current thread, NULL if there is none
+	static rapidjson::MemoryPoolAllocator<>* GetCurrentAllocator()
+	{
+		ArenaScope* pCurrent = Current();
+		return pCurrent == NULL ? NULL : &pCurrent->m_allocator;
+	}
+
+private:
+	ArenaScope(const ArenaScope&) IJSTI_DELETED;
+	ArenaScope& operator=(const ArenaScope&) IJSTI_DELETED;
+
+	static ArenaScope*& Current()
+	{
+		static IJSTI_THREAD_LOCAL ArenaScope* pCurrent = NULL;
+		return pCurrent;
+	}
+
+	detail::JsonAllocator m_allocator;
+	ArenaScope* m_pPrev;
+};
+
 /**
  * @brief Accessor of ijst struct
  *
@@ -247,65 +344,40 @@ class Accessor {
 public:
 	typedef typename Encoding::Ch Ch;
 	//! Constructor
+	//! @note It will not allocate in heap unless the struct has more than detail::kBitWordSize fields
 	explicit Accessor(const MetaClassInfo<Ch>* pMetaClass, bool isParentVal, bool isValid)
-			: m_r(NULL)
 	{
 		IJST_ASSERT(!isParentVal || pMetaClass->GetFieldsInfo().size() == 1);
-
-		// Allocate fieldStatus followed by m_r
-		const size_t sizeFieldStatus = pMetaClass->GetFieldsInfo().size();
-		m_r = static_cast<Resource *>(operator new(
-				sizeof(Resource) + sizeFieldStatus * sizeof(EFStatus)));
-		m_r->fieldStatus = reinterpret_cast<EFStatus*>(m_r + 1);
-
-		m_r->pMetaClass = pMetaClass;
-		InitOuterPtr();
-		m_r->isValid = isValid;
-		m_r->isParentVal = isParentVal;
-
-		// Init fieldStatus with kMissing
-		for (size_t i = 0; i < sizeFieldStatus; ++i) {
-			m_r->fieldStatus[i] = FStatus::kMissing;
-		}
-		new(&m_r->unknown)TValue(rapidjson::kObjectType);
-		new(&m_r->ownDoc) TDocument();
-		m_r->pAllocator = &m_r->ownDoc.GetAllocator();
+		InitResource(pMetaClass, isParentVal, isValid);
+		ResetFieldStatus();
 	}
 
 	//! Copy constructor
 	Accessor(const Accessor &rhs)
-			: m_r(NULL)
 	{
 		assert(this != &rhs);
-
-		// Allocate fieldStatus followed by m_r
-		const size_t sizeFieldStatus = rhs.m_r->pMetaClass->GetFieldsInfo().size();
-		m_r = static_cast<Resource *>(operator new(
-				sizeof(Resource) + sizeFieldStatus * sizeof(EFStatus)));
-		m_r->fieldStatus = reinterpret_cast<EFStatus*>(m_r + 1);
-
-		m_r->pMetaClass = rhs.m_r->pMetaClass;
-		InitOuterPtr();
-		m_r->isValid = rhs.m_r->isValid;
-		m_r->isParentVal = rhs.m_r->isParentVal;
+		InitResource(rhs.m_r.pMetaClass, rhs.m_r.isParentVal, rhs.m_r.isValid);
 
 		// Init fieldStatus from rhs
-		for (size_t i = 0; i < sizeFieldStatus; ++i) {
-			m_r->fieldStatus[i] = rhs.m_r->fieldStatus[i];
+		detail::BitWord* fieldStatus = FieldStatusWords();
+		const detail::BitWord* rhsFieldStatus = rhs.FieldStatusWords();
+		for (size_t i = 0, iSize = FieldStatusWordCount(); i < iSize; ++i) {
+			fieldStatus[i] = rhsFieldStatus[i];
 		}
-		new(&m_r->unknown)TValue(rapidjson::kObjectType);
-		new(&m_r->ownDoc) TDocument();
-		m_r->pAllocator = &m_r->ownDoc.GetAllocator();
 
-		m_r->unknown.CopyFrom(rhs.m_r->unknown, *(m_r->pAllocator));
+		if (!rhs.m_r.unknown.ObjectEmpty()) {
+			m_r.unknown.CopyFrom(rhs.m_r.unknown, GetAllocator());
+		}
 	}
 
 #if IJST_HAS_CXX11_RVALUE_REFS
 	//! Move copy constructor
 	//! @note Do not use source object after move
 	Accessor(Accessor &&rhs) IJSTI_NOEXCEPT
-		: m_r(NULL)
 	{
+		m_r.pOwnDoc = NULL;
+		m_r.pAllocator = NULL;
+		m_r.pHeapStatus = NULL;
 		Steal(rhs);
 	}
 #endif
@@ -320,8 +392,7 @@ public:
 	//! Destructor
 	~Accessor() IJSTI_NOEXCEPT
 	{
-		delete m_r;
-		m_r = NULL;
+		ReleaseResource();
 	}
 
 	//! Stealer
@@ -332,16 +403,26 @@ public:
 		}
 
 		// Handler resource
-		delete m_r;
-		m_r = rhs.m_r;
-		rhs.m_r = NULL;
+		ReleaseResource();
+		m_r.pMetaClass = rhs.m_r.pMetaClass;
+		m_r.isValid = rhs.m_r.isValid;
+		m_r.isParentVal = rhs.m_r.isParentVal;
+		m_r.unknown = rhs.m_r.unknown;	// move
+		m_r.pOwnDoc = rhs.m_r.pOwnDoc;
+		m_r.pAllocator = rhs.m_r.pAllocator;
+		m_r.pHeapStatus = rhs.m_r.pHeapStatus;
+		for (size_t i = 0; i < kInlineStatusWordCount; ++i) {
+			m_r.inlineStatus[i] = rhs.m_r.inlineStatus[i];
+		}
 
-		InitOuterPtr();
+		rhs.m_r.pOwnDoc = NULL;
+		rhs.m_r.pAllocator = NULL;
+		rhs.m_r.pHeapStatus = NULL;
 	}
 
-	bool IsValid() const { return m_r->isValid; }
-	bool IsParentVal() const { return m_r->isParentVal; }
-	const MetaClassInfo<Ch>& GetMetaInfo() const { return *(m_r->pMetaClass); }
+	bool IsValid() const { return m_r.isValid; }
+	bool IsParentVal() const { return m_r.isParentVal; }
+	const MetaClassInfo<Ch>& GetMetaInfo() const { return *(m_r.pMetaClass); }
 
 	/*
 	 * Field accessor.
@@ -351,7 +432,7 @@ public:
 	bool HasField(const void *pField) const
 	{
 		size_t offset = GetFieldOffset(pField);
-		return (m_r->pMetaClass->FindIndex(offset) != -1);
+		return (m_r.pMetaClass->FindIndex(offset) != -1);
 	}
 
 	//! Mark status of field to FStatus::kValid.
@@ -365,30 +446,61 @@ public:
 	EFStatus GetStatus(const void *pField) const
 	{
 		const size_t offset = GetFieldOffset(pField);
-		const int index = m_r->pMetaClass->FindIndex(offset);
-		return index == -1 ? FStatus::kNotAField : m_r->fieldStatus[index];
+		const int index = m_r.pMetaClass->FindIndex(offset);
+		return index == -1 ? FStatus::kNotAField : GetFieldStatus(static_cast<size_t>(index));
 	}
 
 	//! Get unknwon fields
-	rapidjson::GenericValue<Encoding> &GetUnknown() { return m_r->unknown; }
-	const rapidjson::GenericValue<Encoding> &GetUnknown() const { return m_r->unknown; }
+	rapidjson::GenericValue<Encoding> &GetUnknown() { return m_r.unknown; }
+	const rapidjson::GenericValue<Encoding> &GetUnknown() const { return m_r.unknown; }
 
 	/**
 	 * @brief Get allocator used in object.
 	 *
 	 * The inner allocator is own allocator when init,
 	 * but may change to other allocator when calling SetMembersAllocator() or Deserialize().
+	 * The allocator of ArenaScope is used instead of own allocator if the scope is alive when choosing allocator.
 	 */
-	rapidjson::MemoryPoolAllocator<> &GetAllocator() { return *(m_r->pAllocator); }
-	const rapidjson::MemoryPoolAllocator<> &GetAllocator() const { return *(m_r->pAllocator); }
+	rapidjson::MemoryPoolAllocator<> &GetAllocator()
+	{
+		if (m_r.pAllocator == NULL) {
+			detail::JsonAllocator* pArenaAllocator = ArenaScope::GetCurrentAllocator();
+			m_r.pAllocator = (pArenaAllocator != NULL) ? pArenaAllocator : &GetOwnAllocator();
+		}
+		return *(m_r.pAllocator);
+	}
+
+	/**
+	 * @brief Get allocator used in object.
+	 *
+	 * @note No allocator is chosen or created by const object.
+	 * 		A shared empty allocator is returned if the allocator has not been chosen yet
+	 */
+	const rapidjson::MemoryPoolAllocator<> &GetAllocator() const
+	{
+		return (m_r.pAllocator != NULL) ? *m_r.pAllocator : GetOwnAllocator();
+	}
 
 	/**
 	 * @brief Get own allocator that used to manager resource.
 	 *
 	 * User could use the returned value to check if this object use outer allocator.
+	 * The own allocator is created at the first time it is needed.
 	 */
-	rapidjson::MemoryPoolAllocator<> &GetOwnAllocator() { return m_r->ownDoc.GetAllocator(); }
-	const rapidjson::MemoryPoolAllocator<> &GetOwnAllocator() const { return m_r->ownDoc.GetAllocator(); }
+	rapidjson::MemoryPoolAllocator<> &GetOwnAllocator() { return GetOwnDoc().GetAllocator(); }
+
+	/**
+	 * @brief Get own allocator that used to manager resource.
+	 *
+	 * @note Own allocator is not created by const object.
+	 * 		A shared empty allocator is returned if the own allocator has not been created yet
+	 */
+	const rapidjson::MemoryPoolAllocator<> &GetOwnAllocator() const
+	{
+		return (m_r.pOwnDoc != NULL)
+			   ? m_r.pOwnDoc->GetAllocator()
+			   : detail::Singleton<rapidjson::MemoryPoolAllocator<> >();
+	}
 
 	/**
 	 * @brief Get Optional wrapper of field
@@ -401,7 +513,7 @@ public:
 	Optional<const T> GetOptional(const T& field) const
 	{
 		IJST_ASSERT(HasField(&field));
-		if (m_r->isValid && GetStatus(&field) == ijst::FStatus::kValid) {
+		if (m_r.isValid && GetStatus(&field) == ijst::FStatus::kValid) {
 			return ::ijst::Optional<const T>(&field);
 		}
 		else {
@@ -420,7 +532,7 @@ public:
 	Optional<T> GetOptional(T& field)
 	{
 		IJST_ASSERT(HasField(&field));
-		if (m_r->isValid && GetStatus(&field) == ijst::FStatus::kValid) {
+		if (m_r.isValid && GetStatus(&field) == ijst::FStatus::kValid) {
 			return ::ijst::Optional<T>(&field);
 		}
 		else {
@@ -437,7 +549,7 @@ public:
 	 */
 	int Serialize(HandlerBase<Ch>& writer, SerFlag::Flag serFlag = SerFlag::kNoneFlag)  const
 	{
-		return DoSerialize(writer, serFlag);
+		return DoSerialize(writer, detail::FieldSerializerByFunc<Encoding>(*m_r.pMetaClass), serFlag);
 	}
 
 	/**
@@ -450,19 +562,14 @@ public:
 	 * @return					Error code
 	 *
 	 * @note use Serialize(HandlerBase<Ch>, SerFlag::Flag) to serialize to string with specify char_traits and allocator
+	 * @note strOutput is not modified if error occurs
 	 */
 	template<typename TargetEncoding>
 	int Serialize(IJST_OUT std::basic_string<typename TargetEncoding::Ch> &strOutput, SerFlag::Flag serFlag = SerFlag::kNoneFlag) const
 	{
-		typedef rapidjson::GenericStringBuffer<TargetEncoding> TStringBuffer;
-		typedef rapidjson::Writer<TStringBuffer, Encoding, TargetEncoding> TWriter;
-
-		TStringBuffer buffer;
-		TWriter writer(buffer);
-		HandlerWrapper<TWriter> writerWrapper(writer);
-		IJSTI_RET_WHEN_NOT_ZERO(DoSerialize(writerWrapper, serFlag));
-
-		strOutput = std::basic_string<typename TargetEncoding::Ch>(buffer.GetString(), buffer.GetSize() / sizeof(typename TStringBuffer::Ch));
+		std::basic_string<typename TargetEncoding::Ch> output;
+		IJSTI_RET_WHEN_NOT_ZERO(this->template SerializeAppend<TargetEncoding>(output, serFlag));
+		strOutput.swap(output);
 		return 0;
 	}
 
@@ -472,12 +579,144 @@ public:
 	 * @param strOutput 	The output of result
 	 * @param serFlag 		Serialization options about fields, options can be combined by bitwise OR operator (|)
 	 * @return				Error code
+	 *
+	 * @note strOutput is not modified if error occurs
 	 */
 	int Serialize(IJST_OUT std::basic_string<Ch> &strOutput, SerFlag::Flag serFlag = SerFlag::kNoneFlag) const
 	{
 		return this->template Serialize<Encoding>(strOutput, serFlag);
 	}
 
+	/**
+	 * @brief Serialize the structure and append the result to string.
+	 *
+	 * The result is written to output directly without intermediate buffer.
+	 * Reserve the output by GetSerializedSize() to avoid reallocation.
+	 * If error occurs, output keeps the part which has been written.
+	 *
+	 * @tparam TargetEncoding	encoding of output
+	 *
+	 * @param output 			The output, result is appended to it
+	 * @param serFlag 			Serialization options about fields, options can be combined by bitwise OR operator (|)
+	 * @return					Error code
+	 */
+	template<typename TargetEncoding>
+	int SerializeAppend(IJST_OUT std::basic_string<typename TargetEncoding::Ch> &output, SerFlag::Flag serFlag = SerFlag::kNoneFlag) const
+	{
+		typedef detail::StringOutputStream<std::basic_string<typename TargetEncoding::Ch> > TStream;
+		typedef rapidjson::Writer<TStream, Encoding, TargetEncoding> TWriter;
+
+		TStream stream(output);
+		TWriter writer(stream);
+		HandlerWrapper<TWriter> writerWrapper(writer);
+		return Serialize(writerWrapper, serFlag);
+	}
+
+	/**
+	 * @brief Serialize the structure and append the result to string.
+	 *
+	 * @param output 		The output, result is appended to it
+	 * @param serFlag 		Serialization options about fields, options can be combined by bitwise OR operator (|)
+	 * @return				Error code
+	 */
+	int SerializeAppend(IJST_OUT std::basic_string<Ch> &output, SerFlag::Flag serFlag = SerFlag::kNoneFlag) const
+	{
+		return this->template SerializeAppend<Encoding>(output, serFlag);
+	}
+
+	/**
+	 * @brief Serialize the structure to buffer.
+	 *
+	 * @param buffer 		Output buffer. The result is not null-terminated
+	 * @param bufferSize 	Count of Ch in buffer
+	 * @param sizeOut 		Count of Ch of the whole result, which is larger than bufferSize if buffer is not enough
+	 * @param serFlag 		Serialization options about fields, options can be combined by bitwise OR operator (|)
+	 * @return				Error code, ErrorCode::kWriteFailed if buffer is not enough
+	 */
+	int Serialize(Ch* buffer, std::size_t bufferSize, IJST_OUT std::size_t& sizeOut, SerFlag::Flag serFlag = SerFlag::kNoneFlag) const
+	{
+		typedef detail::BufferOutputStream<Ch> TStream;
+		typedef rapidjson::Writer<TStream, Encoding, Encoding> TWriter;
+
+		TStream stream(buffer, bufferSize);
+		TWriter writer(stream);
+		HandlerWrapper<TWriter> writerWrapper(writer);
+		IJSTI_RET_WHEN_NOT_ZERO(Serialize(writerWrapper, serFlag));
+		sizeOut = stream.GetSize();
+		return stream.IsOverflow() ? ErrorCode::kWriteFailed : 0;
+	}
+
+	/**
+	 * @brief Serialize the structure to output stream.
+	 *
+	 * The output is written to stream while serializing, so memory usage does not grow with the size of output
+	 * if the stream writes to sink with a fixed-size buffer, such as FileOutputStream and FdOutputStream in "stream.h".
+	 *
+	 * @tparam TargetEncoding	encoding of output
+	 * @tparam OutputStream		rapidjson OutputStream concept
+	 *
+	 * @param os 				Output stream, which is flushed at the end
+	 * @param serFlag 			Serialization options about fields, options can be combined by bitwise OR operator (|)
+	 * @return					Error code, ErrorCode::kWriteFailed if FileOutputStream or FdOutputStream fails
+	 */
+	template<typename TargetEncoding, typename OutputStream>
+	int SerializeToStream(OutputStream& os, SerFlag::Flag serFlag = SerFlag::kNoneFlag) const
+	{
+		typedef rapidjson::Writer<OutputStream, Encoding, TargetEncoding> TWriter;
+
+		TWriter writer(os);
+		HandlerWrapper<TWriter> writerWrapper(writer);
+		IJSTI_RET_WHEN_NOT_ZERO(Serialize(writerWrapper, serFlag));
+		os.Flush();
+		return detail::StreamFailChecker<OutputStream>::IsFailed(os) ? ErrorCode::kWriteFailed : 0;
+	}
+
+	/**
+	 * @brief Serialize the structure to output stream.
+	 *
+	 * @tparam OutputStream		rapidjson OutputStream concept
+	 *
+	 * @param os 				Output stream, which is flushed at the end
+	 * @param serFlag 			Serialization options about fields, options can be combined by bitwise OR operator (|)
+	 * @return					Error code, ErrorCode::kWriteFailed if FileOutputStream or FdOutputStream fails
+	 */
+	template<typename OutputStream>
+	int SerializeToStream(OutputStream& os, SerFlag::Flag serFlag = SerFlag::kNoneFlag) const
+	{
+		return this->template SerializeToStream<Encoding>(os, serFlag);
+	}
+
+	/**
+	 * @brief Get the size of result of Serialize() by a dry run, which counts the output without writing it.
+	 *
+	 * @tparam TargetEncoding	encoding of output
+	 *
+	 * @param serFlag 			Serialization options about fields, options can be combined by bitwise OR operator (|)
+	 * @return					Count of TargetEncoding::Ch of the result, 0 if error occurs
+	 */
+	template<typename TargetEncoding>
+	std::size_t GetSerializedSize(SerFlag::Flag serFlag = SerFlag::kNoneFlag) const
+	{
+		typedef detail::BufferOutputStream<typename TargetEncoding::Ch> TStream;
+		typedef rapidjson::Writer<TStream, Encoding, TargetEncoding> TWriter;
+
+		TStream stream(NULL, 0);
+		TWriter writer(stream);
+		HandlerWrapper<TWriter> writerWrapper(writer);
+		return Serialize(writerWrapper, serFlag) == 0 ? stream.GetSize() : 0;
+	}
+
+	/**
+	 * @brief Get the size of result of Serialize() by a dry run, which counts the output without writing it.
+	 *
+	 * @param serFlag 		Serialization options about fields, options can be combined by bitwise OR operator (|)
+	 * @return				Count of Ch of the result, 0 if error occurs
+	 */
+	std::size_t GetSerializedSize(SerFlag::Flag serFlag = SerFlag::kNoneFlag) const
+	{
+		return this->template GetSerializedSize<Encoding>(serFlag);
+	}
+
 	/**
 	 * @brief Deserialize from C-style string with encoding
 	 *
@@ -501,8 +740,13 @@ public:
 	{
 		ResetAllocator();
 
-		if (detail::Util::IsBitSet(deserFlag, DeserFlag::kMoveFromIntermediateDoc)) {
-			TDocument doc(m_r->pAllocator);
+		if (detail::Util::IsBitSet(deserFlag, DeserFlag::kNoIntermediateDoc)) {
+			detail::LengthStringStream<SourceEncoding> is(cstrInput, length);
+			return DoFromSAXWrap<parseFlags, SourceEncoding>(is, deserFlag, pErrDocOut);
+		}
+		else if (detail::Util::IsBitSet(deserFlag, DeserFlag::kMoveFromIntermediateDoc)
+				 || ArenaScope::GetCurrentAllocator() != NULL) {
+			TDocument doc(&GetAllocator());
 			doc.template Parse<parseFlags, SourceEncoding>(cstrInput, length);
 			IJSTI_RET_WHEN_PARSE_ERROR(doc, Encoding);
 			return DoFromJsonWrap<TValue>(&Accessor::DoMoveFromJson, doc, deserFlag, pErrDocOut);
@@ -577,8 +821,13 @@ public:
 	{
 		ResetAllocator();
 
-		if (detail::Util::IsBitSet(deserFlag, DeserFlag::kMoveFromIntermediateDoc)) {
-			TDocument doc(m_r->pAllocator);
+		if (detail::Util::IsBitSet(deserFlag, DeserFlag::kNoIntermediateDoc)) {
+			rapidjson::GenericStringStream<SourceEncoding> is(cstrInput);
+			return DoFromSAXWrap<parseFlags, SourceEncoding>(is, deserFlag, pErrDocOut);
+		}
+		else if (detail::Util::IsBitSet(deserFlag, DeserFlag::kMoveFromIntermediateDoc)
+				 || ArenaScope::GetCurrentAllocator() != NULL) {
+			TDocument doc(&GetAllocator());
 			doc.template Parse<parseFlags, SourceEncoding>(cstrInput);
 			IJSTI_RET_WHEN_PARSE_ERROR(doc, Encoding);
 			return DoFromJsonWrap<TValue>(&Accessor::DoMoveFromJson, doc, deserFlag, pErrDocOut);
@@ -631,6 +880,64 @@ public:
 				cstrInput, deserFlag, pErrDocOut);
 	}
 
+	/**
+	 * @brief Deserialize from mutable buffer in situ.
+	 *
+	 * The buffer is parsed by rapidjson's ParseInsitu(), which decodes strings in place, and values are moved from
+	 * the intermediate document as DeserFlag::kMoveFromIntermediateDoc does.
+	 * So the keys and strings of unknown fields, T_raw fields and T_strview fields refer to the buffer without copying.
+	 *
+	 * @tparam parseFlags		parseFlags of rapidjson parse method
+	 *
+	 * @param buffer			Null-terminated input buffer, which will be modified
+	 * @param deserFlag	 		Deserialization options, options can be combined by bitwise OR operator (|)
+	 * @param pErrDocOut		Error message output. Null if do not need error message
+	 * @return					Error code
+	 *
+	 * @note It will free own allocator
+	 * @note The buffer must outlive this object (or until ShrinkAllocator() is called),
+	 * 		and must not be modified while the object is used.
+	 * 		When DeserFlag::kNoIntermediateDoc is specified, the strings are copied and the buffer could be freed after
+	 * 		deserialization.
+	 *
+	 * @see DeserFlag::kMoveFromIntermediateDoc
+	 */
+	template <unsigned parseFlags>
+	int DeserializeInsitu(Ch* buffer,
+						  DeserFlag::Flag deserFlag = DeserFlag::kNoneFlag,
+						  rapidjson::GenericDocument<Encoding> *pErrDocOut = NULL)
+	{
+		ResetAllocator();
+
+		if (detail::Util::IsBitSet(deserFlag, DeserFlag::kNoIntermediateDoc)) {
+			rapidjson::GenericInsituStringStream<Encoding> is(buffer);
+			return DoFromSAXWrap<parseFlags | rapidjson::kParseInsituFlag, Encoding>(is, deserFlag, pErrDocOut);
+		}
+		else {
+			TDocument doc(&GetAllocator());
+			doc.template ParseInsitu<parseFlags>(buffer);
+			IJSTI_RET_WHEN_PARSE_ERROR(doc, Encoding);
+			return DoFromJsonWrap<TValue>(&Accessor::DoMoveFromJson, doc, deserFlag, pErrDocOut);
+		}
+	}
+
+	/**
+	 * @brief Deserialize from mutable buffer in situ.
+	 *
+	 * @param buffer			Null-terminated input buffer, which will be modified
+	 * @param deserFlag	 		Deserialization options, options can be combined by bitwise OR operator (|)
+	 * @param pErrDocOut		Error message output. Null if do not need error message
+	 * @return					Error code
+	 *
+	 * @see DeserializeInsitu<parseFlags>()
+	 */
+	int DeserializeInsitu(Ch* buffer,
+						  DeserFlag::Flag deserFlag = DeserFlag::kNoneFlag,
+						  rapidjson::GenericDocument<Encoding> *pErrDocOut = NULL)
+	{
+		return this->template DeserializeInsitu<IJST_PARSE_DEFAULT_FLAGS>(buffer, deserFlag, pErrDocOut);
+	}
+
 	/**
 	 * @brief Deserialize from std::basic_string.
 	 *
@@ -673,6 +980,94 @@ public:
 		return ret;
 	}
 
+	/**
+	 * @brief Deserialize from input stream with encoding.
+	 *
+	 * Input is read from stream on demand, so the whole payload need not to be in memory.
+	 *
+	 * @tparam parseFlags		parseFlags of rapidjson parse method
+	 * @tparam SourceEncoding	encoding of source stream
+	 * @tparam InputStream		type of input stream, which models the stream concept of rapidjson,
+	 * 							e.g, FileInputStream, FdInputStream, IStreamInputStream in "stream.h"
+	 *
+	 * @param is				Input stream
+	 * @param deserFlag	 		Deserialization options, options can be combined by bitwise OR operator (|)
+	 * @param pErrDocOut		Error message output. Null if do not need error message
+	 * @return					Error code, ErrorCode::kReadFailed if FileInputStream, FdInputStream or
+	 * 							IStreamInputStream fails
+	 *
+	 * @note It will free own allocator
+	 * @note Peak memory is bounded by buffer of stream and deserialized object when DeserFlag::kNoIntermediateDoc
+	 * 		is specified
+	 */
+	template <unsigned parseFlags, typename SourceEncoding, typename InputStream>
+	int DeserializeStream(InputStream& is,
+						  DeserFlag::Flag deserFlag = DeserFlag::kNoneFlag,
+						  rapidjson::GenericDocument<Encoding> *pErrDocOut = NULL)
+	{
+		ResetAllocator();
+
+		if (detail::Util::IsBitSet(deserFlag, DeserFlag::kNoIntermediateDoc)) {
+			return DoFromSAXWrap<parseFlags, SourceEncoding>(is, deserFlag, pErrDocOut);
+		}
+		else if (detail::Util::IsBitSet(deserFlag, DeserFlag::kMoveFromIntermediateDoc)
+				 || ArenaScope::GetCurrentAllocator() != NULL) {
+			TDocument doc(&GetAllocator());
+			doc.template ParseStream<parseFlags, SourceEncoding>(is);
+			IJSTI_RET_WHEN_READ_FAILED(InputStream, is, Encoding);
+			IJSTI_RET_WHEN_PARSE_ERROR(doc, Encoding);
+			return DoFromJsonWrap<TValue>(&Accessor::DoMoveFromJson, doc, deserFlag, pErrDocOut);
+		}
+		else {
+			TDocument doc;
+			doc.template ParseStream<parseFlags, SourceEncoding>(is);
+			IJSTI_RET_WHEN_READ_FAILED(InputStream, is, Encoding);
+			IJSTI_RET_WHEN_PARSE_ERROR(doc, Encoding);
+			return DoFromJsonWrap<const TValue>(&Accessor::DoFromJson, doc, deserFlag, pErrDocOut);
+		}
+	}
+
+	/**
+	 * @brief Deserialize from input stream.
+	 *
+	 * @tparam parseFlags		parseFlags of rapidjson parse method
+	 * @tparam InputStream		type of input stream
+	 *
+	 * @param is				Input stream
+	 * @param deserFlag	 		Deserialization options, options can be combined by bitwise OR operator (|)
+	 * @param pErrDocOut		Error message output. Null if do not need error message
+	 * @return					Error code
+	 *
+	 * @see DeserializeStream<parseFlags, SourceEncoding, InputStream>()
+	 */
+	template <unsigned parseFlags, typename InputStream>
+	int DeserializeStream(InputStream& is,
+						  DeserFlag::Flag deserFlag = DeserFlag::kNoneFlag,
+						  rapidjson::GenericDocument<Encoding> *pErrDocOut = NULL)
+	{
+		return this->template DeserializeStream<parseFlags, Encoding>(is, deserFlag, pErrDocOut);
+	}
+
+	/**
+	 * @brief Deserialize from input stream.
+	 *
+	 * @tparam InputStream		type of input stream
+	 *
+	 * @param is				Input stream
+	 * @param deserFlag	 		Deserialization options, options can be combined by bitwise OR operator (|)
+	 * @param pErrDocOut		Error message output. Null if do not need error message
+	 * @return					Error code
+	 *
+	 * @see DeserializeStream<parseFlags, SourceEncoding, InputStream>()
+	 */
+	template <typename InputStream>
+	int DeserializeStream(InputStream& is,
+						  DeserFlag::Flag deserFlag = DeserFlag::kNoneFlag,
+						  rapidjson::GenericDocument<Encoding> *pErrDocOut = NULL)
+	{
+		return this->template DeserializeStream<IJST_PARSE_DEFAULT_FLAGS, Encoding>(is, deserFlag, pErrDocOut);
+	}
+
 	/**
 	 * @brief Deserialize from json object.
 	 *
@@ -719,10 +1114,25 @@ public:
 					 rapidjson::GenericDocument<Encoding> *pErrDocOut = NULL)
 	{
 		// Store document to manager allocator
-		m_r->ownDoc.GetAllocator().Clear();
-		m_r->ownDoc.Swap(srcDocStolen);
-		m_r->pAllocator = &m_r->ownDoc.GetAllocator();
-		return DoFromJsonWrap<TValue>(&Accessor::DoMoveFromJson, m_r->ownDoc, deserFlag, pErrDocOut);
+		TDocument& ownDoc = GetOwnDoc();
+		ownDoc.GetAllocator().Clear();
+		ownDoc.Swap(srcDocStolen);
+		m_r.pAllocator = &ownDoc.GetAllocator();
+		return DoFromJsonWrap<TValue>(&Accessor::DoMoveFromJson, ownDoc, deserFlag, pErrDocOut);
+	}
+
+	/**
+	 * @brief Get heap memory held by object, including nested objects.
+	 *
+	 * @return		Memory usage. The size of struct itself is not included
+	 *
+	 * @note O(n) complexity, n is count of values in object.
+	 */
+	MemoryUsage GetMemoryUsage() const
+	{
+		MemoryUsage usage;
+		IGetMemoryUsage(usage);
+		return usage;
 	}
 
 	/**
@@ -743,15 +1153,23 @@ private:
 
 	// #region Implement SerializeInterface
 	template <typename, typename, typename> friend class detail::FSerializer;
+	template <typename> friend class detail::MsgPackCodec;
 	typedef typename detail::SerializerInterface<Encoding>::SerializeReq SerializeReq;
 	int ISerialize(const SerializeReq &req) const
 	{
 		assert(req.pField == this);
-		return DoSerialize(req.writer, req.serFlag);
+		return Serialize(req.writer, req.serFlag);
+	}
+
+	template<typename T, typename Handler>
+	int IStaticSerialize(Handler& writer, SerFlag::Flag serFlag) const
+	{
+		return DoSerialize(writer, detail::FieldSerializerByStruct<T>(), serFlag);
 	}
 
 	typedef typename detail::SerializerInterface<Encoding>::FromJsonReq FromJsonReq;
 	typedef typename detail::SerializerInterface<Encoding>::FromJsonResp FromJsonResp;
+	typedef typename detail::GeneratedFieldFunc<Encoding>::FromJsonFunc FieldFromJsonFunc;
 	struct FromJsonParam{
 		DeserFlag::Flag deserFlag;
 		detail::ErrorDocSetter<Encoding>& errDoc;
@@ -765,9 +1183,13 @@ private:
 	{
 		assert(req.pFieldBuffer == this);
 
+		if (detail::Util::IsBitSet(req.deserFlag, DeserFlag::kReuseFields)) {
+			// Old values are kept, but fields missing in json should not be valid
+			ResetFieldStatus();
+		}
 		FromJsonParam param(req.deserFlag, resp.errDoc);
 		if (req.canMoveSrc) {
-			m_r->pAllocator = &req.allocator;
+			m_r.pAllocator = &req.allocator;
 			return DoMoveFromJson(req.stream, param);
 		}
 		else {
@@ -776,6 +1198,34 @@ private:
 		}
 	}
 
+	typedef typename detail::SerializerInterface<Encoding>::SAXEvent SAXEvent;
+	typedef typename detail::SerializerInterface<Encoding>::FromSAXReq FromSAXReq;
+	int IFromSAX(const FromSAXReq &req, IJST_OUT FromJsonResp& resp)
+	{
+		assert(req.state.pFieldBuffer == this);
+
+		if (req.state.isDom
+			|| (!req.state.isStarted && !m_r.isParentVal && req.event.type != SAXEvent::kStartObject))
+		{
+			// Type mismatch, build the value to get the same error message as DOM mode
+			return req.state.pIntf->DomFromSAX(req, resp);
+		}
+
+		if (!req.state.isStarted) {
+			ResetAllocator();
+			if (detail::Util::IsBitSet(req.deserFlag, DeserFlag::kReuseFields)) {
+				ResetFieldStatus();
+			}
+		}
+		FromJsonParam param(req.deserFlag, resp.errDoc);
+		if (m_r.isParentVal) {
+			return DoParentValFromSAX(req, param);
+		}
+		else {
+			return DoFromSAX(req, param);
+		}
+	}
+
 	void IShrinkAllocator(void* pField)
 	{
 		(void)pField;
@@ -783,27 +1233,51 @@ private:
 		DoShrinkAllocator();
 	}
 
+	void IGetMemoryUsage(IJST_OUT MemoryUsage& usage) const
+	{
+		if (m_r.pHeapStatus != NULL) {
+			usage.accessorBytes += FieldStatusWordCount() * sizeof(detail::BitWord);
+		}
+		if (m_r.pOwnDoc != NULL) {
+			usage.accessorBytes += sizeof(TDocument);
+			detail::AddAllocatorUsage(m_r.pOwnDoc->GetAllocator(), usage);
+		}
+		if (m_r.unknown.IsObject()) {
+			usage.unknownBytes += detail::ValueHeapBytes(m_r.unknown);
+		}
+
+		for (typename std::vector<TMetaFieldInfo>::const_iterator
+					 itFieldInfo = m_r.pMetaClass->GetFieldsInfo().begin(), itEnd = m_r.pMetaClass->GetFieldsInfo().end();
+			 itFieldInfo != itEnd; ++itFieldInfo)
+		{
+			const void *pField = GetFieldByOffset(itFieldInfo->offset);
+			detail::GetSerializerInterface<Encoding>(*itFieldInfo)->GetMemoryUsage(pField, usage);
+		}
+	}
+
 	// #endregion
 
 	//! Serialize to string using SAX API
-	int DoSerialize(HandlerBase<Ch> &writer, SerFlag::Flag serFlag) const
+	//! @tparam FieldSerializer		class with method Serialize(const TMetaFieldInfo&, const void* pField, Handler&, SerFlag::Flag)
+	template<typename Handler, typename FieldSerializer>
+	int DoSerialize(Handler &writer, const FieldSerializer& fieldSerializer, SerFlag::Flag serFlag) const
 	{
 		rapidjson::SizeType fieldCount = 0;
-		if (m_r->isParentVal) {
-			return DoSerializeFields(writer, serFlag, fieldCount);
+		if (m_r.isParentVal) {
+			return DoSerializeFields(writer, fieldSerializer, serFlag, fieldCount);
 			// Unknown will be ignored
 		}
 
 		IJSTI_RET_WHEN_WRITE_FAILD(writer.StartObject());
 
 		// Write fields
-		IJSTI_RET_WHEN_NOT_ZERO(DoSerializeFields(writer, serFlag, fieldCount));
+		IJSTI_RET_WHEN_NOT_ZERO(DoSerializeFields(writer, fieldSerializer, serFlag, fieldCount));
 
 		// Write buffer if need
 		if (!detail::Util::IsBitSet(serFlag, SerFlag::kIgnoreUnknown))
 		{
-			assert(m_r->unknown.IsObject());
-			for (typename TValue::ConstMemberIterator itMember = m_r->unknown.MemberBegin(), itEnd = m_r->unknown.MemberEnd();
+			assert(m_r.unknown.IsObject());
+			for (typename TValue::ConstMemberIterator itMember = m_r.unknown.MemberBegin(), itEnd = m_r.unknown.MemberEnd();
 				 itMember != itEnd; ++itMember)
 			{
 				// Write key
@@ -815,22 +1289,24 @@ private:
 						itMember->value.Accept(writer) );
 			}
 
-			fieldCount += m_r->unknown.MemberCount();
+			fieldCount += m_r.unknown.MemberCount();
 		}
 
 		IJSTI_RET_WHEN_WRITE_FAILD(writer.EndObject(fieldCount));
 		return 0;
 	}
 
-	int DoSerializeFields(HandlerBase<Ch> &writer, SerFlag::Flag serFlag, IJST_OUT rapidjson::SizeType& fieldCountOut) const
+	template<typename Handler, typename FieldSerializer>
+	int DoSerializeFields(Handler &writer, const FieldSerializer& fieldSerializer, SerFlag::Flag serFlag,
+						  IJST_OUT rapidjson::SizeType& fieldCountOut) const
 	{
-		IJST_ASSERT(!m_r->isParentVal || m_r->pMetaClass->GetFieldsInfo().size() == 1);
+		IJST_ASSERT(!m_r.isParentVal || m_r.pMetaClass->GetFieldsInfo().size() == 1);
 		for (typename std::vector<TMetaFieldInfo>::const_iterator
-					 itMetaField = m_r->pMetaClass->GetFieldsInfo().begin(), itEnd = m_r->pMetaClass->GetFieldsInfo().end();
+					 itMetaField = m_r.pMetaClass->GetFieldsInfo().begin(), itEnd = m_r.pMetaClass->GetFieldsInfo().end();
 			 itMetaField != itEnd; ++itMetaField)
 		{
 			// Check field state
-			const EFStatus fstatus = m_r->fieldStatus[itMetaField->index];
+			const EFStatus fstatus = GetFieldStatus(static_cast<size_t>(itMetaField->index));
 			switch (fstatus) {
 				case FStatus::kMissing:
 					if (detail::Util::IsBitSet(serFlag, SerFlag::kIgnoreMissing)) {
@@ -840,15 +1316,14 @@ private:
 				case FStatus::kValid:
 				{
 					const void *pFieldValue = GetFieldByOffset(itMetaField->offset);
-					if (!m_r->isParentVal) {
+					if (!m_r.isParentVal) {
 						// write key
 						IJSTI_RET_WHEN_WRITE_FAILD(
 								writer.Key(itMetaField->jsonName.data(), (rapidjson::SizeType)itMetaField->jsonName.size()) );
 					}
 					// write value
-					SerializeReq req(writer, pFieldValue, serFlag);
 					IJSTI_RET_WHEN_NOT_ZERO(
-							detail::GetSerializerInterface<Encoding>(*itMetaField)->Serialize(req));
+							fieldSerializer.Serialize(*itMetaField, pFieldValue, writer, serFlag));
 					++fieldCountOut;
 				}
 					break;
@@ -859,7 +1334,7 @@ private:
 						continue;
 					}
 
-					if (!m_r->isParentVal) {
+					if (!m_r.isParentVal) {
 						// write key
 						IJSTI_RET_WHEN_WRITE_FAILD(
 								writer.Key(itMetaField->jsonName.data(), (rapidjson::SizeType)itMetaField->jsonName.size()) );
@@ -894,11 +1369,11 @@ private:
 	 */
 	int DoMoveFromJson(TValue &stream, FromJsonParam& p)
 	{
-		if (m_r->isParentVal) {
+		if (m_r.isParentVal) {
 			// Set field by stream itself
-			assert(m_r->pMetaClass->GetFieldsInfo().size() == 1);
+			assert(m_r.pMetaClass->GetFieldsInfo().size() == 1);
 			return DoFieldFromJson(
-					&m_r->pMetaClass->GetFieldsInfo()[0], stream, /*canMoveSrc=*/true, p);
+					GetFieldFromJsonFunc(), &m_r.pMetaClass->GetFieldsInfo()[0], stream, /*canMoveSrc=*/true, p);
 		}
 
 		// Set fields by members of stream
@@ -908,14 +1383,16 @@ private:
 		}
 
 		// For each member
-		m_r->unknown.SetObject();
+		m_r.unknown.SetObject();
+		const TMetaFieldInfo *pPrevField = NULL;
+		const FieldFromJsonFunc pfnFieldFromJson = GetFieldFromJsonFunc();
 		for (typename TValue::MemberIterator itMember = stream.MemberBegin(), itEnd = stream.MemberEnd();
 			 itMember != itEnd; ++itMember)
 		{
 
 			// Get related field info
-			const TMetaFieldInfo *pMetaField =
-					m_r->pMetaClass->FindFieldByJsonName(itMember->name.GetString(), itMember->name.GetStringLength());
+			const TMetaFieldInfo *pMetaField = m_r.pMetaClass->FindNextFieldByJsonName(
+					pPrevField, itMember->name.GetString(), itMember->name.GetStringLength());
 
 			if (pMetaField == NULL) {
 				// Not a field in struct
@@ -925,17 +1402,18 @@ private:
 				}
 				if (!detail::Util::IsBitSet(p.deserFlag, DeserFlag::kIgnoreUnknown)) {
 					// Move member from stream to unknown
-					m_r->unknown.AddMember(itMember->name, itMember->value, *m_r->pAllocator);
+					m_r.unknown.AddMember(itMember->name, itMember->value, GetAllocator());
 				}
 				continue;
 			}
 
+			pPrevField = pMetaField;
 			// Move member out of object
 			TValue memberStream(rapidjson::kNullType);
 			memberStream.Swap(itMember->value);
 
 			IJSTI_RET_WHEN_NOT_ZERO(
-					DoFieldFromJson(pMetaField, memberStream, /*canMoveSrc=*/true, p) );
+					DoFieldFromJson(pfnFieldFromJson, pMetaField, memberStream, /*canMoveSrc=*/true, p) );
 		}
 
 		if (!detail::Util::IsBitSet(p.deserFlag, DeserFlag::kNotCheckFieldStatus)) {
@@ -949,11 +1427,12 @@ private:
 	//! Deserialize from stream
 	int DoFromJson(const TValue &stream, FromJsonParam& p)
 	{
-		if (m_r->isParentVal) {
-			// Serialize field by stream itself
-			assert(m_r->pMetaClass->GetFieldsInfo().size() == 1);
+		if (m_r.isParentVal) {
+			// Serialize field by stream itself, the stream is not owned by this object and could not be moved
+			assert(m_r.pMetaClass->GetFieldsInfo().size() == 1);
 			return DoFieldFromJson(
-					&m_r->pMetaClass->GetFieldsInfo()[0], const_cast<TValue &>(stream), /*canMoveSrc=*/true, p);
+					GetFieldFromJsonFunc(), &m_r.pMetaClass->GetFieldsInfo()[0], const_cast<TValue &>(stream),
+					/*canMoveSrc=*/false, p);
 		}
 
 		// Serialize fields by members of stream
@@ -962,14 +1441,16 @@ private:
 			return ErrorCode::kDeserializeValueTypeError;
 		}
 
-		m_r->unknown.SetObject();
+		m_r.unknown.SetObject();
+		const TMetaFieldInfo *pPrevField = NULL;
+		const FieldFromJsonFunc pfnFieldFromJson = GetFieldFromJsonFunc();
 		// For each member
 		for (typename TValue::ConstMemberIterator itMember = stream.MemberBegin(), itEnd = stream.MemberEnd();
 			 itMember != itEnd; ++itMember)
 		{
 			// Get related field info
-			const TMetaFieldInfo *pMetaField =
-					m_r->pMetaClass->FindFieldByJsonName(itMember->name.GetString(), itMember->name.GetStringLength());
+			const TMetaFieldInfo *pMetaField = m_r.pMetaClass->FindNextFieldByJsonName(
+					pPrevField, itMember->name.GetString(), itMember->name.GetStringLength());
 
 			if (pMetaField == NULL) {
 				// Not a field in struct
@@ -978,18 +1459,19 @@ private:
 					return ErrorCode::kDeserializeSomeUnknownMember;
 				}
 				if (!detail::Util::IsBitSet(p.deserFlag, DeserFlag::kIgnoreUnknown)) {
-					m_r->unknown.AddMember(
-							TValue().SetString(itMember->name.GetString(), itMember->name.GetStringLength(), *(m_r->pAllocator)),
-							TValue().CopyFrom(itMember->value, *(m_r->pAllocator)),
-							*(m_r->pAllocator)
+					m_r.unknown.AddMember(
+							TValue().SetString(itMember->name.GetString(), itMember->name.GetStringLength(), GetAllocator()),
+							TValue().CopyFrom(itMember->value, GetAllocator()),
+							GetAllocator()
 					);
 				}
 				continue;
 			}
 
+			pPrevField = pMetaField;
 			TValue& memberStream = const_cast<TValue&>(itMember->value);
 			IJSTI_RET_WHEN_NOT_ZERO(
-					DoFieldFromJson(pMetaField, memberStream, /*canMoveSrc=*/false, p) );
+					DoFieldFromJson(pfnFieldFromJson, pMetaField, memberStream, /*canMoveSrc=*/false, p) );
 		}
 
 		if (!detail::Util::IsBitSet(p.deserFlag, DeserFlag::kNotCheckFieldStatus)) {
@@ -1001,26 +1483,173 @@ private:
 	}
 
 
-	int DoFieldFromJson(const TMetaFieldInfo* metaField, TValue &stream, bool canMoveSrc, FromJsonParam& p)
+	//! Function generated in struct definition which deserializes field by static type.
+	//! It is the same for all fields of this struct, so callers fetch it once before iterating members
+	FieldFromJsonFunc GetFieldFromJsonFunc() const
+	{
+		return detail::GeneratedFieldFunc<Encoding>::GetFromJsonFunc(*m_r.pMetaClass);
+	}
+
+	int DoFieldFromJson(FieldFromJsonFunc pfnFieldFromJson, const TMetaFieldInfo* metaField, TValue &stream,
+						bool canMoveSrc, FromJsonParam& p)
 	{
 		// Check nullable
 		if (stream.IsNull() && detail::Util::IsBitSet(metaField->desc, FDesc::Nullable)) {
-			m_r->fieldStatus[metaField->index] = FStatus::kNull;
+			SetFieldStatus(static_cast<size_t>(metaField->index), FStatus::kNull);
 		}
 		else {
 			void *pField = GetFieldByOffset(metaField->offset);
-			FromJsonReq elemReq(stream, *(m_r->pAllocator), p.deserFlag, canMoveSrc, pField, metaField->desc);
+			FromJsonReq elemReq(stream, GetAllocator(), p.deserFlag, canMoveSrc, pField, metaField->desc);
 			FromJsonResp elemResp(p.errDoc);
-			int ret = detail::GetSerializerInterface<Encoding>(*metaField)->FromJson(elemReq, elemResp);
+			int ret = pfnFieldFromJson(*metaField, elemReq, elemResp);
 			// Check return
 			if (ret != 0) {
-				m_r->fieldStatus[metaField->index] = FStatus::kMissing;
+				SetFieldStatus(static_cast<size_t>(metaField->index), FStatus::kMissing);
 				p.errDoc.ErrorInObject(metaField->fieldName, metaField->jsonName);
 				return ret;
 			}
 			// succ
-			m_r->fieldStatus[metaField->index] = FStatus::kValid;
+			SetFieldStatus(static_cast<size_t>(metaField->index), FStatus::kValid);
+		}
+		return 0;
+	}
+
+	template <unsigned parseFlags, typename SourceEncoding, typename InputStream>
+	int DoFromSAXWrap(InputStream& is, DeserFlag::Flag deserFlag, TDocument* pErrDocOut)
+	{
+		detail::ErrorDocSetter<Encoding> errDoc(pErrDocOut);
+		detail::FromSAXHandler<Encoding> handler(deserFlag, errDoc);
+		handler.PushValue(&IJSTI_FSERIALIZER_INS(Accessor, Encoding), this, FDesc::NoneFlag, GetAllocator());
+
+		rapidjson::GenericReader<SourceEncoding, Encoding> reader;
+		const rapidjson::ParseResult parseRet = reader.template Parse<parseFlags>(is, handler);
+		// Input is truncated when reading fails, so the error of stream precedes others
+		if (detail::StreamFailChecker<InputStream>::IsFailed(is)) {
+			errDoc.ReadFailed();
+			return ErrorCode::kReadFailed;
+		}
+		// Error in handler will stop parsing
+		IJSTI_RET_WHEN_NOT_ZERO(handler.GetRet());
+		if (parseRet.IsError()) {
+			errDoc.ParseFailed(parseRet.Code());
+			return ErrorCode::kDeserializeParseFailed;
+		}
+		return 0;
+	}
+
+	//! Deserialize from SAX event of object. State's pCursor is the meta info of field being deserialized
+	int DoFromSAX(const FromSAXReq &req, FromJsonParam& p)
+	{
+		const SAXEvent& event = req.event;
+		if (!req.state.isStarted) {
+			assert(event.type == SAXEvent::kStartObject);
+			req.state.isStarted = true;
+			m_r.unknown.SetObject();
+			return 0;
+		}
+
+		switch (event.type) {
+			case SAXEvent::kKey:
+			{
+				// Get related field info
+				const TMetaFieldInfo *pMetaField = m_r.pMetaClass->FindNextFieldByJsonName(
+						static_cast<const TMetaFieldInfo*>(req.state.pHint), event.str, event.length);
+				req.state.pCursor = const_cast<TMetaFieldInfo*>(pMetaField);
+				if (pMetaField == NULL) {
+					// Not a field in struct
+					if (detail::Util::IsBitSet(p.deserFlag, DeserFlag::kErrorWhenUnknown)) {
+						p.errDoc.UnknownMember(std::basic_string<Ch>(event.str, event.length));
+						return ErrorCode::kDeserializeSomeUnknownMember;
+					}
+					if (!detail::Util::IsBitSet(p.deserFlag, DeserFlag::kIgnoreUnknown)) {
+						m_r.unknown.AddMember(
+								TValue().SetString(event.str, event.length, GetAllocator()),
+								TValue().Move(),
+								GetAllocator()
+						);
+					}
+				}
+				else {
+					req.state.pHint = pMetaField;
+				}
+				return 0;
+			}
+
+			case SAXEvent::kEndValue:
+				if (req.state.pCursor == NULL) {
+					// Unknown member
+					return event.ret;
+				}
+				return DoFieldFromSAXEnd(static_cast<const TMetaFieldInfo*>(req.state.pCursor), event.ret, p);
+
+			case SAXEvent::kEndObject:
+				req.state.isEnd = true;
+				if (!detail::Util::IsBitSet(p.deserFlag, DeserFlag::kNotCheckFieldStatus)) {
+					return CheckFieldState(p.errDoc);
+				}
+				else {
+					return 0;
+				}
+
+			default:
+			{
+				const TMetaFieldInfo *pMetaField = static_cast<const TMetaFieldInfo*>(req.state.pCursor);
+				if (pMetaField == NULL) {
+					// Build unknown member, or skip it
+					TValue* pMemberVal = detail::Util::IsBitSet(p.deserFlag, DeserFlag::kIgnoreUnknown)
+										 ? NULL
+										 : &(m_r.unknown.MemberEnd() - 1)->value;
+					req.handler.PushDom(pMemberVal, GetAllocator());
+					return 0;
+				}
+				if (!DoFieldFromSAX(pMetaField, req)) {
+					req.state.pCursor = NULL;
+				}
+				return 0;
+			}
 		}
+	}
+
+	int DoParentValFromSAX(const FromSAXReq &req, FromJsonParam& p)
+	{
+		// Set field by stream itself
+		assert(m_r.pMetaClass->GetFieldsInfo().size() == 1);
+		const TMetaFieldInfo *pMetaField = &m_r.pMetaClass->GetFieldsInfo()[0];
+		if (!req.state.isStarted) {
+			req.state.isStarted = true;
+			req.state.isEnd = !DoFieldFromSAX(pMetaField, req);
+			return 0;
+		}
+
+		assert(req.event.type == SAXEvent::kEndValue);
+		req.state.isEnd = true;
+		return DoFieldFromSAXEnd(pMetaField, req.event.ret, p);
+	}
+
+	//! Route value of field to its serializer. Return false if the value is complete
+	bool DoFieldFromSAX(const TMetaFieldInfo* metaField, const FromSAXReq &req)
+	{
+		// Check nullable
+		if (req.event.type == SAXEvent::kNull && detail::Util::IsBitSet(metaField->desc, FDesc::Nullable)) {
+			SetFieldStatus(static_cast<size_t>(metaField->index), FStatus::kNull);
+			return false;
+		}
+
+		void *pField = GetFieldByOffset(metaField->offset);
+		req.handler.PushValue(detail::GetSerializerInterface<Encoding>(*metaField), pField, metaField->desc, GetAllocator());
+		return true;
+	}
+
+	int DoFieldFromSAXEnd(const TMetaFieldInfo* metaField, int ret, FromJsonParam& p)
+	{
+		// Check return
+		if (ret != 0) {
+			SetFieldStatus(static_cast<size_t>(metaField->index), FStatus::kMissing);
+			p.errDoc.ErrorInObject(metaField->fieldName, metaField->jsonName);
+			return ret;
+		}
+		// succ
+		SetFieldStatus(static_cast<size_t>(metaField->index), FStatus::kValid);
 		return 0;
 	}
 
@@ -1028,7 +1657,7 @@ private:
 	{
 		// Shrink allocator of each field
 		for (typename std::vector<TMetaFieldInfo>::const_iterator
-					 itFieldInfo = m_r->pMetaClass->GetFieldsInfo().begin(), itEnd = m_r->pMetaClass->GetFieldsInfo().end();
+					 itFieldInfo = m_r.pMetaClass->GetFieldsInfo().begin(), itEnd = m_r.pMetaClass->GetFieldsInfo().end();
 			 itFieldInfo != itEnd; ++itFieldInfo)
 		{
 			void *pField = GetFieldByOffset(itFieldInfo->offset);
@@ -1037,99 +1666,237 @@ private:
 
 		// Shrink self allocator
 		// Some context in own allocator may be free after shrinking children's allocator, so shrink allocator always
+		if (m_r.unknown.ObjectEmpty()) {
+			// Nothing need to keep, release own allocator until it is needed again
+			m_r.unknown.SetObject();
+			detail::DeleteResource(m_r.pOwnDoc);
+			m_r.pOwnDoc = NULL;
+			m_r.pAllocator = NULL;
+			return;
+		}
 		rapidjson::GenericDocument<Encoding> newDoc;
-		newDoc.CopyFrom(m_r->unknown, newDoc.GetAllocator());
-		m_r->ownDoc.Swap(newDoc);
-		m_r->unknown = static_cast<rapidjson::GenericValue<Encoding>&>(m_r->ownDoc); // move
-		m_r->pAllocator = &m_r->ownDoc.GetAllocator();
+		newDoc.CopyFrom(m_r.unknown, newDoc.GetAllocator());
+		TDocument& ownDoc = GetOwnDoc();
+		ownDoc.Swap(newDoc);
+		m_r.unknown = static_cast<rapidjson::GenericValue<Encoding>&>(ownDoc); // move
+		m_r.pAllocator = &ownDoc.GetAllocator();
 	}
 
 	void ResetAllocator()
 	{
-		m_r->ownDoc.GetAllocator().Clear();
-		m_r->pAllocator = &m_r->ownDoc.GetAllocator();
+		if (m_r.pOwnDoc != NULL) {
+			m_r.pOwnDoc->GetAllocator().Clear();
+		}
+		// Use own allocator, which is created lazily
+		m_r.pAllocator = NULL;
 	}
 
-	void InitOuterPtr()
+	TDocument& GetOwnDoc()
 	{
-		m_r->pOuter = reinterpret_cast<const unsigned char *>(this - m_r->pMetaClass->GetAccessorOffset());
+		if (m_r.pOwnDoc == NULL) {
+			m_r.pOwnDoc = detail::NewResource<TDocument>();
+		}
+		return *m_r.pOwnDoc;
+	}
+
+	void InitResource(const TMetaClassInfo* pMetaClass, bool isParentVal, bool isValid)
+	{
+		m_r.pMetaClass = pMetaClass;
+		m_r.isValid = isValid;
+		m_r.isParentVal = isParentVal;
+		m_r.unknown.SetObject();
+		m_r.pOwnDoc = NULL;
+		m_r.pAllocator = NULL;
+		const size_t wordCount = FieldStatusWordCount();
+		m_r.pHeapStatus = (wordCount <= kInlineStatusWordCount)
+				? NULL
+				: static_cast<detail::BitWord*>(IJST_RESOURCE_ALLOC(wordCount * sizeof(detail::BitWord)));
 	}
 
+	void ReleaseResource()
+	{
+		detail::DeleteResource(m_r.pOwnDoc);
+		m_r.pOwnDoc = NULL;
+		m_r.pAllocator = NULL;
+		if (m_r.pHeapStatus != NULL) {
+			IJST_RESOURCE_FREE(m_r.pHeapStatus, FieldStatusWordCount() * sizeof(detail::BitWord));
+			m_r.pHeapStatus = NULL;
+		}
+	}
+
+	size_t FieldStatusWordCount() const { return m_r.pMetaClass->m_requiredMask.size() * 2; }
+
+	//! Set status of all fields to kMissing
+	void ResetFieldStatus()
+	{
+		detail::BitWord* fieldStatus = FieldStatusWords();
+		for (size_t i = 0, iSize = FieldStatusWordCount(); i < iSize; ++i) {
+			fieldStatus[i] = 0;
+		}
+	}
+	detail::BitWord* FieldStatusWords() { return m_r.pHeapStatus == NULL ? m_r.inlineStatus : m_r.pHeapStatus; }
+	const detail::BitWord* FieldStatusWords() const { return m_r.pHeapStatus == NULL ? m_r.inlineStatus : m_r.pHeapStatus; }
+
 	void MarkFieldStatus(const void* field, EFStatus fStatus)
 	{
 		const std::size_t offset = GetFieldOffset(field);
-		const int index = m_r->pMetaClass->FindIndex(offset);
-		IJST_ASSERT(index >= 0 && (unsigned int)index < m_r->pMetaClass->GetFieldsInfo().size());
-		m_r->fieldStatus[index] = fStatus;
+		const int index = m_r.pMetaClass->FindIndex(offset);
+		IJST_ASSERT(index >= 0 && (unsigned int)index < m_r.pMetaClass->GetFieldsInfo().size());
+		SetFieldStatus(static_cast<size_t>(index), fStatus);
+	}
+
+	// Status of field i is kept in two bitsets, whose words are interleaved: with w = i / kBitWordSize,
+	// bit i of fieldStatus[2 * w] is set if the field is valid or null, and bit i of fieldStatus[2 * w + 1] is set if it is null
+	EFStatus GetFieldStatus(size_t index) const
+	{
+		const detail::BitWord* words = FieldStatusWords() + (index / detail::kBitWordSize) * 2;
+		const detail::BitWord mask = detail::Util::BitWordMask(index);
+		if ((words[0] & mask) == 0) {
+			return FStatus::kMissing;
+		}
+		return (words[1] & mask) == 0 ? FStatus::kValid : FStatus::kNull;
+	}
+
+	void SetFieldStatus(size_t index, EFStatus fStatus)
+	{
+		detail::BitWord* words = FieldStatusWords() + (index / detail::kBitWordSize) * 2;
+		const detail::BitWord mask = detail::Util::BitWordMask(index);
+		switch (fStatus) {
+			case FStatus::kValid:
+				words[0] |= mask;
+				words[1] &= ~mask;
+				break;
+			case FStatus::kNull:
+				words[0] |= mask;
+				words[1] |= mask;
+				break;
+			case FStatus::kMissing:
+				words[0] &= ~mask;
+				words[1] &= ~mask;
+				break;
+			case FStatus::kNotAField:
+			default:
+				assert(false);
+		}
 	}
 
 	int CheckFieldState(detail::ErrorDocSetter<Encoding>& errDoc) const
 	{
-		// Check all required field status
+		// Check all required field status are valid or null, word by word
+		const std::vector<detail::BitWord>& requiredMask = m_r.pMetaClass->m_requiredMask;
+		const detail::BitWord* fieldStatus = FieldStatusWords();
 		bool hasErr = false;
+		for (size_t w = 0, wSize = requiredMask.size(); w < wSize && !hasErr; ++w) {
+			hasErr = (requiredMask[w] & ~fieldStatus[w * 2]) != 0;
+		}
+		if (!hasErr) {
+			return 0;
+		}
 
+		// Walk fields to report the missing ones
 		for (typename std::vector<TMetaFieldInfo>::const_iterator
-					 itFieldInfo = m_r->pMetaClass->GetFieldsInfo().begin(), itEnd = m_r->pMetaClass->GetFieldsInfo().end();
+					 itFieldInfo = m_r.pMetaClass->GetFieldsInfo().begin(), itEnd = m_r.pMetaClass->GetFieldsInfo().end();
 			 itFieldInfo != itEnd; ++itFieldInfo)
 		{
-			if (detail::Util::IsBitSet(itFieldInfo->desc, FDesc::Optional))
+			if (!detail::Util::IsBitSet(itFieldInfo->desc, FDesc::Optional)
+				&& GetFieldStatus(static_cast<size_t>(itFieldInfo->index)) == FStatus::kMissing)
 			{
-				// Optional
-				continue;
+				errDoc.ElementAddMemberName(itFieldInfo->jsonName);
 			}
-
-			const EFStatus fStatus = m_r->fieldStatus[itFieldInfo->index];
-			if (fStatus == FStatus::kValid
-				|| fStatus == FStatus::kNull)
-			{
-				// Correct
-				continue;
-			}
-
-			// Has error
-			hasErr = true;
-			errDoc.ElementAddMemberName(itFieldInfo->jsonName);
-		}
-		if (hasErr)
-		{
-			errDoc.MissingMember();
-			return ErrorCode::kDeserializeSomeFieldsInvalid;
 		}
-		return 0;
+		errDoc.MissingMember();
+		return ErrorCode::kDeserializeSomeFieldsInvalid;
+	}
+
+	const unsigned char* GetOuterPtr() const
+	{
+		return reinterpret_cast<const unsigned char *>(this) - m_r.pMetaClass->GetAccessorOffset();
 	}
 
 	std::size_t GetFieldOffset(const void *ptr) const
 	{
 		const unsigned char *filed_ptr = reinterpret_cast<const unsigned char *>(ptr);
-		return filed_ptr - m_r->pOuter;
+		return filed_ptr - GetOuterPtr();
 	}
 
 	void *GetFieldByOffset(std::size_t offset) const
 	{
-		return (void *) (m_r->pOuter + offset);
+		return (void *) (GetOuterPtr() + offset);
 	}
 
 
-	// It need at least one new operation in Accessor, e.g, fieldStatus
-	// So allocate all resource in heap to reduce the size of Accessor.
+	// Status of fields is stored in inlineStatus if the words are enough, so small struct need no allocation in heap
+	static const size_t kInlineStatusWordCount = 2;
+
+	// Resource are kept in Accessor, the own document is created lazily,
+	// so constructing a struct and deserializing it with outer allocator do not allocate in heap
 	struct Resource {
 		TValue unknown;
-		// Should use document instead of Allocator because document can swap allocator
-		TDocument ownDoc;
-
-		EFStatus* fieldStatus;
-		const TMetaClassInfo* pMetaClass;
+		// Should use document instead of Allocator because document can swap allocator.
+		// NULL until own allocator is needed
+		TDocument* pOwnDoc;
+		// Allocator in use, NULL means own allocator
 		detail::JsonAllocator* pAllocator;
-		const unsigned char *pOuter;
+		const TMetaClassInfo* pMetaClass;
+
+		// Packed status of fields, see GetFieldStatus(). Stored in pHeapStatus if it is not NULL, else inlineStatus
+		detail::BitWord inlineStatus[kInlineStatusWordCount];
+		detail::BitWord* pHeapStatus;
 
 		bool isValid;
 		bool isParentVal;
 	};
-	Resource* m_r;
+	Resource m_r;
 
 	//</editor-fold>
 };	// class Accessor
 
+namespace detail {
+
+/**
+ * Serialization of Accessor. Use as the root of deserialization in SAX mode
+ * @tparam Encoding		encoding of json struct
+ */
+template<typename Encoding>
+class FSerializer<Accessor<Encoding>, Encoding> : public SerializerInterface<Encoding>
+{
+public:
+	typedef Accessor<Encoding> VarType;
+	IJSTI_PROPAGATE_SINTERFACE_TYPE(Encoding);
+
+	virtual int Serialize(const SerializeReq &req) IJSTI_OVERRIDE
+	{
+		return static_cast<const VarType *>(req.pField)->ISerialize(req);
+	}
+
+	virtual int FromJson(const FromJsonReq &req, IJST_OUT FromJsonResp &resp) IJSTI_OVERRIDE
+	{
+		return static_cast<VarType *>(req.pFieldBuffer)->IFromJson(req, resp);
+	}
+
+	virtual int FromSAX(const FromSAXReq &req, IJST_OUT FromJsonResp &resp) IJSTI_OVERRIDE
+	{
+		return static_cast<VarType *>(req.state.pFieldBuffer)->IFromSAX(req, resp);
+	}
+
+	virtual void ShrinkAllocator(void *pField) IJSTI_OVERRIDE
+	{
+		static_cast<VarType *>(pField)->IShrinkAllocator(pField);
+	}
+
+	virtual void GetMemoryUsage(const void* pField, IJST_OUT MemoryUsage& usage) IJSTI_OVERRIDE
+	{
+		static_cast<const VarType *>(pField)->IGetMemoryUsage(usage);
+	}
+
+	virtual VarType* GetAccessor(void* pField) IJSTI_OVERRIDE
+	{
+		return static_cast<VarType *>(pField);
+	}
+};
+
+}	// namespace detail
+
 /**
  * @brief Provide `bool f(Handler)` functor used by rapidjson::Document.Populate()
  *
@@ -1187,6 +1954,77 @@ private:
 	Handler* m_h;
 };
 
+/**
+ * @brief Generate SAX events of ijst struct to handler with static dispatch.
+ *
+ * Different from Accessor::Serialize(HandlerBase<Ch>&, SerFlag::Flag), the type of handler and fields are
+ * known at compile time, so the events are sent to handler without virtual calls and could be inlined.
+ *
+ * @tparam T 			ijst struct
+ * @tparam Handler		rapidjson::Handler
+ *
+ * @param st 			ijst struct instance
+ * @param writer 		writer
+ * @param serFlag		Serialization options about fields, options can be combined by bitwise OR operator (|)
+ * @return				Error code
+ *
+ * @note The fields declared with serialize_intf in IDL are still serialized through SerializerInterface.
+ */
+template<typename T, typename Handler>
+inline int Serialize(const T& st, Handler& writer, SerFlag::Flag serFlag = SerFlag::kNoneFlag)
+{
+	return detail::FSerializer<T, typename T::_ijst_Encoding>::Serialize(st, writer, serFlag);
+}
+
+/**
+ * @brief Serialize ijst struct to string with static dispatch.
+ *
+ * @tparam T 			ijst struct
+ * @tparam CharType		character type of string, must be same as T::_ijst_Ch
+ *
+ * @param st 			ijst struct instance
+ * @param strOutput 	The output of result
+ * @param serFlag		Serialization options about fields, options can be combined by bitwise OR operator (|)
+ * @return				Error code
+ *
+ * @note strOutput is not modified if error occurs
+ * @see Serialize(const T&, Handler&, SerFlag::Flag)
+ */
+template<typename T, typename CharType>
+inline int Serialize(const T& st, IJST_OUT std::basic_string<CharType>& strOutput, SerFlag::Flag serFlag = SerFlag::kNoneFlag)
+{
+	IJSTI_STATIC_ASSERT((std::is_same<CharType, typename T::_ijst_Ch>::value),
+						"Character type of output must be same as ijst struct's");
+	typedef typename T::_ijst_Encoding Encoding;
+	typedef detail::StringOutputStream<std::basic_string<CharType> > TStream;
+	typedef rapidjson::Writer<TStream, Encoding, Encoding> TWriter;
+
+	std::basic_string<CharType> output;
+	TStream stream(output);
+	TWriter writer(stream);
+	IJSTI_RET_WHEN_NOT_ZERO(Serialize(st, writer, serFlag));
+	strOutput.swap(output);
+	return 0;
+}
+
+/**
+ * @brief Initialize singletons of meta information and serializers used by ijst struct T, and by its fields
+ * recursively.
+ *
+ * These singletons are initialized lazily at first use. Call it before (de)serializing T in many threads,
+ * so that the threads do not contend on the initialization.
+ *
+ * @tparam T 	ijst struct
+ */
+template<typename T>
+inline void InitSingletons()
+{
+	typedef typename T::_ijst_Encoding Encoding;
+	std::vector<const void*> visited;
+	IJSTI_FSERIALIZER_INS(T, Encoding).InitSingletons(visited);
+	(void)IJSTI_FSERIALIZER_INS(Accessor<Encoding>, Encoding);
+}
+
 } // namespace ijst
 
 #define IJSTI_STRUCT_META_INITER_DECLARE(stName)	\
@@ -1273,7 +2111,10 @@ private:
 		const stName* stPtr = reinterpret_cast<const stName*>(dummyBuffer);					\
 		::ijst::detail::MetaClassInfoSetter<_ijst_Encoding>					 				\
 					mSetter(metaInfo->metaClass);											\
-		mSetter.InitBegin(#stName, N, IJSTI_OFFSETOF(stPtr, _));
+		mSetter.InitBegin(#stName, N, IJSTI_OFFSETOF(stPtr, _));						\
+		mSetter.SetGeneratedFieldFunc(														\
+				&stName::_ijst_SerializeField< ::ijst::HandlerBase<_ijst_Ch> >,				\
+				&stName::_ijst_FieldFromJson<true>);
 
 // Add meta info of field
 // e.g., IJSTI_METAINFO_ADD(MyStruct, (ijst::T_int, i, "i"))
@@ -1332,6 +2173,85 @@ private:
 		IJST_OFFSET_BUFFER_DELETE(dummyBuffer);												\
 	}
 
+// Get FieldSerializerByType of field
+// e.g., IJSTI_FIELD_SERIALIZER_BY_TYPE((ijst::T_int, i, "i"))
+#ifdef _MSC_VER
+	#define IJSTI_FIELD_SERIALIZER_BY_TYPE(fDef)  											\
+			IJSTI_EXPAND(IJSTI_PP_CONCAT(IJSTI_FIELD_SERIALIZER_BY_TYPE_IMPL_, IJSTI_PP_NARGS fDef)(fDef))
+#else
+	#define IJSTI_FIELD_SERIALIZER_BY_TYPE(fDef)  											\
+			IJSTI_PP_CONCAT(IJSTI_FIELD_SERIALIZER_BY_TYPE_IMPL_, IJSTI_PP_NARGS fDef)(fDef)
+#endif
+
+// Impl with fDef format (type, field_name)
+#define IJSTI_FIELD_SERIALIZER_BY_TYPE_IMPL_2(fDef)											\
+		::ijst::detail::FieldSerializerByType<false>
+
+// Impl with fDef format (type, field_name, p3), p3 may be serialize_intf
+#define IJSTI_FIELD_SERIALIZER_BY_TYPE_IMPL_3(fDef)											\
+		::ijst::detail::FieldSerializerByType<												\
+			(sizeof(::ijst::detail::MayBeIntfIdlP3(IJSTI_IDL_P3 fDef)) == 2)				\
+		>
+
+// Impl with fDef format (type, field_name, p3, p4), p4 may be serialize_intf
+#define IJSTI_FIELD_SERIALIZER_BY_TYPE_IMPL_4(fDef)											\
+		::ijst::detail::FieldSerializerByType<												\
+			(sizeof(::ijst::detail::MayBeIntfIdlP4(IJSTI_IDL_P4 fDef)) == 2)				\
+		>
+
+// Impl with fDef format (type, field_name, p3, p4, p5)
+// The serialize_intf is always declared by user in this case
+#define IJSTI_FIELD_SERIALIZER_BY_TYPE_IMPL_5(fDef)											\
+		::ijst::detail::FieldSerializerByType<true>
+
+// Define _ijst_SerializeField<Handler>(), which generates SAX events of field by static type.
+// The field is selected by index in declaration
+#define IJSTI_FIELD_SERIALIZE_DEFINE_START(stName)											\
+	friend struct ::ijst::detail::FieldSerializerByStruct< stName >;						\
+	template<typename Handler>																\
+	static int _ijst_SerializeField(const ::ijst::MetaFieldInfo<_ijst_Ch>& metaField,		\
+			const void* pField, Handler& writer, ::ijst::SerFlag::Flag serFlag)				\
+	{																						\
+		switch (metaField.declIndex) {
+
+// Serialize field in switch case
+// e.g., IJSTI_FIELD_SERIALIZE(0, (ijst::T_int, i, "i"))
+#define IJSTI_FIELD_SERIALIZE(i, fDef)  													\
+			case i: return IJSTI_FIELD_SERIALIZER_BY_TYPE(fDef)								\
+					::Serialize<IJSTI_IDL_FTYPE fDef, _ijst_Encoding>(metaField, pField, writer, serFlag);
+
+#define IJSTI_FIELD_SERIALIZE_DEFINE_END()													\
+			default:																		\
+				(void)pField; (void)writer; (void)serFlag;									\
+				assert(false);																\
+				return ::ijst::ErrorCode::kInnerError;										\
+		}																					\
+	}
+
+// Define _ijst_FieldFromJson<true>(), which deserializes field by static type.
+// The field is selected by index in declaration
+#define IJSTI_FIELD_FROM_JSON_DEFINE_START()												\
+	template<bool DummyTrue>																\
+	static int _ijst_FieldFromJson(const ::ijst::MetaFieldInfo<_ijst_Ch>& metaField,		\
+			const ::ijst::detail::SerializerInterface<_ijst_Encoding>::FromJsonReq& req,	\
+			::ijst::detail::SerializerInterface<_ijst_Encoding>::FromJsonResp& resp)		\
+	{																						\
+		switch (metaField.declIndex) {
+
+// Deserialize field in switch case
+// e.g., IJSTI_FIELD_FROM_JSON(0, (ijst::T_int, i, "i"))
+#define IJSTI_FIELD_FROM_JSON(i, fDef)  													\
+			case i: return IJSTI_FIELD_SERIALIZER_BY_TYPE(fDef)								\
+					::FromJson<IJSTI_IDL_FTYPE fDef, _ijst_Encoding>(metaField, req, resp);
+
+#define IJSTI_FIELD_FROM_JSON_DEFINE_END()													\
+			default:																		\
+				(void)req; (void)resp;														\
+				assert(false);																\
+				return ::ijst::ErrorCode::kInnerError;										\
+		}																					\
+	}
+
 #define IJSTI_DEFINE_CLASS_END(stName)														\
 	};																						\
 	IJSTI_STRUCT_EXTERN_TEMPLATE(stName)													\
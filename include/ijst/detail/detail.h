@@ -13,7 +13,9 @@
 #include <rapidjson/writer.h>
 #include <rapidjson/error/en.h>
 
+#include <algorithm>
 #include <string>
+#include <vector>
 
 //! return Err::kWriteFailed if action return false
 #define IJSTI_RET_WHEN_WRITE_FAILD(action) 						\
@@ -30,6 +32,15 @@
 			return ErrorCode::kDeserializeParseFailed;						\
 		}																	\
 	} while (false)
+//! return ErrorCode::kReadFailed and set error doc when input stream fails
+#define IJSTI_RET_WHEN_READ_FAILED(StreamType, is, encoding)					\
+	do {																		\
+		if (detail::StreamFailChecker<StreamType>::IsFailed(is)) {				\
+			detail::ErrorDocSetter<encoding> errDocSetter(pErrDocOut);			\
+			errDocSetter.ReadFailed();											\
+			return ErrorCode::kReadFailed;										\
+		}																		\
+	} while (false)
 //! return error and set error doc when type mismatch
 #define IJSTI_RET_WHEN_TYPE_MISMATCH(checkCode, expType)			\
 	if (!(checkCode)) {												\
@@ -48,6 +59,7 @@ namespace ijst{
 
 // forward declaration
 template<typename Ch> class HandlerBase;
+template<typename Handler> class HandlerWrapper;
 
 namespace detail{
 
@@ -91,6 +103,34 @@ private:
 	bool m_headOnly;
 };
 
+/**
+ * Read-only string stream with length. Implement rapidjson::Stream concept
+ *
+ * @tparam Encoding		encoding of string
+ */
+template<typename Encoding>
+class LengthStringStream {
+public:
+	typedef typename Encoding::Ch Ch;
+
+	LengthStringStream(const Ch* src, size_t length)
+			: m_src(src), m_head(src), m_end(src + length) {}
+
+	Ch Peek() const { return m_src == m_end ? Ch() : *m_src; }
+	Ch Take() { return m_src == m_end ? Ch() : *m_src++; }
+	size_t Tell() const { return static_cast<size_t>(m_src - m_head); }
+
+	Ch* PutBegin() { assert(false); return NULL; }
+	void Put(Ch) { assert(false); }
+	void Flush() { assert(false); }
+	size_t PutEnd(Ch*) { assert(false); return 0; }
+
+private:
+	const Ch* m_src;
+	const Ch* const m_head;
+	const Ch* const m_end;
+};
+
 /**
  * Head Writer that only write heading string. Implement rapidjson::Handler concept
  * It will return false when OutputStream.IsDone() return true
@@ -155,6 +195,56 @@ inline std::basic_string<typename Encoding::Ch> GetJsonStr(const rapidjson::Gene
 	return std::basic_string<typename Encoding::Ch>(jVal.GetString(), jVal.GetStringLength());
 }
 
+//! Heap bytes of string storage, 0 if the characters are stored in the string object (short string optimization)
+template<typename CharType, typename Traits, typename Alloc>
+inline size_t StringHeapBytes(const std::basic_string<CharType, Traits, Alloc>& str)
+{
+	const size_t data = reinterpret_cast<size_t>(str.data());
+	const size_t obj = reinterpret_cast<size_t>(&str);
+	if (data >= obj && data < obj + sizeof(str)) {
+		return 0;
+	}
+	return (str.capacity() + 1) * sizeof(CharType);
+}
+
+//! Estimated heap bytes of json value. Strings are always counted, although they may be short or const strings
+template<typename Encoding>
+inline size_t ValueHeapBytes(const rapidjson::GenericValue<Encoding>& jVal)
+{
+	typedef rapidjson::GenericValue<Encoding> TValue;
+	size_t bytes = 0;
+	switch (jVal.GetType()) {
+		case rapidjson::kObjectType:
+			bytes += jVal.MemberCount() * sizeof(typename TValue::Member);
+			for (typename TValue::ConstMemberIterator itMember = jVal.MemberBegin(), itEnd = jVal.MemberEnd();
+				 itMember != itEnd; ++itMember)
+			{
+				bytes += ValueHeapBytes(itMember->name);
+				bytes += ValueHeapBytes(itMember->value);
+			}
+			break;
+		case rapidjson::kArrayType:
+			bytes += jVal.Capacity() * sizeof(TValue);
+			for (typename TValue::ConstValueIterator itVal = jVal.Begin(), itEnd = jVal.End(); itVal != itEnd; ++itVal) {
+				bytes += ValueHeapBytes(*itVal);
+			}
+			break;
+		case rapidjson::kStringType:
+			bytes += (jVal.GetStringLength() + 1) * sizeof(typename Encoding::Ch);
+			break;
+		default:
+			break;
+	}
+	return bytes;
+}
+
+//! Add capacity and used bytes of allocator to usage. The allocator object itself is counted in capacity
+inline void AddAllocatorUsage(const JsonAllocator& allocator, IJST_OUT MemoryUsage& usage)
+{
+	usage.allocatorCapacity += allocator.Capacity() + sizeof(JsonAllocator);
+	usage.allocatorUsed += allocator.Size();
+}
+
 template<typename Encoding>
 struct ErrorDocSetter {
 	typedef rapidjson::GenericDocument<Encoding> TDocument;
@@ -215,6 +305,43 @@ struct ErrorDocSetter {
 		}
 	}
 
+	//! Set error message when the schema fingerprint of binary data is not the one of struct
+	void SchemaMismatch(const std::string& className)
+	{
+		if (pAllocator == NULL) { return; }
+		pErrMsg->SetObject();
+		pErrMsg->AddMember(
+				EncodeString<Encoding>("type", *pAllocator),
+				EncodeString<Encoding>("SchemaMismatch", *pAllocator),
+				*pAllocator);
+		pErrMsg->AddMember(
+				EncodeString<Encoding>("struct", *pAllocator),
+				EncodeString<Encoding>(className.c_str(), *pAllocator),
+				*pAllocator);
+	}
+
+	//! Set error message when input stream could not be read
+	void ReadFailed()
+	{
+		if (pAllocator == NULL) { return; }
+		pErrMsg->SetObject();
+		pErrMsg->AddMember(
+				EncodeString<Encoding>("type", *pAllocator),
+				EncodeString<Encoding>("ReadFailed", *pAllocator),
+				*pAllocator);
+	}
+
+	//! Set error message when input file could not be read
+	void ReadFailed(const char* path)
+	{
+		if (pAllocator == NULL) { return; }
+		ReadFailed();
+		pErrMsg->AddMember(
+				EncodeString<Encoding>("path", *pAllocator),
+				EncodeString<Encoding>(path, *pAllocator),
+				*pAllocator);
+	}
+
 	//! Set error message about error of member in object
 	void ErrorInMap(const std::basic_string<Ch>& jsonKey)
 	{
@@ -267,6 +394,32 @@ struct ErrorDocSetter {
 		}
 	}
 
+	//! Set error message about error of line in newline-delimited JSON. Line number starts from 1
+	void ErrorInLine(std::size_t line)
+	{
+		if (pAllocator == NULL) { return; }
+
+		// backup errMsg
+		TValue errDetail;
+		errDetail = *pErrMsg;	// move
+
+		pErrMsg->SetObject();
+		pErrMsg->AddMember(
+				EncodeString<Encoding>("type", *pAllocator),
+				EncodeString<Encoding>("ErrInLine", *pAllocator),
+				*pAllocator);
+		pErrMsg->AddMember(
+				EncodeString<Encoding>("line", *pAllocator),
+				TValue().SetUint64(static_cast<uint64_t>(line)),
+				*pAllocator);
+		if (!errDetail.IsNull()) {
+			pErrMsg->AddMember(
+					EncodeString<Encoding>("err", *pAllocator),
+					errDetail,
+					*pAllocator);
+		}
+	}
+
 	void MissingMember()
 	{
 		if (pAllocator == NULL) { return; }
@@ -376,6 +529,60 @@ struct ErrorDocSetter {
 	TValue* const pErrMsg;
 };
 
+//! Offset basis of 64-bit FNV-1a hash, which is used by schema fingerprint
+const uint64_t kFingerprintBasis = 0xcbf29ce484222325ULL;
+
+//! Add 8 bytes of val to 64-bit FNV-1a hash
+inline uint64_t FingerprintAdd(uint64_t hash, uint64_t val)
+{
+	const uint64_t kPrime = 0x100000001b3ULL;
+	for (int i = 0; i < 8; ++i) {
+		hash ^= (val >> (8 * i)) & 0xff;
+		hash *= kPrime;
+	}
+	return hash;
+}
+
+//! Add string to 64-bit FNV-1a hash. The string is prefixed by length to avoid ambiguity
+template<typename CharT>
+inline uint64_t FingerprintAdd(uint64_t hash, const CharT* str, size_t length)
+{
+	hash = FingerprintAdd(hash, static_cast<uint64_t>(length));
+	for (size_t i = 0; i < length; ++i) {
+		hash = FingerprintAdd(hash, static_cast<uint64_t>(str[i]));
+	}
+	return hash;
+}
+
+/**
+ * Tags of field types, which are mixed into the schema fingerprint of struct.
+ * Types with the same encoding share a tag, e.g., vector, deque and list. Tag of ijst struct is its fingerprint.
+ * The values are part of the fingerprint, do not change them.
+ */
+struct TypeTag {
+	enum Tag {
+		kUnknown		= 0,
+		kBool			= 1,
+		kInt			= 2,
+		kUint			= 3,
+		kInt64			= 4,
+		kUint64			= 5,
+		kDouble			= 6,
+		kString			= 7,
+		kRaw			= 8,
+		kArray			= 9,
+		kObject			= 10
+	};
+
+	//! Tag of container, which depends on the tag of elements
+	static uint64_t Container(Tag tag, uint64_t elemTag)
+	{
+		return FingerprintAdd(FingerprintAdd(kFingerprintBasis, static_cast<uint64_t>(tag)), elemTag);
+	}
+};
+
+// forward declaration
+template<typename Encoding> class FromSAXHandler;
 
 template<typename Encoding>
 class SerializerInterface {
@@ -444,18 +651,281 @@ public:
 
 	virtual void ShrinkAllocator(void * pField)
 	{ (void)pField; }
+
+	//! Add heap memory held by field to usage. Default implementation is for types without heap memory
+	virtual void GetMemoryUsage(const void* pField, IJST_OUT MemoryUsage& usage)
+	{ (void)pField; (void)usage; }
+
+	//! Accessor of field if it is an ijst struct, NULL else. Used by the schema-indexed binary encoding
+	virtual Accessor<Encoding>* GetAccessor(void* pField)
+	{ (void)pField; return NULL; }
+
+	/**
+	 * Initialize singletons used by this serializer, e.g., serializers of elements and meta info of ijst struct,
+	 * which are initialized lazily at first use by default.
+	 * @param visited		serializers of ijst struct whose singletons have been initialized, to stop recursion
+	 */
+	virtual void InitSingletons(IJST_OUT std::vector<const void*>& visited)
+	{ (void)visited; }
+
+	//! Tag of the type in schema fingerprint, see TypeTag. Default implementation is for serializers defined by user
+	virtual uint64_t GetTypeTag()
+	{ return TypeTag::kUnknown; }
+
+	//! Event of SAX parser
+	struct SAXEvent {
+		enum Type {
+			kNull, kBool, kInt, kUint, kInt64, kUint64, kDouble, kString,
+			kStartObject, kKey, kEndObject, kStartArray, kEndArray,
+			// Not a parser's event. Notify that the child value pushed by FromSAXHandler::PushValue() is end
+			kEndValue
+		};
+
+		explicit SAXEvent(Type _type) : type(_type), str(NULL), length(0) { u64 = 0; }
+
+		Type type;
+		union {
+			bool b;
+			int i;
+			unsigned u;
+			int64_t i64;
+			uint64_t u64;
+			double d;
+			// Return code of child value when type is kEndValue
+			int ret;
+		};
+		// String of kString or kKey event, only valid in the calling of FromSAX()
+		const Ch* str;
+		rapidjson::SizeType length;
+
+		bool IsScalar() const { return type <= kString; }
+
+		//! Set value of scalar event. Return false if event is not a scalar
+		bool ToValue(IJST_OUT rapidjson::GenericValue<Encoding>& val, JsonAllocator& allocator) const
+		{
+			switch (type) {
+				case kNull: 	val.SetNull(); 		return true;
+				case kBool: 	val.SetBool(b); 	return true;
+				case kInt: 		val.SetInt(i); 		return true;
+				case kUint: 	val.SetUint(u); 	return true;
+				case kInt64: 	val.SetInt64(i64); 	return true;
+				case kUint64: 	val.SetUint64(u64); return true;
+				case kDouble: 	val.SetDouble(d); 	return true;
+				case kString: 	val.SetString(str, length, allocator); 	return true;
+				default: 		return false;
+			}
+		}
+	};
+
+	//! State of a deserializing value in SAX mode
+	struct SAXState {
+		// The serializer of value. NULL if value is built to a DOM value
+		SerializerInterface* pIntf;
+		// Pointer of deserialize output
+		void* pFieldBuffer;
+		// Allocator of the outer ijst struct
+		JsonAllocator* pAllocator;
+		FDesc::Mode fDesc;
+
+		// Below members are maintained by the serializer
+		// true after the first event is handled
+		bool isStarted;
+		// Set to true by serializer when the value is complete
+		bool isEnd;
+		// true if value is built to an intermediate DOM value, see DomFromSAX()
+		bool isDom;
+		// Serializer specified data, such as the element being deserialized
+		void* pCursor;
+		// Serializer specified data kept between elements, such as the last deserialized field
+		const void* pHint;
+		// Serializer specified count, such as the count of elements in container
+		size_t count;
+	};
+
+	struct FromSAXReq {
+		const SAXEvent& event;
+		SAXState& state;
+		// Use to route following events of a child value to other serializer
+		FromSAXHandler<Encoding>& handler;
+
+		JsonAllocator& allocator;
+		DeserFlag::Flag deserFlag;
+		FDesc::Mode fDesc;
+
+		FromSAXReq(const SAXEvent& _event, SAXState& _state, FromSAXHandler<Encoding>& _handler, DeserFlag::Flag _deserFlag)
+				: event(_event)
+				  , state(_state)
+				  , handler(_handler)
+				  , allocator(*_state.pAllocator)
+				  , deserFlag(_deserFlag)
+				  , fDesc(_state.fDesc)
+		{ }
+	};
+
+	/**
+	 * Deserialize from an event of SAX parser.
+	 * Every event of the value, and a kEndValue event after the child value pushed by
+	 * req.handler.PushValue() or req.handler.PushDom() is complete, will be routed here.
+	 * Set req.state.isEnd to true when the value is complete.
+	 *
+	 * The default implementation builds the value to an intermediate DOM, and then calls FromJson().
+	 */
+	virtual int FromSAX(const FromSAXReq& req, IJST_OUT FromJsonResp& resp)
+	{
+		return DomFromSAX(req, resp);
+	}
+
+	//! Deserialize by building the value to an intermediate DOM, and then call FromJson()
+	int DomFromSAX(const FromSAXReq& req, IJST_OUT FromJsonResp& resp)
+	{
+		typedef rapidjson::GenericValue<Encoding> TValue;
+		SAXState& state = req.state;
+		if (!state.isDom) {
+			state.isDom = true;
+			state.isStarted = true;
+			if (req.event.IsScalar()) {
+				// Scalar value need not to be built
+				TValue val;
+				req.event.ToValue(val, req.handler.GetScratchAllocator());
+				state.isEnd = true;
+				FromJsonReq elemReq(val, req.allocator, req.deserFlag, /*canMoveSrc=*/false, state.pFieldBuffer, req.fDesc);
+				return FromJson(elemReq, resp);
+			}
+
+			TValue* pVal = req.handler.NewScratchValue();
+			state.pCursor = pVal;
+			req.handler.PushDom(pVal, req.handler.GetScratchAllocator());
+			return 0;
+		}
+
+		assert(req.event.type == SAXEvent::kEndValue);
+		state.isEnd = true;
+		FromJsonReq elemReq(*static_cast<TValue*>(state.pCursor), req.allocator, req.deserFlag, /*canMoveSrc=*/false, state.pFieldBuffer, req.fDesc);
+		return FromJson(elemReq, resp);
+	}
 };
 
 //! Propagate structs' define in SerializeInterface<Encoding>
 #define IJSTI_PROPAGATE_SINTERFACE_TYPE(Encoding)										\
 	typedef typename SerializerInterface<Encoding>::SerializeReq SerializeReq;			\
 	typedef typename SerializerInterface<Encoding>::FromJsonReq FromJsonReq;			\
-	typedef typename SerializerInterface<Encoding>::FromJsonResp FromJsonResp;
+	typedef typename SerializerInterface<Encoding>::FromJsonResp FromJsonResp;			\
+	typedef typename SerializerInterface<Encoding>::SAXEvent SAXEvent;					\
+	typedef typename SerializerInterface<Encoding>::FromSAXReq FromSAXReq;
+
+//! Implement SerializerInterface::Serialize() by the static entry point
+//! template<typename Handler> static int Serialize(const VarType&, Handler&, SerFlag::Flag)
+#define IJSTI_DEFINE_SERIALIZE_BY_STATIC()												\
+	virtual int Serialize(const SerializeReq &req) IJSTI_OVERRIDE						\
+	{ return Serialize(*static_cast<const VarType *>(req.pField), req.writer, req.serFlag); }
+
+/**
+ * Type check, conversion and output of arithmetic types, which is shared by the serializer of number fields
+ * and the serializer of number arrays.
+ * This template is only specialized for number types, others have no member ValType.
+ *
+ * @tparam T	number type
+ */
+template<typename T>
+struct NumberTraits {
+};
+
+#define IJSTI_DEFINE_NUMBER_TRAITS(T, IsMethod, Method, typeName, typeTag)					\
+	template<>																				\
+	struct NumberTraits<T> {																\
+		typedef T ValType;																	\
+		static const char* TypeName() { return typeName; }									\
+		static uint64_t Tag() { return TypeTag::typeTag; }									\
+		template<typename Encoding>															\
+		static bool Is(const rapidjson::GenericValue<Encoding>& val) { return val.IsMethod(); }	\
+		template<typename Encoding>															\
+		static T Get(const rapidjson::GenericValue<Encoding>& val) { return val.Get##Method(); }	\
+		template<typename Handler>															\
+		static bool Write(Handler& writer, T val) { return writer.Method(val); }			\
+		/** Write array with one call to HandlerBase */										\
+		template<typename Handler>															\
+		static bool WriteArray(Handler& writer, const T* vals, rapidjson::SizeType count)	\
+		{ return writer.Method##Array(vals, count); }										\
+	};
+
+IJSTI_DEFINE_NUMBER_TRAITS(int, IsInt, Int, "int", kInt)
+IJSTI_DEFINE_NUMBER_TRAITS(unsigned int, IsUint, Uint, "uint", kUint)
+IJSTI_DEFINE_NUMBER_TRAITS(int64_t, IsInt64, Int64, "int64", kInt64)
+IJSTI_DEFINE_NUMBER_TRAITS(uint64_t, IsUint64, Uint64, "uint64", kUint64)
+IJSTI_DEFINE_NUMBER_TRAITS(double, IsNumber, Double, "number", kDouble)
+
+/**
+ * Output stream of rapidjson::Writer which appends to string directly
+ * @tparam String	std::basic_string
+ */
+template<typename String>
+class StringOutputStream {
+public:
+	typedef typename String::value_type Ch;
+	explicit StringOutputStream(String& output) : m_output(output) {}
+
+	void Put(Ch c) { m_output.push_back(c); }
+	void Flush() {}
+
+private:
+	String& m_output;
+};
+
+/**
+ * Output stream of rapidjson::Writer which writes to a buffer with fixed size.
+ * The size of the whole output is counted even if the buffer is full, so it could be used as a counter
+ * when the buffer is NULL and the capacity is 0.
+ * @tparam CharType		character type
+ */
+template<typename CharType>
+class BufferOutputStream {
+public:
+	typedef CharType Ch;
+	BufferOutputStream(Ch* buffer, std::size_t capacity) : m_buffer(buffer), m_capacity(capacity), m_size(0) {}
+
+	void Put(Ch c)
+	{
+		if (m_size < m_capacity) {
+			m_buffer[m_size] = c;
+		}
+		++m_size;
+	}
+	void Flush() {}
+
+	//! Size of the whole output
+	std::size_t GetSize() const { return m_size; }
+	//! Whether the output is larger than the buffer
+	bool IsOverflow() const { return m_size > m_capacity; }
+
+private:
+	Ch* const m_buffer;
+	const std::size_t m_capacity;
+	std::size_t m_size;
+};
+
+//! Write the array of numbers to handler in a tight loop
+template<typename Handler, typename T>
+inline bool WriteNumberArray(Handler& writer, const T* vals, rapidjson::SizeType count)
+{
+	if (!writer.StartArray()) {
+		return false;
+	}
+	for (rapidjson::SizeType i = 0; i < count; ++i) {
+		if (!NumberTraits<T>::Write(writer, vals[i])) {
+			return false;
+		}
+	}
+	return writer.EndArray(count);
+}
 
 /**
  * Template interface of serialization class
  * This template is unimplemented, and will throw a compile error when use it.
  *
+ * Besides the virtual methods of SerializerInterface, specializations provide a static entry point:
+ * template<typename Handler> static int Serialize(const VarType& field, Handler& writer, SerFlag::Flag serFlag),
+ * which generates SAX events to a handler whose type is known at compile time.
+ *
  * @tparam T 		class
  * @tparam Encoding	encoding of json struct
  * @tparam Enable	type for SFINAE
@@ -476,6 +946,243 @@ public:
 #define IJSTI_FSERIALIZER_INS(T, Encoding) 		\
 		::ijst::detail::Singleton< ::ijst::detail::FSerializer< T, Encoding > >()
 
+/**
+ * Handler of rapidjson::GenericReader which routes events to serializers directly
+ * without intermediate document.
+ *
+ * Every deserializing value owns a SAXState in stack, events are routed to the serializer of top state.
+ * Serializer of object or array calls PushValue() to route the following events of a child value to
+ * child serializer, and will receive a kEndValue event after the child value is complete.
+ * Values that needed to be kept as DOM (such as unknown fields) are built by PushDom().
+ *
+ * @tparam Encoding 	encoding of json struct
+ */
+template<typename Encoding>
+class FromSAXHandler {
+public:
+	typedef typename Encoding::Ch Ch;
+	typedef rapidjson::GenericValue<Encoding> TValue;
+	typedef SerializerInterface<Encoding> TInterface;
+	typedef typename TInterface::SAXEvent SAXEvent;
+	typedef typename TInterface::SAXState SAXState;
+	typedef typename TInterface::FromSAXReq FromSAXReq;
+	typedef typename TInterface::FromJsonResp FromJsonResp;
+
+	FromSAXHandler(DeserFlag::Flag deserFlag, ErrorDocSetter<Encoding>& errDoc)
+			: m_deserFlag(deserFlag)
+			  , m_errDoc(errDoc)
+			  , m_ret(0)
+			  , m_hasPending(false)
+	{
+		m_stack.reserve(16);
+	}
+
+	//! Route current event and the following events of the value to pIntf
+	void PushValue(TInterface* pIntf, void* pFieldBuffer, FDesc::Mode fDesc, JsonAllocator& allocator)
+	{
+		assert(pIntf != NULL);
+		SetPending(pIntf, pFieldBuffer, fDesc, allocator);
+	}
+
+	//! Build current value to *pDest with allocator. Value will be skipped if pDest is NULL
+	void PushDom(TValue* pDest, JsonAllocator& allocator)
+	{
+		SetPending(NULL, pDest, FDesc::NoneFlag, allocator);
+	}
+
+	//! Allocator of intermediate values, which is released after deserialization
+	JsonAllocator& GetScratchAllocator() { return m_scratchAllocator; }
+
+	//! Create an intermediate value
+	TValue* NewScratchValue()
+	{
+		return new(m_scratchAllocator.Malloc(sizeof(TValue))) TValue();
+	}
+
+	//! Error code of deserialization, 0 if there is no error
+	int GetRet() const { return m_ret; }
+
+	// Implementation of rapidjson Handler
+	bool Null() { SAXEvent ev(SAXEvent::kNull); return Dispatch(ev); }
+	bool Bool(bool b) { SAXEvent ev(SAXEvent::kBool); ev.b = b; return Dispatch(ev); }
+	bool Int(int i) { SAXEvent ev(SAXEvent::kInt); ev.i = i; return Dispatch(ev); }
+	bool Uint(unsigned u) { SAXEvent ev(SAXEvent::kUint); ev.u = u; return Dispatch(ev); }
+	bool Int64(int64_t i64) { SAXEvent ev(SAXEvent::kInt64); ev.i64 = i64; return Dispatch(ev); }
+	bool Uint64(uint64_t u64) { SAXEvent ev(SAXEvent::kUint64); ev.u64 = u64; return Dispatch(ev); }
+	bool Double(double d) { SAXEvent ev(SAXEvent::kDouble); ev.d = d; return Dispatch(ev); }
+	// Number is stored as string as GenericDocument does
+	bool RawNumber(const Ch* str, rapidjson::SizeType length, bool copy) { return String(str, length, copy); }
+	bool String(const Ch* str, rapidjson::SizeType length, bool copy)
+	{
+		(void)copy;
+		SAXEvent ev(SAXEvent::kString);
+		ev.str = str;
+		ev.length = length;
+		return Dispatch(ev);
+	}
+	bool StartObject() { SAXEvent ev(SAXEvent::kStartObject); return Dispatch(ev); }
+	bool Key(const Ch* str, rapidjson::SizeType length, bool copy)
+	{
+		(void)copy;
+		SAXEvent ev(SAXEvent::kKey);
+		ev.str = str;
+		ev.length = length;
+		return Dispatch(ev);
+	}
+	bool EndObject(rapidjson::SizeType memberCount) { (void)memberCount; SAXEvent ev(SAXEvent::kEndObject); return Dispatch(ev); }
+	bool StartArray() { SAXEvent ev(SAXEvent::kStartArray); return Dispatch(ev); }
+	bool EndArray(rapidjson::SizeType elementCount) { (void)elementCount; SAXEvent ev(SAXEvent::kEndArray); return Dispatch(ev); }
+
+private:
+	void SetPending(TInterface* pIntf, void* pFieldBuffer, FDesc::Mode fDesc, JsonAllocator& allocator)
+	{
+		assert(!m_hasPending);
+		m_pending.pIntf = pIntf;
+		m_pending.pFieldBuffer = pFieldBuffer;
+		m_pending.pAllocator = &allocator;
+		m_pending.fDesc = fDesc;
+		m_pending.isStarted = false;
+		m_pending.isEnd = false;
+		m_pending.isDom = false;
+		m_pending.pCursor = NULL;
+		m_pending.pHint = NULL;
+		m_pending.count = 0;
+		m_hasPending = true;
+	}
+
+	bool Dispatch(const SAXEvent& ev)
+	{
+		if (m_ret != 0) { return false; }
+		// Route event to top state, and to the child value pushed in handling
+		do {
+			if (m_hasPending) {
+				m_stack.push_back(m_pending);
+				m_hasPending = false;
+			}
+			if (m_stack.empty()) {
+				// Event after the root value
+				m_ret = ErrorCode::kInnerError;
+				return false;
+			}
+			const int ret = Handle(m_stack.back(), ev);
+			if (ret != 0) {
+				return Fail(ret);
+			}
+		} while (m_hasPending);
+
+		// Pop completed value, and notify parent
+		while (!m_stack.empty() && m_stack.back().isEnd) {
+			m_stack.pop_back();
+			if (m_stack.empty()) {
+				break;
+			}
+			SAXEvent endEv(SAXEvent::kEndValue);
+			endEv.ret = 0;
+			const int ret = Handle(m_stack.back(), endEv);
+			if (ret != 0) {
+				return Fail(ret);
+			}
+		}
+		return true;
+	}
+
+	//! Notify all parents the error, and stop parsing
+	bool Fail(int ret)
+	{
+		m_hasPending = false;
+		m_ret = ret;
+		m_stack.pop_back();
+		while (!m_stack.empty()) {
+			SAXEvent endEv(SAXEvent::kEndValue);
+			endEv.ret = m_ret;
+			ret = Handle(m_stack.back(), endEv);
+			m_ret = (ret != 0 ? ret : m_ret);
+			m_stack.pop_back();
+		}
+		return false;
+	}
+
+	int Handle(SAXState& state, const SAXEvent& ev)
+	{
+		if (state.pIntf == NULL) {
+			BuildDom(state, ev);
+			return 0;
+		}
+
+		FromSAXReq req(ev, state, *this, m_deserFlag);
+		FromJsonResp resp(m_errDoc);
+		return state.pIntf->FromSAX(req, resp);
+	}
+
+	//! Build DOM value, pFieldBuffer is the value, and pCursor is NULL if the value is skipped
+	void BuildDom(SAXState& state, const SAXEvent& ev)
+	{
+		TValue* pVal = static_cast<TValue*>(state.pFieldBuffer);
+		JsonAllocator& allocator = *state.pAllocator;
+
+		if (!state.isStarted) {
+			state.isStarted = true;
+			switch (ev.type) {
+				case SAXEvent::kStartObject:
+					if (pVal != NULL) { pVal->SetObject(); }
+					break;
+				case SAXEvent::kStartArray:
+					if (pVal != NULL) { pVal->SetArray(); }
+					break;
+				default:
+					if (pVal != NULL) { ev.ToValue(*pVal, allocator); }
+					state.isEnd = true;
+					break;
+			}
+			return;
+		}
+
+		switch (ev.type) {
+			case SAXEvent::kEndObject:
+			case SAXEvent::kEndArray:
+				state.isEnd = true;
+				return;
+			case SAXEvent::kEndValue:
+				return;
+			case SAXEvent::kKey:
+				if (pVal != NULL) {
+					pVal->AddMember(TValue().SetString(ev.str, ev.length, allocator), TValue().Move(), allocator);
+				}
+				return;
+			default:
+				break;
+		}
+
+		// Element of object or array
+		TValue* pElem = NULL;
+		if (pVal != NULL) {
+			if (pVal->IsArray()) {
+				pVal->PushBack(TValue().Move(), allocator);
+				pElem = &(*pVal)[pVal->Size() - 1];
+			}
+			else {
+				assert(pVal->IsObject() && pVal->MemberCount() > 0);
+				pElem = &(pVal->MemberEnd() - 1)->value;
+			}
+		}
+
+		if (ev.IsScalar()) {
+			if (pElem != NULL) { ev.ToValue(*pElem, allocator); }
+		}
+		else {
+			PushDom(pElem, allocator);
+		}
+	}
+
+	const DeserFlag::Flag m_deserFlag;
+	ErrorDocSetter<Encoding>& m_errDoc;
+	int m_ret;
+	std::vector<SAXState> m_stack;
+	SAXState m_pending;
+	bool m_hasPending;
+	JsonAllocator m_scratchAllocator;
+};
+
 /**
  * Get and cast serializerInterface in metaFieldInfo to specify type
  *
@@ -490,6 +1197,165 @@ inline SerializerInterface<Encoding>* GetSerializerInterface(const MetaFieldInfo
 	return reinterpret_cast<SerializerInterface<Encoding>*>(metaFieldInfo.serializerInterface);
 }
 
+/**
+ * Functions generated in the definition of ijst struct, which (de)serialize field selected by index in declaration.
+ * The concrete FSerializer of field is called without virtual call.
+ *
+ * @tparam Encoding 		encoding of ijst struct
+ */
+template<typename Encoding>
+struct GeneratedFieldFunc {
+	typedef typename Encoding::Ch Ch;
+	typedef typename SerializerInterface<Encoding>::FromJsonReq FromJsonReq;
+	typedef typename SerializerInterface<Encoding>::FromJsonResp FromJsonResp;
+
+	typedef int (*SerializeFunc)(const MetaFieldInfo<Ch>& metaField, const void* pField, HandlerBase<Ch>& writer, SerFlag::Flag serFlag);
+	typedef int (*FromJsonFunc)(const MetaFieldInfo<Ch>& metaField, const FromJsonReq& req, IJST_OUT FromJsonResp& resp);
+
+	static SerializeFunc GetSerializeFunc(const MetaClassInfo<Ch>& metaClass)
+	{
+		assert(metaClass.m_pfnSerializeField != NULL);
+		return reinterpret_cast<SerializeFunc>(metaClass.m_pfnSerializeField);
+	}
+
+	static FromJsonFunc GetFromJsonFunc(const MetaClassInfo<Ch>& metaClass)
+	{
+		assert(metaClass.m_pfnFieldFromJson != NULL);
+		return reinterpret_cast<FromJsonFunc>(metaClass.m_pfnFieldFromJson);
+	}
+};
+
+/**
+ * Serialize field via SerializerInterface in metaFieldInfo. The writer is type-erased.
+ *
+ * @tparam Encoding 		encoding of output
+ */
+template<typename Encoding>
+struct FieldSerializerByIntf {
+	typedef typename Encoding::Ch Ch;
+
+	static int Serialize(const MetaFieldInfo<Ch>& metaField, const void* pField, HandlerBase<Ch>& writer, SerFlag::Flag serFlag)
+	{
+		typename SerializerInterface<Encoding>::SerializeReq req(writer, pField, serFlag);
+		return GetSerializerInterface<Encoding>(metaField)->Serialize(req);
+	}
+
+	template<typename Handler>
+	static int Serialize(const MetaFieldInfo<Ch>& metaField, const void* pField, Handler& writer, SerFlag::Flag serFlag)
+	{
+		HandlerWrapper<Handler> writerWrapper(writer);
+		return Serialize(metaField, pField, static_cast<HandlerBase<Ch>&>(writerWrapper), serFlag);
+	}
+};
+
+/**
+ * Serialize field via the function generated in the definition of ijst struct. The writer is type-erased.
+ *
+ * @tparam Encoding 		encoding of output
+ */
+template<typename Encoding>
+class FieldSerializerByFunc {
+public:
+	typedef typename Encoding::Ch Ch;
+
+	explicit FieldSerializerByFunc(const MetaClassInfo<Ch>& metaClass)
+			: m_pfn(GeneratedFieldFunc<Encoding>::GetSerializeFunc(metaClass))
+	{ }
+
+	int Serialize(const MetaFieldInfo<Ch>& metaField, const void* pField, HandlerBase<Ch>& writer, SerFlag::Flag serFlag) const
+	{
+		return m_pfn(metaField, pField, writer, serFlag);
+	}
+
+private:
+	typename GeneratedFieldFunc<Encoding>::SerializeFunc m_pfn;
+};
+
+/**
+ * Serialize field via the code generated in the definition of ijst struct T.
+ * The writer type is known at compile time, so the calls of writer could be inlined.
+ *
+ * @tparam T 				ijst struct
+ */
+template<typename T>
+struct FieldSerializerByStruct {
+	template<typename Handler>
+	static int Serialize(const MetaFieldInfo<typename T::_ijst_Ch>& metaField, const void* pField, Handler& writer, SerFlag::Flag serFlag)
+	{
+		return T::template _ijst_SerializeField<Handler>(metaField, pField, writer, serFlag);
+	}
+};
+
+/**
+ * (De)serialize field of FieldType with static dispatch. Used in the code generated in the definition of ijst struct.
+ *
+ * @tparam isCustomIntf		true if serialize_intf is declared in the field's IDL,
+ * 							then the serializer of field is only known at runtime
+ */
+template<bool isCustomIntf>
+struct FieldSerializerByType {
+	template<typename FieldType, typename Encoding, typename Handler>
+	static int Serialize(const MetaFieldInfo<typename Encoding::Ch>& metaField, const void* pField, Handler& writer, SerFlag::Flag serFlag)
+	{
+		(void)metaField;
+		return FSerializer<FieldType, Encoding>::Serialize(*static_cast<const FieldType*>(pField), writer, serFlag);
+	}
+
+	template<typename FieldType, typename Encoding>
+	static int FromJson(const MetaFieldInfo<typename Encoding::Ch>& metaField,
+						const typename SerializerInterface<Encoding>::FromJsonReq& req,
+						IJST_OUT typename SerializerInterface<Encoding>::FromJsonResp& resp)
+	{
+		(void)metaField;
+		typedef FSerializer<FieldType, Encoding> TSerializer;
+		// Qualified call, without virtual dispatch
+		return IJSTI_FSERIALIZER_INS(FieldType, Encoding).TSerializer::FromJson(req, resp);
+	}
+};
+
+template<>
+struct FieldSerializerByType<true> {
+	template<typename FieldType, typename Encoding, typename Handler>
+	static int Serialize(const MetaFieldInfo<typename Encoding::Ch>& metaField, const void* pField, Handler& writer, SerFlag::Flag serFlag)
+	{
+		return FieldSerializerByIntf<Encoding>::Serialize(metaField, pField, writer, serFlag);
+	}
+
+	template<typename FieldType, typename Encoding>
+	static int FromJson(const MetaFieldInfo<typename Encoding::Ch>& metaField,
+						const typename SerializerInterface<Encoding>::FromJsonReq& req,
+						IJST_OUT typename SerializerInterface<Encoding>::FromJsonResp& resp)
+	{
+		return GetSerializerInterface<Encoding>(metaField)->FromJson(req, resp);
+	}
+};
+
+/**
+ * Check whether the 3rd param (i.e., json_name, desc) in the field's IDL could not be serialize_intf.
+ * Other params such as pointer and NULL are treated as serialize_intf.
+ */
+template<typename T>
+struct IsNotIntfIdlP3 { enum { value = 0 }; };
+template<>
+struct IsNotIntfIdlP3<FDesc::Mode> { enum { value = 1 }; };
+template<typename T, std::size_t N>
+struct IsNotIntfIdlP3<T[N]> { enum { value = 1 }; };
+template<typename T, typename Traits, typename Alloc>
+struct IsNotIntfIdlP3<std::basic_string<T, Traits, Alloc> > { enum { value = 1 }; };
+
+//! Check whether the 4th param in the field's IDL could not be serialize_intf. int is desc for backward compatibility
+template<typename T>
+struct IsNotIntfIdlP4 : public IsNotIntfIdlP3<T> { };
+template<>
+struct IsNotIntfIdlP4<int> { enum { value = 1 }; };
+
+//! Usage: sizeof(MayBeIntfIdlP3(param)) == 2. Only used in unevaluated context
+template<typename T>
+char (&MayBeIntfIdlP3(const T&))[2 - IsNotIntfIdlP3<T>::value];
+//! Usage: sizeof(MayBeIntfIdlP4(param)) == 2. Only used in unevaluated context
+template<typename T>
+char (&MayBeIntfIdlP4(const T&))[2 - IsNotIntfIdlP4<T>::value];
+
 /**	========================================================================================
  *				Private
  */
@@ -519,7 +1385,7 @@ template<typename Encoding>
 class MetaClassInfoSetter {
 public:
 	typedef typename Encoding::Ch Ch;
-	explicit MetaClassInfoSetter(MetaClassInfo<Ch>& _d) : d(_d) { }
+	explicit MetaClassInfoSetter(MetaClassInfo<Ch>& _d) : d(_d), m_declCount(0) { }
 
 	void InitBegin(const std::string& _tag, std::size_t _fieldCount, std::size_t _accessorOffset)
 	{
@@ -534,6 +1400,14 @@ public:
 	/// i.e. (type, name, desc, json_name) is illegal because desc and json_name break the order.
 
 
+	//! Call from IJSTI_METAINFO_DEFINE_START with functions generated in struct definition
+	void SetGeneratedFieldFunc(typename GeneratedFieldFunc<Encoding>::SerializeFunc pfnSerialize,
+							   typename GeneratedFieldFunc<Encoding>::FromJsonFunc pfnFromJson)
+	{
+		d.m_pfnSerializeField = reinterpret_cast<typename MetaClassInfo<Ch>::GenericFunc>(pfnSerialize);
+		d.m_pfnFieldFromJson = reinterpret_cast<typename MetaClassInfo<Ch>::GenericFunc>(pfnFromJson);
+	}
+
 	//! Call from IJSTI_METAINFO_ADD_IMPL_2 with IDL (type, name)
 	//! The serialize interface is always decided by type, so it is generated by caller to reduce template
 	void PushMetaField_2(SerializerInterface<Encoding>* pSerializeInterface, std::size_t offset, const char* fieldName, const char* jsonName)
@@ -613,8 +1487,7 @@ public:
 		SortMetaFieldsByOffset();
 
 		d.m_offsets.reserve(d.m_fieldsInfo.size());
-		d.m_hashedFieldPtr.reserve(d.m_fieldsInfo.size());
-		d.m_nameHashVal.reserve(d.m_fieldsInfo.size());
+		d.m_requiredMask.assign(Util::BitWordCount(d.m_fieldsInfo.size()), 0);
 
 		for (size_t i = 0; i < d.m_fieldsInfo.size(); ++i)
 		{
@@ -622,14 +1495,16 @@ public:
 			ptrMetaField->index = static_cast<int>(i);
 
 			d.m_offsets.push_back(ptrMetaField->offset);
-			InsertMetaFieldToHash(ptrMetaField);
+			if (!Util::IsBitSet(ptrMetaField->desc, FDesc::Optional)) {
+				d.m_requiredMask[i / kBitWordSize] |= Util::BitWordMask(i);
+			}
 			// Assert field offset is sorted and not exist before
 			assert(i == 0 || d.m_offsets[i]  > d.m_offsets[i-1]);
 		}
+		BuildNameHash();
+		BuildSchemaFingerprint();
 
 		assert(d.m_offsets.size() == d.m_fieldsInfo.size());
-		assert(d.m_hashedFieldPtr.size() == d.m_fieldsInfo.size());
-		assert(d.m_nameHashVal.size() == d.m_fieldsInfo.size());
 		d.m_mapInited = true;
 	}
 
@@ -637,6 +1512,8 @@ private:
 	void DoPushMetaField(SerializerInterface<Encoding>* pSerializeInterface, std::size_t offset, const char* fieldName, const char* jsonName, FDesc::Mode desc)
 	{
 		if (pSerializeInterface == NULL) {
+			// The field is ignored, but still occupies an index in declaration
+			++m_declCount;
 			return;
 		}
 
@@ -651,11 +1528,14 @@ private:
 
 	void DoPushMetaField(SerializerInterface<Encoding>* pSerializeInterface, std::size_t offset, const char* fieldName, const std::basic_string<Ch>& jsonName, FDesc::Mode desc)
 	{
+		const int declIndex = m_declCount++;
 		if (pSerializeInterface == NULL) {
 			return;
 		}
 
 		MetaFieldInfo<Ch> metaField;
+		metaField.declIndex = declIndex;
+		metaField.isJsonNameDup = false;
 		metaField.jsonName = jsonName;
 		metaField.fieldName = std::string(fieldName);
 		metaField.offset = offset;
@@ -675,25 +1555,126 @@ private:
 		}
 	}
 
-	void InsertMetaFieldToHash(const MetaFieldInfo<Ch> *ptrMetaField)
+	//! 64-bit FNV-1a hash of class name and fields in order of index
+	void BuildSchemaFingerprint()
 	{
-		const uint32_t hash = MetaClassInfo<Ch>::StringHash(ptrMetaField->jsonName.data(), ptrMetaField->jsonName.length());
+		uint64_t hash = kFingerprintBasis;
+		hash = FingerprintAdd(hash, d.structName.data(), d.structName.size());
+		for (size_t i = 0; i < d.m_fieldsInfo.size(); ++i)
+		{
+			const MetaFieldInfo<Ch>& metaField = d.m_fieldsInfo[i];
+			hash = FingerprintAdd(hash, metaField.fieldName.data(), metaField.fieldName.size());
+			hash = FingerprintAdd(hash, metaField.jsonName.data(), metaField.jsonName.size());
+			hash = FingerprintAdd(hash, static_cast<uint64_t>(metaField.desc));
+			hash = FingerprintAdd(hash,
+					static_cast<SerializerInterface<Encoding>*>(metaField.serializerInterface)->GetTypeTag());
+		}
+		d.m_schemaFingerprint = hash;
+	}
 
-		const detail::Util::VectorBinarySearchResult searchRet =
-				detail::Util::VectorBinarySearch(d.m_nameHashVal, hash);
+	/**
+	 * Build the minimal perfect hash of json names by hash and displace:
+	 * names are grouped into buckets by hash, then for each bucket (the largest first)
+	 * search a displacement which maps all of its names into free slots.
+	 * If some bucket could not be placed, retry with another seed.
+	 */
+	void BuildNameHash()
+	{
+		// Collect distinct json names, the first field wins when the name is duplicated
+		std::vector<const MetaFieldInfo<Ch>*> keys;
+		keys.reserve(d.m_fieldsInfo.size());
+		for (size_t i = 0; i < d.m_fieldsInfo.size(); ++i) {
+			MetaFieldInfo<Ch>* ptrMetaField = &(d.m_fieldsInfo[i]);
+			bool isDup = false;
+			for (size_t j = 0; j < keys.size() && !isDup; ++j) {
+				isDup = (keys[j]->jsonName == ptrMetaField->jsonName);
+			}
+			ptrMetaField->isJsonNameDup = isDup;
+			if (!isDup) {
+				keys.push_back(ptrMetaField);
+			}
+		}
+
+		const size_t n = keys.size();
+		d.m_nameHashDisp.assign(n, 0);
+		d.m_hashedFieldPtr.assign(n, NULL);
+		if (n == 0) {
+			return;
+		}
+
+		const uint32_t kMaxSeed = 1024;
+		for (uint32_t seed = 0; seed < kMaxSeed; ++seed) {
+			if (TryBuildNameHash(keys, seed)) {
+				d.m_nameHashSeed = seed;
+				return;
+			}
+		}
+		// Hash collisions for every seed, FindFieldByJsonName() falls back to linear search of distinct names
+		d.m_nameHashDisp.clear();
+		d.m_hashedFieldPtr = keys;
+	}
+
+	bool TryBuildNameHash(const std::vector<const MetaFieldInfo<Ch>*>& keys, uint32_t seed)
+	{
+		const size_t n = keys.size();
+		std::vector<uint32_t> hashes(n);
+		std::vector<std::vector<size_t> > buckets(n);
+		size_t maxBucketSize = 0;
+		for (size_t i = 0; i < n; ++i) {
+			hashes[i] = MetaClassInfo<Ch>::StringHash(keys[i]->jsonName.data(), keys[i]->jsonName.length(), seed);
+			std::vector<size_t>& bucket = buckets[MetaClassInfo<Ch>::HashReduce(hashes[i], n)];
+			bucket.push_back(i);
+			maxBucketSize = bucket.size() > maxBucketSize ? bucket.size() : maxBucketSize;
+		}
 
-		// Insert new node
-		d.m_hashedFieldPtr.resize(d.m_hashedFieldPtr.size() + 1);
-		d.m_nameHashVal.resize(d.m_nameHashVal.size() + 1);
-		for (size_t i = d.m_nameHashVal.size() - 1; i > searchRet.index; --i) {
-			d.m_nameHashVal[i] = d.m_nameHashVal[i - 1];
-			d.m_hashedFieldPtr[i] = IJSTI_MOVE(d.m_hashedFieldPtr[i - 1]);
+		for (size_t i = 0; i < n; ++i) {
+			d.m_hashedFieldPtr[i] = NULL;
+		}
+		std::vector<size_t> slots;
+		slots.reserve(maxBucketSize);
+		const uint32_t maxDisp = static_cast<uint32_t>(n) * 64 + 1024;
+
+		for (size_t bucketSize = maxBucketSize; bucketSize > 0; --bucketSize) {
+			for (size_t iBucket = 0; iBucket < n; ++iBucket) {
+				const std::vector<size_t>& bucket = buckets[iBucket];
+				if (bucket.size() != bucketSize) {
+					continue;
+				}
+
+				bool isPlaced = false;
+				for (uint32_t disp = 0; disp < maxDisp && !isPlaced; ++disp) {
+					slots.clear();
+					for (size_t k = 0; k < bucketSize; ++k) {
+						const size_t slot = MetaClassInfo<Ch>::HashSlot(hashes[bucket[k]], disp, n);
+						bool isUsed = (d.m_hashedFieldPtr[slot] != NULL);
+						for (size_t j = 0; j < slots.size() && !isUsed; ++j) {
+							isUsed = (slots[j] == slot);
+						}
+						if (isUsed) {
+							break;
+						}
+						slots.push_back(slot);
+					}
+
+					if (slots.size() == bucketSize) {
+						for (size_t k = 0; k < bucketSize; ++k) {
+							d.m_hashedFieldPtr[slots[k]] = keys[bucket[k]];
+						}
+						d.m_nameHashDisp[iBucket] = disp;
+						isPlaced = true;
+					}
+				}
+
+				if (!isPlaced) {
+					return false;
+				}
+			}
 		}
-		d.m_nameHashVal[searchRet.index] = hash;
-		d.m_hashedFieldPtr[searchRet.index] = ptrMetaField;
+		return true;
 	}
 
 	MetaClassInfo<Ch>& d;
+	int m_declCount;
 };
 
 /**
@@ -718,16 +1699,57 @@ public:
 		return pField->_.ISerialize(req);
 	}
 
+	template<typename Handler>
+	static int Serialize(const VarType& field, Handler& writer, SerFlag::Flag serFlag)
+	{
+		return field._.template IStaticSerialize<T>(writer, serFlag);
+	}
+
 	virtual int FromJson(const FromJsonReq &req, IJST_OUT FromJsonResp &resp) IJSTI_OVERRIDE
 	{
 		T *pField = (T *) req.pFieldBuffer;
 		return pField->_.IFromJson(req, resp);
 	}
 
+	virtual int FromSAX(const FromSAXReq &req, IJST_OUT FromJsonResp &resp) IJSTI_OVERRIDE
+	{
+		T *pField = (T *) req.state.pFieldBuffer;
+		return pField->_.IFromSAX(req, resp);
+	}
+
 	virtual void ShrinkAllocator(void *pField) IJSTI_OVERRIDE
 	{
 		((T*)pField)->_.IShrinkAllocator(pField);
 	}
+
+	virtual void GetMemoryUsage(const void* pField, IJST_OUT MemoryUsage& usage) IJSTI_OVERRIDE
+	{
+		static_cast<const T*>(pField)->_.IGetMemoryUsage(usage);
+	}
+
+	virtual Accessor<Encoding>* GetAccessor(void* pField) IJSTI_OVERRIDE
+	{
+		return &static_cast<T*>(pField)->_;
+	}
+
+	virtual void InitSingletons(IJST_OUT std::vector<const void*>& visited) IJSTI_OVERRIDE
+	{
+		if (std::find(visited.begin(), visited.end(), this) != visited.end()) {
+			return;
+		}
+		visited.push_back(this);
+
+		typedef MetaFieldInfo<typename Encoding::Ch> TMetaFieldInfo;
+		const std::vector<TMetaFieldInfo>& fieldsInfo = Singleton<MetaClassInfoTyped<T> >().metaClass.GetFieldsInfo();
+		for (typename std::vector<TMetaFieldInfo>::const_iterator it = fieldsInfo.begin(); it != fieldsInfo.end(); ++it) {
+			static_cast<SerializerInterface<Encoding>*>(it->serializerInterface)->InitSingletons(visited);
+		}
+	}
+
+	virtual uint64_t GetTypeTag() IJSTI_OVERRIDE
+	{
+		return Singleton<MetaClassInfoTyped<T> >().metaClass.GetSchemaFingerprint();
+	}
 };
 
 }	// namespace detail
@@ -58,6 +58,8 @@
 	#define IJSTM_METAINFO_ADD(z, i, _) 	IJSTI_METAINFO_ADD(stName, f##i)
 	#define IJSTM_FIELD_INIT(z, i, _)		,IJSTI_IDL_FNAME f##i ()
 	#define IJSTM_DEFINE_FIELD(z, i, _) 	IJSTI_DEFINE_FIELD f##i
+	#define IJSTM_FIELD_SERIALIZE(z, i, _)	IJSTI_FIELD_SERIALIZE(i, f##i)
+	#define IJSTM_FIELD_FROM_JSON(z, i, _)	IJSTI_FIELD_FROM_JSON(i, f##i)
 
 	#define IJSTM_DEFINE_GETTER(i) 			BOOST_PP_CAT(IJSTI_DEFINE_GETTER_IMPL_, i)
 	#define IJSTM_FIELD_GETTER(z, i, _) 	IJSTI_FIELD_GETTER f##i
@@ -84,6 +86,12 @@
 			BOOST_PP_REPEAT(n, IJSTM_FIELD_INIT, ~)															IJSTM_BSLASH
 			{}	 																							IJSTM_BSLASH
 	private:	 																							IJSTM_BSLASH
+		IJSTI_FIELD_SERIALIZE_DEFINE_START(stName)															IJSTM_BSLASH
+			BOOST_PP_REPEAT(n, IJSTM_FIELD_SERIALIZE, ~)													IJSTM_BSLASH
+		IJSTI_FIELD_SERIALIZE_DEFINE_END()																	IJSTM_BSLASH
+		IJSTI_FIELD_FROM_JSON_DEFINE_START()																IJSTM_BSLASH
+			BOOST_PP_REPEAT(n, IJSTM_FIELD_FROM_JSON, ~)													IJSTM_BSLASH
+		IJSTI_FIELD_FROM_JSON_DEFINE_END()																	IJSTM_BSLASH
 		IJSTI_METAINFO_DEFINE_START(stName, n)	 															IJSTM_BSLASH
 			BOOST_PP_REPEAT(n, IJSTM_METAINFO_ADD, ~)														IJSTM_BSLASH
 		IJSTI_METAINFO_DEFINE_END()	 																		IJSTM_BSLASH
@@ -0,0 +1,69 @@
+#ifndef IJST_DETAIL_PARALLEL_HPP_INCLUDE_
+#define IJST_DETAIL_PARALLEL_HPP_INCLUDE_
+
+#include "../ijst.h"
+#include "utils.h"
+
+#if __cplusplus < 201103L && !(defined(_MSC_VER) && _MSC_VER >= 1900)
+	#error "Parallel features of ijst require C++11"
+#endif
+
+#include <cstddef>	// size_t
+#include <thread>
+#include <vector>
+
+namespace ijst {
+namespace detail {
+
+//! Get count of threads to use when user does not specify it
+inline unsigned GetDefaultThreadCount()
+{
+	const unsigned count = std::thread::hardware_concurrency();
+	return count == 0 ? 1 : count;
+}
+
+//! Whether current thread is running a task dispatched by RunInThreads() or ThreadPool
+inline bool& InParallelTask()
+{
+	static IJSTI_THREAD_LOCAL bool inTask = false;
+	return inTask;
+}
+
+//! Mark current thread is running parallel task in scope
+class ParallelTaskScope {
+public:
+	ParallelTaskScope() : m_prev(InParallelTask()) { InParallelTask() = true; }
+	~ParallelTaskScope() { InParallelTask() = m_prev; }
+
+private:
+	ParallelTaskScope(const ParallelTaskScope&) IJSTI_DELETED;
+	ParallelTaskScope& operator=(ParallelTaskScope) IJSTI_DELETED;
+
+	const bool m_prev;
+};
+
+/**
+ * Run task(i) for each i in [0, taskCount), each in its own thread. Task 0 is run in the calling thread.
+ * Return after all tasks finished.
+ */
+template<typename Task>
+inline void RunInThreads(std::size_t taskCount, Task& task)
+{
+	std::vector<std::thread> threads;
+	threads.reserve(taskCount == 0 ? 0 : taskCount - 1);
+	for (std::size_t i = 1; i < taskCount; ++i) {
+		threads.push_back(std::thread([&task, i]() { ParallelTaskScope scope; task(i); }));
+	}
+	if (taskCount != 0) {
+		ParallelTaskScope scope;
+		task(0);
+	}
+	for (std::size_t i = 0; i < threads.size(); ++i) {
+		threads[i].join();
+	}
+}
+
+}	// namespace detail
+}	// namespace ijst
+
+#endif //IJST_DETAIL_PARALLEL_HPP_INCLUDE_
@@ -4,6 +4,10 @@
 #include "../ijst.h"
 #include <vector>
 #include <cstddef>	// NULL, size_t
+#include <new>		// placement new
+#if __cplusplus >= 201103L
+#include <atomic>
+#endif
 
 namespace ijst {
 namespace detail {
@@ -20,6 +24,14 @@ namespace detail {
 	#define IJSTI_STATIC_ASSERT(cond, msg)
 #endif
 
+#if __cplusplus >= 201103L
+	#define IJSTI_THREAD_LOCAL					thread_local
+#elif defined(_MSC_VER)
+	#define IJSTI_THREAD_LOCAL					__declspec(thread)
+#else
+	#define IJSTI_THREAD_LOCAL					__thread
+#endif
+
 #if IJST_HAS_CXX11_RVALUE_REFS
 	#define IJSTI_MOVE(val) 					std::move((val))
 #else
@@ -71,6 +83,190 @@ struct ArgumentType;
 template<typename T, typename U>
 struct ArgumentType<U(T)> {typedef T type;};
 
+/**
+ * Whether input or output stream failed. Streams of rapidjson never fail, streams that could fail specialize it,
+ * e.g., FileOutputStream and FileInputStream in "stream.h"
+ */
+template<typename Stream>
+struct StreamFailChecker {
+	static bool IsFailed(const Stream& s) { (void)s; return false; }
+};
+
+/**
+ * Counter for statistics. The increment is atomic (relaxed order) since C++11
+ */
+class StatCounter {
+public:
+	StatCounter() : m_val(0) {}
+
+	void Increase()
+	{
+#if __cplusplus >= 201103L
+		m_val.fetch_add(1, std::memory_order_relaxed);
+#else
+		++m_val;
+#endif
+	}
+
+	size_t Get() const { return m_val; }
+	void Reset() { m_val = 0; }
+
+private:
+	StatCounter(const StatCounter&) IJSTI_DELETED;
+	StatCounter& operator=(const StatCounter&) IJSTI_DELETED;
+
+#if __cplusplus >= 201103L
+	std::atomic<size_t> m_val;
+#else
+	size_t m_val;
+#endif
+};
+
+/**
+ * Thread local pool of resource blocks. Blocks are classified by size aligned to kAlignSize,
+ * so blocks of the same struct type are recycled. Each thread caches at most kMaxCachedPerClass blocks per class,
+ * and larger blocks are not cached. The pool is only available since C++11, operator new is used else.
+ *
+ * @note A block may be freed in a thread which is different from the allocating one.
+ */
+class ResourcePool {
+public:
+	static const size_t kAlignSize = 16;
+	static const size_t kClassCount = 32;
+	static const size_t kMaxCachedPerClass = 64;
+
+	static void* Alloc(size_t size)
+	{
+#if __cplusplus >= 201103L
+		const size_t iClass = SizeClass(size);
+		if (iClass < kClassCount) {
+			State& state = ThreadState();
+			FreeNode* pNode = state.freeList[iClass];
+			if (pNode != NULL) {
+				state.freeList[iClass] = pNode->next;
+				--state.cachedCount[iClass];
+				return pNode;
+			}
+			return ::operator new((iClass + 1) * kAlignSize);
+		}
+#endif
+		return ::operator new(size);
+	}
+
+	static void Free(void* ptr, size_t size)
+	{
+		if (ptr == NULL) {
+			return;
+		}
+#if __cplusplus >= 201103L
+		const size_t iClass = SizeClass(size);
+		State& state = ThreadState();
+		if (iClass < kClassCount && !state.isClosed && state.cachedCount[iClass] < kMaxCachedPerClass) {
+			// Make sure cached blocks are released when thread exits
+			static thread_local Closer closer;
+			(void)closer;
+			FreeNode* pNode = static_cast<FreeNode*>(ptr);
+			pNode->next = state.freeList[iClass];
+			state.freeList[iClass] = pNode;
+			++state.cachedCount[iClass];
+			return;
+		}
+#else
+		(void)size;
+#endif
+		::operator delete(ptr);
+	}
+
+	//! Release blocks cached by current thread
+	static void Trim()
+	{
+#if __cplusplus >= 201103L
+		State& state = ThreadState();
+		for (size_t i = 0; i < kClassCount; ++i) {
+			while (state.freeList[i] != NULL) {
+				FreeNode* pNode = state.freeList[i];
+				state.freeList[i] = pNode->next;
+				::operator delete(pNode);
+			}
+			state.cachedCount[i] = 0;
+		}
+#endif
+	}
+
+	//! Get count of blocks cached by current thread
+	static size_t GetCachedCount()
+	{
+		size_t count = 0;
+#if __cplusplus >= 201103L
+		State& state = ThreadState();
+		for (size_t i = 0; i < kClassCount; ++i) {
+			count += state.cachedCount[i];
+		}
+#endif
+		return count;
+	}
+
+private:
+	struct FreeNode {
+		FreeNode* next;
+	};
+
+	static size_t SizeClass(size_t size)
+	{
+		return size == 0 ? 0 : (size - 1) / kAlignSize;
+	}
+
+#if __cplusplus >= 201103L
+	// Trivially destructible, so it is still accessible when objects are destroyed after the closer
+	struct State {
+		FreeNode* freeList[kClassCount];
+		size_t cachedCount[kClassCount];
+		bool isClosed;
+	};
+
+	struct Closer {
+		~Closer()
+		{
+			Trim();
+			ThreadState().isClosed = true;
+		}
+	};
+
+	static State& ThreadState()
+	{
+		static thread_local State state;	// zero initialized
+		return state;
+	}
+#endif
+};
+
+/**
+ * Create object in block allocated by IJST_RESOURCE_ALLOC
+ */
+template<typename T>
+inline T* NewResource()
+{
+	void* ptr = IJST_RESOURCE_ALLOC(sizeof(T));
+	return new(ptr) T();
+}
+
+/**
+ * Destroy object created by NewResource()
+ */
+template<typename T>
+inline void DeleteResource(T* ptr)
+{
+	if (ptr == NULL) {
+		return;
+	}
+	ptr->~T();
+	IJST_RESOURCE_FREE(ptr, sizeof(T));
+}
+
+//! Word of bitset
+typedef size_t BitWord;
+static const size_t kBitWordSize = sizeof(BitWord) * 8;
+
 struct Util {
 	/**
 	 * Custom swap() to avoid dependency on C++ <algorithm> header
@@ -121,6 +317,18 @@ struct Util {
 		return (val & bit) != 0;
 	}
 
+	//! Count of BitWord to store nBits bits
+	static size_t BitWordCount(size_t nBits)
+	{
+		return (nBits + kBitWordSize - 1) / kBitWordSize;
+	}
+
+	//! Mask of bit i in BitWord, the word is i / kBitWordSize
+	static BitWord BitWordMask(size_t i)
+	{
+		return static_cast<BitWord>(1) << (i % kBitWordSize);
+	}
+
 };
 
 } // namespace detail
@@ -7,6 +7,7 @@
 
 #include <rapidjson/rapidjson.h>
 #include <cassert>		// assert
+#include <cstddef>		// size_t
 
 /**	========================================================================================
  *				Public Interface
@@ -87,6 +88,50 @@
 	#define IJST_OFFSET_BUFFER_DELETE(ptrId)		delete[] ptrId
 #endif
 
+/**
+ * @ingroup IJST_CONFIG
+ *
+ *	Accessor allocates its own document and the status of fields in large struct in heap, and T_raw allocates its
+ *	own allocator in heap. By default, these blocks are allocated by global operator new.
+ *	User can set IJST_USE_RESOURCE_POOL to 1 to recycle these blocks in a thread local pool, which is classified by
+ *	size of block. The pool is only available since C++11 (falls back to operator new else).
+ *	User can also override the allocation by defining IJST_RESOURCE_ALLOC, IJST_RESOURCE_FREE macro.
+ *
+ *	@see ijst::detail::ResourcePool
+ */
+#ifndef IJST_USE_RESOURCE_POOL
+	#define IJST_USE_RESOURCE_POOL	0
+#endif
+
+#if IJST_USE_RESOURCE_POOL
+	#define IJSTI_RESOURCE_ALLOC_DEFAULT(size)			::ijst::detail::ResourcePool::Alloc(size)
+	#define IJSTI_RESOURCE_FREE_DEFAULT(ptr, size)		::ijst::detail::ResourcePool::Free((ptr), (size))
+#else
+	#define IJSTI_RESOURCE_ALLOC_DEFAULT(size)			::operator new(size)
+	#define IJSTI_RESOURCE_FREE_DEFAULT(ptr, size)		::operator delete(ptr)
+#endif
+
+#ifndef IJST_RESOURCE_ALLOC
+	//! customization point for allocating resource block of accessor and T_raw, returns void*
+	#define IJST_RESOURCE_ALLOC(size)					IJSTI_RESOURCE_ALLOC_DEFAULT(size)
+#endif
+#ifndef IJST_RESOURCE_FREE
+	//! customization point for freeing resource block allocated by IJST_RESOURCE_ALLOC
+	#define IJST_RESOURCE_FREE(ptr, size)				IJSTI_RESOURCE_FREE_DEFAULT(ptr, size)
+#endif
+
+/**
+ * @ingroup IJST_CONFIG
+ *
+ *	By default, ijst doesn't count whether the json key prediction in deserialization hits.
+ *	User can set IJST_KEY_PREDICTION_STAT to 1 to enable the counters, which is atomic since C++11.
+ *
+ *	@see MetaClassInfo::GetKeyPredictionHit(), MetaClassInfo::GetKeyPredictionMiss()
+ */
+#ifndef IJST_KEY_PREDICTION_STAT
+	#define IJST_KEY_PREDICTION_STAT	0
+#endif
+
 /** @defgroup IJST_MACRO_API ijst macro API
  *  @brief macro API
  *
@@ -200,10 +245,84 @@ struct DeserFlag {
 		 * @see		Accessor::ShrinkAllocator()
 		 */
 		, kMoveFromIntermediateDoc	= 0x0008
+		/**
+		 * @brief  Set if route events of parser to fields directly without intermediate document when deserialize.
+		 *
+		 * This option will speed up deserialization and reduce memory usage, only unknown and T_raw fields are
+		 * built as DOM values. But the fields may be partially modified when parse error occurs,
+		 * and value error may be reported before parse error.
+		 *
+		 * kMoveFromIntermediateDoc is ignored when this option is set.
+		 * This option only takes effect in Accessor::Deserialize().
+		 */
+		, kNoIntermediateDoc		= 0x0010
+		/**
+		 * @brief  Set if reuse memory of fields when deserialize into existing object.
+		 *
+		 * Sequence containers keep their capacity and existing elements, which are deserialized in place,
+		 * the elements of map are reused by key (when deserializing with intermediate document),
+		 * and strings keep their capacity. This is useful when deserializing into the same object repeatedly.
+		 *
+		 * @note	Elements are deserialized over their old values. Status of fields of nested struct is reset
+		 * 			before deserializing, so the fields that missing in json keep their old values with kMissing status.
+		 */
+		, kReuseFields				= 0x0020
+		/**
+		 * @brief  Set if deserialize elements of large array of ijst structs in multiple threads.
+		 *
+		 * The elements are split into shards of at least IJST_PARALLEL_ARRAY_MIN_SHARD_SIZE elements after the
+		 * intermediate document is built, each shard is deserialized in its own thread.
+		 * Elements deserialized in threads always use their own allocators (kMoveFromIntermediateDoc is ignored
+		 * for them), and arrays nested in them are deserialized in the thread of the element.
+		 *
+		 * This option is ignored unless IJST_ENABLE_PARALLEL_ARRAY is set to 1 (which requires C++11),
+		 * and is ignored when kNoIntermediateDoc is set.
+		 */
+		, kParallelArray			= 0x0040
 	};
 };
 IJSTI_DECLARE_ENUM_OPERATOR_OR(DeserFlag::Flag)
 
+/**
+ * @brief Heap memory held by an object, see Accessor::GetMemoryUsage().
+ *
+ * The size of the object itself is not included, but the storage of elements in containers is.
+ * Sizes of node-based containers (deque, list, map) and unknown fields are estimated.
+ */
+struct MemoryUsage {
+	//! Resource of accessors in heap, i.e., own document and status of fields in large struct
+	std::size_t accessorBytes;
+	//! Capacity of own allocators of accessors and T_raw fields, including the allocator objects
+	std::size_t allocatorCapacity;
+	//! Used bytes in own allocators
+	std::size_t allocatorUsed;
+	//! Storage of containers, including nodes of deque, list and map
+	std::size_t containerBytes;
+	//! Storage of strings outside the string objects
+	std::size_t stringBytes;
+	//! Values of unknown fields, which live in the allocators, so it is not counted in Total()
+	std::size_t unknownBytes;
+
+	MemoryUsage()
+		: accessorBytes(0), allocatorCapacity(0), allocatorUsed(0),
+		  containerBytes(0), stringBytes(0), unknownBytes(0)
+	{ }
+
+	//! Total bytes in heap
+	std::size_t Total() const { return accessorBytes + allocatorCapacity + containerBytes + stringBytes; }
+
+	MemoryUsage& operator+=(const MemoryUsage& rhs)
+	{
+		accessorBytes += rhs.accessorBytes;
+		allocatorCapacity += rhs.allocatorCapacity;
+		allocatorUsed += rhs.allocatorUsed;
+		containerBytes += rhs.containerBytes;
+		stringBytes += rhs.stringBytes;
+		unknownBytes += rhs.unknownBytes;
+		return *this;
+	}
+};
+
 //! Error codes.
 namespace ErrorCode { // Declare ErrorCode in namespace to make it easy to add error codes in other places
 	const int kSucc 							= 0x0000;
@@ -213,8 +332,10 @@ namespace ErrorCode { // Declare ErrorCode in namespace to make it easy to add e
 	const int kDeserializeValueIsDefault		= 0x1004;
 	const int kDeserializeSomeUnknownMember		= 0x1005;
 	const int kDeserializeMapKeyDuplicated		= 0x1006;
+	const int kDeserializeSchemaMismatch		= 0x1007;
 	const int kInnerError 						= 0x2001;
 	const int kWriteFailed						= 0x3001;
+	const int kReadFailed						= 0x3002;
 } // namespace ErrorCode
 
 } // namespace ijst
@@ -9,11 +9,13 @@
 
 namespace ijst {
 
+template<typename Encoding> class Accessor;
 namespace detail {
 	// forward declaration
 	// these declaration is only use for friend class declaration
 	template<typename T> class MetaClassInfoTyped;
 	template<typename CharType> class MetaClassInfoSetter;
+	template<typename Encoding> struct GeneratedFieldFunc;
 }
 /**
  * @brief Meta information of field.
@@ -37,6 +39,10 @@ struct MetaFieldInfo { // NOLINT
 	std::string fieldName;
 	//! @private private serializer interface.
 	void* serializerInterface;		// type: detail::SerializerInterface<Encoding>*
+	//! @private The index of this field in the declaration of struct. Used by the code generated in struct definition.
+	int declIndex;
+	//! @private Whether a field with smaller index has the same json name. Such field is never found by json name.
+	bool isJsonNameDup;
 };
 
 /**
@@ -78,33 +84,29 @@ public:
 	 * @param length	field's json name length
 	 * @return			pointer of info if found, null else
 	 *
-	 * @note log(FieldSize) complexity.
+	 * @note O(1) complexity: one hash of name, one probe of the minimal perfect hash table and one compare.
+	 * Falls back to linear search in the unlikely case that the hash could not be built.
 	 */
 	const MetaFieldInfo<Ch>* FindFieldByJsonName(const Ch* name, size_t length) const
 	{
-		const uint32_t hash = StringHash(name, length);
-		const detail::Util::VectorBinarySearchResult searchRet =
-				detail::Util::VectorBinarySearch(m_nameHashVal, hash);
-
-		if (!searchRet.isFind) {
-			// not find
+		const size_t tableSize = m_hashedFieldPtr.size();
+		if (m_nameHashDisp.empty()) {
+			// The perfect hash is not built, m_hashedFieldPtr holds the distinct json names in order of index
+			for (size_t i = 0; i < tableSize; ++i) {
+				if (IsJsonNameEqual(m_hashedFieldPtr[i], name, length)) {
+					return m_hashedFieldPtr[i];
+				}
+			}
 			return NULL;
 		}
 
-		// step back to find the first value with hash
-		size_t i = searchRet.index;
-		for (; i > 0 && m_nameHashVal[i -1] == hash; --i) {
-		}
+		const uint32_t hash = StringHash(name, length, m_nameHashSeed);
+		const uint32_t disp = m_nameHashDisp[HashReduce(hash, tableSize)];
+		const MetaFieldInfo<Ch>* pField = m_hashedFieldPtr[HashSlot(hash, disp, tableSize)];
 
-		// compare each json name with target hash
-		for (const size_t iSize = m_hashedFieldPtr.size(); i < iSize && m_nameHashVal[i] == hash; ++i) {
-			const MetaFieldInfo<Ch>* pField = m_hashedFieldPtr[i];
-			const std::basic_string<Ch>& fieldJsonName = pField->jsonName;
-			if (fieldJsonName.compare(0, fieldJsonName.length(), name, length) == 0) {
-				return pField;
-			}
+		if (pField != NULL && IsJsonNameEqual(pField, name, length)) {
+			return pField;
 		}
-
 		return NULL;
 	}
 
@@ -114,48 +116,139 @@ public:
 	 * @param name		field's json name
 	 * @return			pointer of info if found, null else
 	 *
-	 * @note log(FieldSize) complexity.
+	 * @note O(1) complexity.
 	 */
 	const MetaFieldInfo<Ch>* FindFieldByJsonName(const std::basic_string<Ch>& name) const
 	{ return FindFieldByJsonName(name.data(), name.length()); }
 
+	/**
+	 * @brief Find meta information of filed by json name, predict that json keys are in the order of declaration.
+	 *
+	 * The field declared after pPrevField is compared first, and FindFieldByJsonName() is called if not match.
+	 *
+	 * @param pPrevField	the field matched last time, NULL if there is none
+	 * @param name			field's json name
+	 * @param length		field's json name length
+	 * @return				pointer of info if found, null else
+	 *
+	 * @see GetKeyPredictionHit(), GetKeyPredictionMiss()
+	 */
+	const MetaFieldInfo<Ch>* FindNextFieldByJsonName(const MetaFieldInfo<Ch>* pPrevField, const Ch* name, size_t length) const
+	{
+		const size_t iNext = (pPrevField == NULL) ? 0 : static_cast<size_t>(pPrevField->index) + 1;
+		if (iNext < m_fieldsInfo.size()) {
+			const MetaFieldInfo<Ch>* pNextField = &m_fieldsInfo[iNext];
+			// Field with duplicated json name is never predicted, so the result does not depend on the order of keys
+			if (!pNextField->isJsonNameDup && IsJsonNameEqual(pNextField, name, length)) {
+#if IJST_KEY_PREDICTION_STAT
+				m_keyPredictionHit.Increase();
+#endif
+				return pNextField;
+			}
+		}
+
+#if IJST_KEY_PREDICTION_STAT
+		m_keyPredictionMiss.Increase();
+#endif
+		return FindFieldByJsonName(name, length);
+	}
+
+	//! Get count of json keys predicted by FindNextFieldByJsonName(). Always 0 unless IJST_KEY_PREDICTION_STAT is 1
+	size_t GetKeyPredictionHit() const { return m_keyPredictionHit.Get(); }
+	//! Get count of json keys not predicted by FindNextFieldByJsonName(). Always 0 unless IJST_KEY_PREDICTION_STAT is 1
+	size_t GetKeyPredictionMiss() const { return m_keyPredictionMiss.Get(); }
+	//! Reset counters of json key prediction
+	void ResetKeyPredictionStat() const { m_keyPredictionHit.Reset(); m_keyPredictionMiss.Reset(); }
+
 	//! Get meta information of all fields in class. The returned vector is sorted by offset.
 	const std::vector<MetaFieldInfo<Ch> >& GetFieldsInfo() const { return m_fieldsInfo; }
 	//! Get name of class.
 	const std::string& GetClassName() const { return structName; }
 	//! Get the offset of Accessor object.
 	std::size_t GetAccessorOffset() const { return accessorOffset; }
+	/**
+	 * @brief Get fingerprint of schema, which is a hash of class name, and field name, json name, FDesc and type
+	 * of each field.
+	 *
+	 * The fingerprint changes when a field is added, removed, renamed, reordered, or changes its FDesc or type.
+	 * Types with the same encoding are not distinguished, e.g., vector, deque and list of same elements.
+	 * The type of nested ijst struct is its fingerprint, and fields of user defined serializers share a type.
+	 *
+	 * @see SerializeBinary()
+	 */
+	uint64_t GetSchemaFingerprint() const { return m_schemaFingerprint; }
 
 private:
 	template<typename> friend class detail::MetaClassInfoSetter;
 	template<typename> friend class detail::MetaClassInfoTyped;
-	MetaClassInfo() : accessorOffset(0), m_mapInited(false) { }
+	template<typename> friend struct detail::GeneratedFieldFunc;
+	template<typename> friend class Accessor;
+	MetaClassInfo() : accessorOffset(0), m_pfnSerializeField(NULL), m_pfnFieldFromJson(NULL), m_nameHashSeed(0), m_schemaFingerprint(0), m_mapInited(false) { }
 
 	MetaClassInfo(const MetaClassInfo&) IJSTI_DELETED;
 	MetaClassInfo& operator=(MetaClassInfo) IJSTI_DELETED;
 
-	static uint32_t StringHash(const Ch* str, size_t length)
+	static uint32_t StringHash(const Ch* str, size_t length, uint32_t seed)
 	{
-		// Use 32-bit FNV-1a hash
+		// Use 32-bit FNV-1a hash, seeded by xor-ing the offset basis
 		const uint32_t kPrime = (1 << 24) + (1 << 8) + 0x93;
 		const uint32_t kBasis = 0x811c9dc5;
-		uint32_t hash = kBasis;
+		uint32_t hash = kBasis ^ seed;
 		for (size_t i = 0; i < length;
 			 ++i, ++str)
 		{
-			hash ^= *str;
+			hash ^= static_cast<uint32_t>(*str);
 			hash *= kPrime;
 		}
 		return hash;
 	}
 
+	static bool IsJsonNameEqual(const MetaFieldInfo<Ch>* pField, const Ch* name, size_t length)
+	{
+		const std::basic_string<Ch>& fieldJsonName = pField->jsonName;
+		return fieldJsonName.length() == length
+			   && std::char_traits<Ch>::compare(fieldJsonName.data(), name, length) == 0;
+	}
+
+	//! Map hash to [0, size) by multiply-shift instead of modulo
+	static size_t HashReduce(uint32_t hash, size_t size)
+	{
+		return static_cast<size_t>((static_cast<uint64_t>(hash) * size) >> 32);
+	}
+
+	//! Slot of hash in the table after applying the displacement of its bucket
+	static size_t HashSlot(uint32_t hash, uint32_t disp, size_t size)
+	{
+		uint32_t x = hash ^ disp;
+		x ^= x >> 16;
+		x *= 0x7feb352dU;
+		x ^= x >> 15;
+		return HashReduce(x, size);
+	}
+
 	std::vector<MetaFieldInfo<Ch> > m_fieldsInfo;
 	std::string structName;
 	std::size_t accessorOffset;
 
-	std::vector<uint32_t> m_nameHashVal;
+	// Functions generated in struct definition, type: detail::GeneratedFieldFunc<Encoding>::*Func
+	typedef void (*GenericFunc)();
+	GenericFunc m_pfnSerializeField;
+	GenericFunc m_pfnFieldFromJson;
+
+	// Minimal perfect hash of json names, built in MetaClassInfoSetter::InitEnd():
+	// bucket = HashReduce(hash), slot = HashSlot(hash, m_nameHashDisp[bucket]).
+	// m_nameHashDisp is empty if the hash could not be built, then m_hashedFieldPtr is searched linearly
+	uint32_t m_nameHashSeed;
+	std::vector<uint32_t> m_nameHashDisp;
 	std::vector<const MetaFieldInfo<Ch>*> m_hashedFieldPtr;
 	std::vector<size_t> m_offsets;
+	// Bit i is set if field with index i is required, i.e., not FDesc::Optional
+	std::vector<detail::BitWord> m_requiredMask;
+	// Built in MetaClassInfoSetter::InitEnd()
+	uint64_t m_schemaFingerprint;
+
+	mutable detail::StatCounter m_keyPredictionHit;
+	mutable detail::StatCounter m_keyPredictionMiss;
 
 	bool m_mapInited;
 };
@@ -0,0 +1,1081 @@
+/**************************************************************************************************
+ *		MessagePack writer and reader, which connect MessagePack to the SAX interfaces of ijst,
+ *		and (de)serialization of ijst struct from MessagePack and the schema-indexed binary encoding
+ **************************************************************************************************/
+
+#ifndef IJST_MSGPACK_HPP_INCLUDE_
+#define	IJST_MSGPACK_HPP_INCLUDE_
+
+#include "ijst.h"
+#include "accessor.h"
+#include "detail/utils.h"
+
+#include <rapidjson/document.h>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace ijst {
+
+/**
+ * @brief Ext types of MessagePack used by ijst.
+ *
+ * The data of kPacked* types is an array of numbers, each of which is written in little endian with fixed size.
+ */
+struct MsgPackExt {
+	enum Type {
+		//! Array of int32
+		kPackedInt			= 1,
+		//! Array of uint32
+		kPackedUint			= 2,
+		//! Array of int64
+		kPackedInt64		= 3,
+		//! Array of uint64
+		kPackedUint64		= 4,
+		//! Array of float 64
+		kPackedDouble		= 5
+	};
+};
+
+namespace detail {
+
+//! Conversion between number and the bits in packed array. This template is only specialized for number types
+template<typename T>
+struct PackedNumber {
+};
+
+#define IJSTI_DEFINE_PACKED_NUMBER(T, BitsT, extType)										\
+	template<>																				\
+	struct PackedNumber<T> {																\
+		static const int kExtType = extType;												\
+		static uint64_t ToBits(T val) { return static_cast<BitsT>(val); }					\
+		static T FromBits(uint64_t bits) { return static_cast<T>(static_cast<BitsT>(bits)); }	\
+	};
+
+IJSTI_DEFINE_PACKED_NUMBER(int, uint32_t, MsgPackExt::kPackedInt)
+IJSTI_DEFINE_PACKED_NUMBER(unsigned int, uint32_t, MsgPackExt::kPackedUint)
+IJSTI_DEFINE_PACKED_NUMBER(int64_t, uint64_t, MsgPackExt::kPackedInt64)
+IJSTI_DEFINE_PACKED_NUMBER(uint64_t, uint64_t, MsgPackExt::kPackedUint64)
+
+template<>
+struct PackedNumber<double> {
+	static const int kExtType = MsgPackExt::kPackedDouble;
+	static uint64_t ToBits(double val) { uint64_t bits; std::memcpy(&bits, &val, sizeof(bits)); return bits; }
+	static double FromBits(uint64_t bits) { double val; std::memcpy(&val, &bits, sizeof(val)); return val; }
+};
+
+}	// namespace detail
+
+/**
+ * @brief Writer of MessagePack, which implements rapidjson::Handler concept.
+ *
+ * Wrap it with HandlerWrapper to use it as HandlerBase, e.g., in Accessor::Serialize(HandlerBase&).
+ * Integers are written in the smallest format, doubles as float 64, strings and keys as str.
+ * RawNumber is written as str as well.
+ *
+ * Since the count of elements is unknown before EndArray()/EndObject(), a 5-byte header is reserved when the
+ * container starts, and is shrunk to the smallest format when it ends.
+ *
+ * @note Only UTF-8 is supported.
+ */
+class MsgPackWriter {
+public:
+	typedef char Ch;
+
+	//! Construct with output buffer. The output is appended to the buffer
+	explicit MsgPackWriter(std::string& output) : m_output(output) {}
+
+	bool Null() { BeginValue(); Put(0xc0); return true; }
+	bool Bool(bool b) { BeginValue(); Put(b ? 0xc3 : 0xc2); return true; }
+	bool Int(int i) { return Int64(i); }
+	bool Uint(unsigned u) { return Uint64(u); }
+
+	bool Int64(int64_t i)
+	{
+		if (i >= 0) {
+			return Uint64(static_cast<uint64_t>(i));
+		}
+
+		BeginValue();
+		if (i >= -32) {
+			Put(static_cast<unsigned char>(i));
+		}
+		else if (i >= -128) {
+			Put(0xd0);
+			PutBigEndian(static_cast<uint64_t>(i), 1);
+		}
+		else if (i >= -32768) {
+			Put(0xd1);
+			PutBigEndian(static_cast<uint64_t>(i), 2);
+		}
+		else if (i >= -2147483647 - 1) {
+			Put(0xd2);
+			PutBigEndian(static_cast<uint64_t>(i), 4);
+		}
+		else {
+			Put(0xd3);
+			PutBigEndian(static_cast<uint64_t>(i), 8);
+		}
+		return true;
+	}
+
+	bool Uint64(uint64_t u)
+	{
+		BeginValue();
+		if (u < 0x80u) {
+			Put(static_cast<unsigned char>(u));
+		}
+		else if (u <= 0xffu) {
+			Put(0xcc);
+			PutBigEndian(u, 1);
+		}
+		else if (u <= 0xffffu) {
+			Put(0xcd);
+			PutBigEndian(u, 2);
+		}
+		else if (u <= 0xffffffffu) {
+			Put(0xce);
+			PutBigEndian(u, 4);
+		}
+		else {
+			Put(0xcf);
+			PutBigEndian(u, 8);
+		}
+		return true;
+	}
+
+	bool Double(double d)
+	{
+		BeginValue();
+		uint64_t bits;
+		std::memcpy(&bits, &d, sizeof(bits));
+		Put(0xcb);
+		PutBigEndian(bits, 8);
+		return true;
+	}
+
+	bool RawNumber(const Ch* str, rapidjson::SizeType length, bool copy = false)
+	{ return String(str, length, copy); }
+
+	bool String(const Ch* str, rapidjson::SizeType length, bool copy = false)
+	{
+		(void)copy;
+		BeginValue();
+		PutStr(str, length);
+		return true;
+	}
+
+	bool StartObject() { BeginValue(); StartContainer(true); return true; }
+
+	bool Key(const Ch* str, rapidjson::SizeType length, bool copy = false)
+	{
+		(void)copy;
+		if (m_stack.empty() || !m_stack.back().isObject) {
+			return false;
+		}
+		++m_stack.back().count;
+		PutStr(str, length);
+		return true;
+	}
+
+	bool EndObject(rapidjson::SizeType memberCount = 0) { (void)memberCount; return EndContainer(true); }
+	bool StartArray() { BeginValue(); StartContainer(false); return true; }
+	bool EndArray(rapidjson::SizeType elementCount = 0) { (void)elementCount; return EndContainer(false); }
+
+	/**
+	 * @brief Write array of numbers as an ext value of MsgPackExt::kPacked* type.
+	 *
+	 * It is not a part of rapidjson::Handler concept, and is only understood by MsgPackReader.
+	 *
+	 * @tparam T	int, unsigned, int64_t, uint64_t or double
+	 */
+	template<typename T>
+	bool PackedArray(const T* vals, rapidjson::SizeType count)
+	{
+		BeginValue();
+		const uint64_t length = static_cast<uint64_t>(count) * sizeof(T);
+		if (length <= 0xffu) {
+			Put(0xc7);
+			PutBigEndian(length, 1);
+		}
+		else if (length <= 0xffffu) {
+			Put(0xc8);
+			PutBigEndian(length, 2);
+		}
+		else if (length <= 0xffffffffu) {
+			Put(0xc9);
+			PutBigEndian(length, 4);
+		}
+		else {
+			return false;
+		}
+		Put(static_cast<unsigned char>(detail::PackedNumber<T>::kExtType));
+
+		// Write in a tight loop to the resized buffer
+		std::size_t pos = m_output.size();
+		m_output.resize(pos + static_cast<std::size_t>(length));
+		for (rapidjson::SizeType i = 0; i < count; ++i) {
+			const uint64_t bits = detail::PackedNumber<T>::ToBits(vals[i]);
+			for (std::size_t b = 0; b < sizeof(T); ++b) {
+				m_output[pos++] = static_cast<char>(static_cast<unsigned char>(bits >> (8 * b)));
+			}
+		}
+		return true;
+	}
+
+	//! Whether the root value is complete
+	bool IsComplete() const { return m_stack.empty() && !m_output.empty(); }
+
+protected:
+	// Container being written. count is the count of elements, or members of object
+	struct Level {
+		std::size_t headerPos;
+		uint32_t count;
+		bool isObject;
+	};
+	static const std::size_t kMaxHeaderSize = 5;
+
+	void BeginValue()
+	{
+		if (!m_stack.empty() && !m_stack.back().isObject) {
+			++m_stack.back().count;
+		}
+	}
+
+	void StartContainer(bool isObject)
+	{
+		Level level;
+		level.headerPos = m_output.size();
+		level.count = 0;
+		level.isObject = isObject;
+		m_stack.push_back(level);
+		m_output.append(kMaxHeaderSize, '\0');
+	}
+
+	bool EndContainer(bool isObject)
+	{
+		if (m_stack.empty() || m_stack.back().isObject != isObject) {
+			return false;
+		}
+		const Level level = m_stack.back();
+		m_stack.pop_back();
+
+		unsigned char header[kMaxHeaderSize];
+		std::size_t headerSize;
+		if (level.count < 16u) {
+			header[0] = static_cast<unsigned char>((isObject ? 0x80 : 0x90) | level.count);
+			headerSize = 1;
+		}
+		else if (level.count <= 0xffffu) {
+			header[0] = static_cast<unsigned char>(isObject ? 0xde : 0xdc);
+			header[1] = static_cast<unsigned char>(level.count >> 8);
+			header[2] = static_cast<unsigned char>(level.count);
+			headerSize = 3;
+		}
+		else {
+			header[0] = static_cast<unsigned char>(isObject ? 0xdf : 0xdd);
+			for (int i = 0; i < 4; ++i) {
+				header[1 + i] = static_cast<unsigned char>(level.count >> (8 * (3 - i)));
+			}
+			headerSize = 5;
+		}
+
+		for (std::size_t i = 0; i < headerSize; ++i) {
+			m_output[level.headerPos + i] = static_cast<char>(header[i]);
+		}
+		if (headerSize < kMaxHeaderSize) {
+			m_output.erase(level.headerPos + headerSize, kMaxHeaderSize - headerSize);
+		}
+		return true;
+	}
+
+	void PutStr(const Ch* str, rapidjson::SizeType length)
+	{
+		if (length < 32u) {
+			Put(static_cast<unsigned char>(0xa0 | length));
+		}
+		else if (length <= 0xffu) {
+			Put(0xd9);
+			PutBigEndian(length, 1);
+		}
+		else if (length <= 0xffffu) {
+			Put(0xda);
+			PutBigEndian(length, 2);
+		}
+		else {
+			Put(0xdb);
+			PutBigEndian(length, 4);
+		}
+		m_output.append(str, length);
+	}
+
+	void Put(unsigned char c) { m_output.push_back(static_cast<char>(c)); }
+
+	void PutBigEndian(uint64_t val, int bytes)
+	{
+		for (int i = bytes - 1; i >= 0; --i) {
+			Put(static_cast<unsigned char>(val >> (8 * i)));
+		}
+	}
+
+	std::string& m_output;
+
+private:
+	std::vector<Level> m_stack;
+};
+
+//! Read big endian integer, return false when error
+#define IJSTI_MSGPACK_READ(val, bytes)		if (!Read((val), (bytes))) { return false; }
+
+/**
+ * @brief Reader of MessagePack, which generates SAX events of rapidjson::Handler concept.
+ *
+ * Integers are reported as Uint()/Uint64() if they are not negative, Int()/Int64() else,
+ * floats are reported as Double(), and str as String() or Key(). Keys of map must be str.
+ * Ext values of MsgPackExt::kPacked* types are reported as arrays, other ext types and bin are not supported.
+ *
+ * It could be used as the generator of rapidjson::GenericDocument::Populate().
+ *
+ * @note Only UTF-8 is supported.
+ */
+class MsgPackReader {
+public:
+	MsgPackReader(const char* data, std::size_t length)
+			: m_begin(reinterpret_cast<const unsigned char*>(data))
+			  , m_cur(m_begin)
+			  , m_end(m_begin + length)
+	{ }
+
+	/**
+	 * @brief Parse the data and generate events to handler
+	 *
+	 * @param handler	handler of rapidjson::Handler concept
+	 * @return			parse result. The offset is the position of error in data.
+	 */
+	template<typename Handler>
+	rapidjson::ParseResult Parse(Handler& handler)
+	{
+		m_cur = m_begin;
+		m_result.Clear();
+		if (m_cur == m_end) {
+			m_result.Set(rapidjson::kParseErrorDocumentEmpty, 0);
+		}
+		else if (ParseValue(handler) && m_cur != m_end) {
+			m_result.Set(rapidjson::kParseErrorDocumentRootNotSingular, Offset());
+		}
+		return m_result;
+	}
+
+	//! Generator interface of rapidjson::GenericDocument::Populate()
+	template<typename Handler>
+	bool operator()(Handler& handler)
+	{
+		return !Parse(handler).IsError();
+	}
+
+	//! Whether the last parsing failed
+	bool HasParseError() const { return m_result.IsError(); }
+	//! Error code of the last parsing
+	rapidjson::ParseErrorCode GetParseError() const { return m_result.Code(); }
+	//! Position of error in data
+	std::size_t GetErrorOffset() const { return m_result.Offset(); }
+
+protected:
+	template<typename Handler>
+	bool ParseValue(Handler& handler)
+	{
+		const std::size_t valueOffset = Offset();
+		if (m_cur == m_end) {
+			return Fail(rapidjson::kParseErrorValueInvalid, valueOffset);
+		}
+		const unsigned char c = *m_cur++;
+
+		bool handlerRet;
+		uint64_t u;
+		if (c <= 0x7f) {
+			handlerRet = handler.Uint(c);
+		}
+		else if (c >= 0xe0) {
+			handlerRet = handler.Int(static_cast<int>(c) - 0x100);
+		}
+		else if ((c & 0xe0) == 0xa0) {
+			return ParseStr(handler, c & 0x1f, false, valueOffset);
+		}
+		else if ((c & 0xf0) == 0x90) {
+			return ParseArray(handler, c & 0x0f, valueOffset);
+		}
+		else if ((c & 0xf0) == 0x80) {
+			return ParseMap(handler, c & 0x0f, valueOffset);
+		}
+		else {
+			switch (c) {
+				case 0xc0: handlerRet = handler.Null(); break;
+				case 0xc2: handlerRet = handler.Bool(false); break;
+				case 0xc3: handlerRet = handler.Bool(true); break;
+				case 0xca:
+				{
+					IJSTI_MSGPACK_READ(u, 4);
+					const uint32_t bits = static_cast<uint32_t>(u);
+					float f;
+					std::memcpy(&f, &bits, sizeof(f));
+					handlerRet = handler.Double(f);
+					break;
+				}
+				case 0xcb:
+				{
+					IJSTI_MSGPACK_READ(u, 8);
+					double d;
+					std::memcpy(&d, &u, sizeof(d));
+					handlerRet = handler.Double(d);
+					break;
+				}
+				case 0xcc: IJSTI_MSGPACK_READ(u, 1); handlerRet = handler.Uint(static_cast<unsigned>(u)); break;
+				case 0xcd: IJSTI_MSGPACK_READ(u, 2); handlerRet = handler.Uint(static_cast<unsigned>(u)); break;
+				case 0xce: IJSTI_MSGPACK_READ(u, 4); handlerRet = handler.Uint(static_cast<unsigned>(u)); break;
+				case 0xcf: IJSTI_MSGPACK_READ(u, 8); handlerRet = Unsigned(handler, u); break;
+				case 0xd0: IJSTI_MSGPACK_READ(u, 1); handlerRet = handler.Int(static_cast<int8_t>(u)); break;
+				case 0xd1: IJSTI_MSGPACK_READ(u, 2); handlerRet = handler.Int(static_cast<int16_t>(u)); break;
+				case 0xd2: IJSTI_MSGPACK_READ(u, 4); handlerRet = handler.Int(static_cast<int32_t>(u)); break;
+				case 0xd3: IJSTI_MSGPACK_READ(u, 8); handlerRet = Signed(handler, static_cast<int64_t>(u)); break;
+				case 0xd9: IJSTI_MSGPACK_READ(u, 1); return ParseStr(handler, u, false, valueOffset);
+				case 0xda: IJSTI_MSGPACK_READ(u, 2); return ParseStr(handler, u, false, valueOffset);
+				case 0xdb: IJSTI_MSGPACK_READ(u, 4); return ParseStr(handler, u, false, valueOffset);
+				case 0xdc: IJSTI_MSGPACK_READ(u, 2); return ParseArray(handler, u, valueOffset);
+				case 0xdd: IJSTI_MSGPACK_READ(u, 4); return ParseArray(handler, u, valueOffset);
+				case 0xde: IJSTI_MSGPACK_READ(u, 2); return ParseMap(handler, u, valueOffset);
+				case 0xdf: IJSTI_MSGPACK_READ(u, 4); return ParseMap(handler, u, valueOffset);
+				case 0xc7: IJSTI_MSGPACK_READ(u, 1); return ParseExt(handler, u, valueOffset);
+				case 0xc8: IJSTI_MSGPACK_READ(u, 2); return ParseExt(handler, u, valueOffset);
+				case 0xc9: IJSTI_MSGPACK_READ(u, 4); return ParseExt(handler, u, valueOffset);
+				default:
+					// bin, fixext, and never used
+					return Fail(rapidjson::kParseErrorValueInvalid, valueOffset);
+			}
+		}
+		return handlerRet ? true : Fail(rapidjson::kParseErrorTermination, valueOffset);
+	}
+
+	template<typename Handler>
+	bool ParseExt(Handler& handler, uint64_t length, std::size_t valueOffset)
+	{
+		uint64_t type;
+		IJSTI_MSGPACK_READ(type, 1);
+		if (static_cast<uint64_t>(m_end - m_cur) < length) {
+			return Fail(rapidjson::kParseErrorValueInvalid, valueOffset);
+		}
+		switch (type) {
+			case MsgPackExt::kPackedInt: return ParsePacked<int>(handler, length, valueOffset);
+			case MsgPackExt::kPackedUint: return ParsePacked<unsigned>(handler, length, valueOffset);
+			case MsgPackExt::kPackedInt64: return ParsePacked<int64_t>(handler, length, valueOffset);
+			case MsgPackExt::kPackedUint64: return ParsePacked<uint64_t>(handler, length, valueOffset);
+			case MsgPackExt::kPackedDouble: return ParsePacked<double>(handler, length, valueOffset);
+			default: return Fail(rapidjson::kParseErrorValueInvalid, valueOffset);
+		}
+	}
+
+	//! Report packed array as array. The length of data has been checked
+	template<typename T, typename Handler>
+	bool ParsePacked(Handler& handler, uint64_t length, std::size_t valueOffset)
+	{
+		if (length % sizeof(T) != 0) {
+			return Fail(rapidjson::kParseErrorValueInvalid, valueOffset);
+		}
+		const rapidjson::SizeType count = static_cast<rapidjson::SizeType>(length / sizeof(T));
+		if (!handler.StartArray()) {
+			return Fail(rapidjson::kParseErrorTermination, valueOffset);
+		}
+		for (rapidjson::SizeType i = 0; i < count; ++i) {
+			uint64_t bits = 0;
+			for (std::size_t b = 0; b < sizeof(T); ++b) {
+				bits |= static_cast<uint64_t>(m_cur[b]) << (8 * b);
+			}
+			m_cur += sizeof(T);
+			if (!Number(handler, detail::PackedNumber<T>::FromBits(bits))) {
+				return Fail(rapidjson::kParseErrorTermination, valueOffset);
+			}
+		}
+		if (!handler.EndArray(count)) {
+			return Fail(rapidjson::kParseErrorTermination, Offset());
+		}
+		return true;
+	}
+
+	template<typename Handler>
+	static bool Number(Handler& handler, int i) { return handler.Int(i); }
+	template<typename Handler>
+	static bool Number(Handler& handler, unsigned u) { return handler.Uint(u); }
+	template<typename Handler>
+	static bool Number(Handler& handler, int64_t i) { return Signed(handler, i); }
+	template<typename Handler>
+	static bool Number(Handler& handler, uint64_t u) { return Unsigned(handler, u); }
+	template<typename Handler>
+	static bool Number(Handler& handler, double d) { return handler.Double(d); }
+
+	template<typename Handler>
+	bool ParseStr(Handler& handler, uint64_t length, bool isKey, std::size_t valueOffset)
+	{
+		if (static_cast<uint64_t>(m_end - m_cur) < length) {
+			return Fail(rapidjson::kParseErrorValueInvalid, valueOffset);
+		}
+		const char* str = reinterpret_cast<const char*>(m_cur);
+		const rapidjson::SizeType len = static_cast<rapidjson::SizeType>(length);
+		m_cur += length;
+		const bool handlerRet = isKey ? handler.Key(str, len, true) : handler.String(str, len, true);
+		return handlerRet ? true : Fail(rapidjson::kParseErrorTermination, valueOffset);
+	}
+
+	template<typename Handler>
+	bool ParseArray(Handler& handler, uint64_t count, std::size_t valueOffset)
+	{
+		if (!handler.StartArray()) {
+			return Fail(rapidjson::kParseErrorTermination, valueOffset);
+		}
+		for (uint64_t i = 0; i < count; ++i) {
+			if (!ParseValue(handler)) {
+				return false;
+			}
+		}
+		if (!handler.EndArray(static_cast<rapidjson::SizeType>(count))) {
+			return Fail(rapidjson::kParseErrorTermination, Offset());
+		}
+		return true;
+	}
+
+	template<typename Handler>
+	bool ParseMap(Handler& handler, uint64_t count, std::size_t valueOffset)
+	{
+		if (!handler.StartObject()) {
+			return Fail(rapidjson::kParseErrorTermination, valueOffset);
+		}
+		for (uint64_t i = 0; i < count; ++i) {
+			if (!ParseKey(handler) || !ParseValue(handler)) {
+				return false;
+			}
+		}
+		if (!handler.EndObject(static_cast<rapidjson::SizeType>(count))) {
+			return Fail(rapidjson::kParseErrorTermination, Offset());
+		}
+		return true;
+	}
+
+	template<typename Handler>
+	bool ParseKey(Handler& handler)
+	{
+		const std::size_t keyOffset = Offset();
+		if (m_cur == m_end) {
+			return Fail(rapidjson::kParseErrorObjectMissName, keyOffset);
+		}
+		const unsigned char c = *m_cur++;
+		uint64_t u;
+		if ((c & 0xe0) == 0xa0) {
+			return ParseStr(handler, c & 0x1f, true, keyOffset);
+		}
+		switch (c) {
+			case 0xd9: IJSTI_MSGPACK_READ(u, 1); return ParseStr(handler, u, true, keyOffset);
+			case 0xda: IJSTI_MSGPACK_READ(u, 2); return ParseStr(handler, u, true, keyOffset);
+			case 0xdb: IJSTI_MSGPACK_READ(u, 4); return ParseStr(handler, u, true, keyOffset);
+			default: return Fail(rapidjson::kParseErrorObjectMissName, keyOffset);
+		}
+	}
+
+	template<typename Handler>
+	static bool Unsigned(Handler& handler, uint64_t u)
+	{
+		return u <= 0xffffffffu ? handler.Uint(static_cast<unsigned>(u)) : handler.Uint64(u);
+	}
+
+	template<typename Handler>
+	static bool Signed(Handler& handler, int64_t i)
+	{
+		if (i >= 0) {
+			return Unsigned(handler, static_cast<uint64_t>(i));
+		}
+		return i >= -2147483647 - 1 ? handler.Int(static_cast<int>(i)) : handler.Int64(i);
+	}
+
+	//! Read big endian integer with bytes
+	bool Read(uint64_t& val, int bytes)
+	{
+		if (m_end - m_cur < bytes) {
+			return Fail(rapidjson::kParseErrorValueInvalid, Offset());
+		}
+		val = 0;
+		for (int i = 0; i < bytes; ++i) {
+			val = (val << 8) | *m_cur++;
+		}
+		return true;
+	}
+
+	bool Fail(rapidjson::ParseErrorCode code, std::size_t offset)
+	{
+		if (!m_result.IsError()) {
+			m_result.Set(code, offset);
+		}
+		return false;
+	}
+
+	std::size_t Offset() const { return static_cast<std::size_t>(m_cur - m_begin); }
+
+	const unsigned char* m_begin;
+	const unsigned char* m_cur;
+	const unsigned char* m_end;
+	rapidjson::ParseResult m_result;
+};
+
+/**
+ * @brief Writer of the schema-indexed binary encoding, see SerializeBinary().
+ *
+ * Values are written as MessagePack, besides the varint and fixed size integers of the record structure.
+ */
+class SchemaBinaryWriter : public MsgPackWriter {
+public:
+	//! Construct with output buffer. The output is appended to the buffer
+	explicit SchemaBinaryWriter(std::string& output) : MsgPackWriter(output) {}
+
+	//! Write unsigned LEB128 varint
+	void Varint(uint64_t val)
+	{
+		while (val >= 0x80u) {
+			Put(static_cast<unsigned char>(val | 0x80u));
+			val >>= 7;
+		}
+		Put(static_cast<unsigned char>(val));
+	}
+
+	//! Write 8 bytes in little endian
+	void Fixed64(uint64_t val)
+	{
+		for (int i = 0; i < 8; ++i) {
+			Put(static_cast<unsigned char>(val >> (8 * i)));
+		}
+	}
+
+	//! Write raw bytes
+	void Raw(const char* data, std::size_t length) { m_output.append(data, length); }
+};
+
+/**
+ * @brief Reader of the schema-indexed binary encoding, see DeserializeBinary().
+ *
+ * Methods return false and set the parse error when data is invalid.
+ */
+class SchemaBinaryReader : public MsgPackReader {
+public:
+	SchemaBinaryReader(const char* data, std::size_t length) : MsgPackReader(data, length) { }
+
+	//! Parse a MessagePack value at current position and generate events to handler
+	using MsgPackReader::ParseValue;
+
+	//! Read unsigned LEB128 varint
+	bool Varint(IJST_OUT uint64_t& val)
+	{
+		const std::size_t offset = Offset();
+		val = 0;
+		for (int shift = 0; shift < 64; shift += 7) {
+			if (m_cur == m_end) {
+				break;
+			}
+			const unsigned char c = *m_cur++;
+			val |= static_cast<uint64_t>(c & 0x7fu) << shift;
+			if ((c & 0x80u) == 0) {
+				return true;
+			}
+		}
+		return Fail(rapidjson::kParseErrorValueInvalid, offset);
+	}
+
+	//! Read 8 bytes in little endian
+	bool Fixed64(IJST_OUT uint64_t& val)
+	{
+		if (m_end - m_cur < 8) {
+			return Fail(rapidjson::kParseErrorValueInvalid, Offset());
+		}
+		val = 0;
+		for (int i = 0; i < 8; ++i) {
+			val |= static_cast<uint64_t>(*m_cur++) << (8 * i);
+		}
+		return true;
+	}
+
+	//! Read raw bytes. The output points into data
+	bool Raw(std::size_t length, IJST_OUT const char*& pOut)
+	{
+		if (static_cast<std::size_t>(m_end - m_cur) < length) {
+			return Fail(rapidjson::kParseErrorValueInvalid, Offset());
+		}
+		pOut = reinterpret_cast<const char*>(m_cur);
+		m_cur += length;
+		return true;
+	}
+
+	//! Set error at current position, always return false
+	bool SetError(rapidjson::ParseErrorCode code) { return Fail(code, Offset()); }
+
+	//! Whether all data is read
+	bool IsEnd() const { return m_cur == m_end; }
+};
+
+namespace detail {
+
+/**
+ * HandlerWrapper which writes arrays of numbers by Handler::PackedArray(), such as MsgPackWriter::PackedArray()
+ * @tparam Handler		rapidjson::Handler with method template<typename T> bool PackedArray(const T*, SizeType)
+ */
+template<typename Handler>
+class PackedArrayHandlerWrapper : public HandlerWrapper<Handler>
+{
+public:
+	explicit PackedArrayHandlerWrapper(Handler& _h) : HandlerWrapper<Handler>(_h) {}
+
+	bool IntArray(const int* vals, rapidjson::SizeType count) IJSTI_OVERRIDE
+	{ return this->h.PackedArray(vals, count); }
+	bool UintArray(const unsigned* vals, rapidjson::SizeType count) IJSTI_OVERRIDE
+	{ return this->h.PackedArray(vals, count); }
+	bool Int64Array(const int64_t* vals, rapidjson::SizeType count) IJSTI_OVERRIDE
+	{ return this->h.PackedArray(vals, count); }
+	bool Uint64Array(const uint64_t* vals, rapidjson::SizeType count) IJSTI_OVERRIDE
+	{ return this->h.PackedArray(vals, count); }
+	bool DoubleArray(const double* vals, rapidjson::SizeType count) IJSTI_OVERRIDE
+	{ return this->h.PackedArray(vals, count); }
+};
+
+/**
+ * Implementation of (de)serializing Accessor from MessagePack and the schema-indexed binary encoding,
+ * which is a friend of Accessor.
+ *
+ * @tparam Encoding		encoding of Accessor
+ */
+template<typename Encoding>
+class MsgPackCodec {
+public:
+	typedef Accessor<Encoding> TAccessor;
+	typedef rapidjson::GenericDocument<Encoding> TDocument;
+	typedef rapidjson::GenericValue<Encoding> TValue;
+	typedef MetaFieldInfo<typename Encoding::Ch> TMetaFieldInfo;
+	typedef typename TAccessor::FromJsonParam FromJsonParam;
+
+	static int SerializeMsgPack(const TAccessor& accessor, IJST_OUT std::string& output, SerFlag::Flag serFlag)
+	{
+		IJSTI_STATIC_ASSERT(sizeof(typename Encoding::Ch) == 1, "Only UTF-8 struct could be serialized to MessagePack");
+		output.clear();
+		MsgPackWriter writer(output);
+		HandlerWrapper<MsgPackWriter> writerWrapper(writer);
+		return accessor.Serialize(writerWrapper, serFlag);
+	}
+
+	static int DeserializeMsgPack(TAccessor& accessor, const char* data, std::size_t length,
+								  DeserFlag::Flag deserFlag, TDocument* pErrDocOut)
+	{
+		IJSTI_STATIC_ASSERT(sizeof(typename Encoding::Ch) == 1, "Only UTF-8 struct could be deserialized from MessagePack");
+		accessor.ResetAllocator();
+		MsgPackReader reader(data, length);
+
+		if (detail::Util::IsBitSet(deserFlag, DeserFlag::kNoIntermediateDoc)) {
+			detail::ErrorDocSetter<Encoding> errDoc(pErrDocOut);
+			detail::FromSAXHandler<Encoding> handler(deserFlag, errDoc);
+			handler.PushValue(&IJSTI_FSERIALIZER_INS(TAccessor, Encoding), &accessor, FDesc::NoneFlag, accessor.GetAllocator());
+			const rapidjson::ParseResult parseRet = reader.Parse(handler);
+			// Error in handler will stop parsing
+			IJSTI_RET_WHEN_NOT_ZERO(handler.GetRet());
+			if (parseRet.IsError()) {
+				errDoc.ParseFailed(parseRet.Code());
+				return ErrorCode::kDeserializeParseFailed;
+			}
+			return 0;
+		}
+
+		// Strings are copied to the allocator, so the doc could always be moved
+		TDocument doc(&accessor.GetAllocator());
+		doc.Populate(reader);
+		IJSTI_RET_WHEN_PARSE_ERROR(reader, Encoding);
+		return accessor.template DoFromJsonWrap<TValue>(&TAccessor::DoMoveFromJson, doc, deserFlag, pErrDocOut);
+	}
+
+	static int SerializeBinary(const TAccessor& accessor, IJST_OUT std::string& output, SerFlag::Flag serFlag)
+	{
+		IJSTI_STATIC_ASSERT(sizeof(typename Encoding::Ch) == 1, "Only UTF-8 struct could be serialized to binary");
+		output.clear();
+		SchemaBinaryWriter writer(output);
+		return DoSerializeBinary(accessor, writer, serFlag);
+	}
+
+	static int DeserializeBinary(TAccessor& accessor, const char* data, std::size_t length,
+								 DeserFlag::Flag deserFlag, TDocument* pErrDocOut)
+	{
+		IJSTI_STATIC_ASSERT(sizeof(typename Encoding::Ch) == 1, "Only UTF-8 struct could be deserialized from binary");
+		accessor.ResetAllocator();
+		SchemaBinaryReader reader(data, length);
+		detail::ErrorDocSetter<Encoding> errDoc(pErrDocOut);
+		detail::FromSAXHandler<Encoding> handler(deserFlag, errDoc);
+		FromJsonParam param(deserFlag, errDoc);
+
+		int ret = DoFromBinary(accessor, reader, handler, param);
+		if (ret == 0 && !reader.IsEnd()) {
+			reader.SetError(rapidjson::kParseErrorDocumentRootNotSingular);
+			ret = ErrorCode::kDeserializeParseFailed;
+		}
+		if (ret == ErrorCode::kDeserializeParseFailed && reader.HasParseError()) {
+			errDoc.ParseFailed(reader.GetParseError());
+		}
+		return ret;
+	}
+
+private:
+	static int DoSerializeBinary(const TAccessor& accessor, SchemaBinaryWriter& writer, SerFlag::Flag serFlag)
+	{
+		detail::PackedArrayHandlerWrapper<SchemaBinaryWriter> writerWrapper(writer);
+		const detail::FieldSerializerByFunc<Encoding> fieldSerializer(*accessor.m_r.pMetaClass);
+
+		const std::vector<TMetaFieldInfo>& fieldsInfo = accessor.m_r.pMetaClass->GetFieldsInfo();
+
+		writer.Fixed64(accessor.m_r.pMetaClass->GetSchemaFingerprint());
+		for (typename std::vector<TMetaFieldInfo>::const_iterator
+					 itMetaField = fieldsInfo.begin(), itEnd = fieldsInfo.end();
+			 itMetaField != itEnd; ++itMetaField)
+		{
+			// Check field state as DoSerializeFields()
+			bool isNull = false;
+			switch (accessor.GetFieldStatus(static_cast<size_t>(itMetaField->index))) {
+				case FStatus::kMissing:
+					if (detail::Util::IsBitSet(serFlag, SerFlag::kIgnoreMissing)) {
+						continue;
+					}
+					break;
+				case FStatus::kValid:
+					break;
+				case FStatus::kNull:
+					if (detail::Util::IsBitSet(serFlag, SerFlag::kIgnoreNull)) {
+						continue;
+					}
+					isNull = true;
+					break;
+				case FStatus::kNotAField:
+				default:
+					// Error occurs
+					assert(false);
+					return ErrorCode::kInnerError;
+			}
+
+			writer.Varint((static_cast<uint64_t>(itMetaField->index) + 1) * 2 + (isNull ? 1 : 0));
+			if (isNull) {
+				continue;
+			}
+			void *pFieldValue = const_cast<void*>(accessor.GetFieldByOffset(itMetaField->offset));
+			const TAccessor* pChild = detail::GetSerializerInterface<Encoding>(*itMetaField)->GetAccessor(pFieldValue);
+			if (pChild != NULL) {
+				IJSTI_RET_WHEN_NOT_ZERO(DoSerializeBinary(*pChild, writer, serFlag));
+			}
+			else {
+				IJSTI_RET_WHEN_NOT_ZERO(
+						fieldSerializer.Serialize(*itMetaField, pFieldValue, writerWrapper, serFlag));
+			}
+		}
+		writer.Varint(0);
+
+		// Unknown members as json
+		if (detail::Util::IsBitSet(serFlag, SerFlag::kIgnoreUnknown) || accessor.m_r.unknown.ObjectEmpty()) {
+			writer.Varint(0);
+			return 0;
+		}
+		typedef rapidjson::GenericStringBuffer<Encoding> TStringBuffer;
+		TStringBuffer buffer;
+		rapidjson::Writer<TStringBuffer, Encoding, Encoding> jsonWriter(buffer);
+		IJSTI_RET_WHEN_WRITE_FAILD(accessor.m_r.unknown.Accept(jsonWriter));
+		writer.Varint(buffer.GetSize());
+		writer.Raw(buffer.GetString(), buffer.GetSize());
+		return 0;
+	}
+
+	//! Deserialize a record of binary encoding. Values of fields which are not ijst struct are routed by handler
+	static int DoFromBinary(TAccessor& accessor, SchemaBinaryReader& reader, detail::FromSAXHandler<Encoding>& handler,
+							FromJsonParam& p)
+	{
+		uint64_t fingerprint;
+		if (!reader.Fixed64(fingerprint)) {
+			return ErrorCode::kDeserializeParseFailed;
+		}
+		if (fingerprint != accessor.m_r.pMetaClass->GetSchemaFingerprint()) {
+			p.errDoc.SchemaMismatch(accessor.m_r.pMetaClass->GetClassName());
+			return ErrorCode::kDeserializeSchemaMismatch;
+		}
+
+		accessor.m_r.unknown.SetObject();
+		const std::vector<TMetaFieldInfo>& fieldsInfo = accessor.m_r.pMetaClass->GetFieldsInfo();
+		while (true) {
+			uint64_t key;
+			if (!reader.Varint(key)) {
+				return ErrorCode::kDeserializeParseFailed;
+			}
+			if (key == 0) {
+				break;
+			}
+			const uint64_t index = key / 2 - 1;
+			if (key < 2 || index >= fieldsInfo.size()) {
+				reader.SetError(rapidjson::kParseErrorValueInvalid);
+				return ErrorCode::kDeserializeParseFailed;
+			}
+			const TMetaFieldInfo* pMetaField = &fieldsInfo[static_cast<size_t>(index)];
+
+			if (key % 2 != 0) {
+				if (!detail::Util::IsBitSet(pMetaField->desc, FDesc::Nullable)) {
+					reader.SetError(rapidjson::kParseErrorValueInvalid);
+					return ErrorCode::kDeserializeParseFailed;
+				}
+				accessor.SetFieldStatus(static_cast<size_t>(pMetaField->index), FStatus::kNull);
+				continue;
+			}
+
+			void *pField = accessor.GetFieldByOffset(pMetaField->offset);
+			detail::SerializerInterface<Encoding>* pIntf = detail::GetSerializerInterface<Encoding>(*pMetaField);
+			TAccessor* pChild = pIntf->GetAccessor(pField);
+			int fieldRet;
+			if (pChild != NULL) {
+				pChild->ResetAllocator();
+				fieldRet = DoFromBinary(*pChild, reader, handler, p);
+			}
+			else {
+				handler.PushValue(pIntf, pField, pMetaField->desc, accessor.GetAllocator());
+				fieldRet = reader.ParseValue(handler) ? 0 : handler.GetRet();
+			}
+			if (reader.HasParseError() && handler.GetRet() == 0) {
+				// Error of data is reported by the root
+				return ErrorCode::kDeserializeParseFailed;
+			}
+			IJSTI_RET_WHEN_NOT_ZERO(accessor.DoFieldFromSAXEnd(pMetaField, fieldRet, p));
+		}
+
+		// Unknown members
+		uint64_t unknownLength;
+		const char* unknownJson;
+		if (!reader.Varint(unknownLength) || !reader.Raw(static_cast<std::size_t>(unknownLength), unknownJson)) {
+			return ErrorCode::kDeserializeParseFailed;
+		}
+		if (unknownLength != 0 && !detail::Util::IsBitSet(p.deserFlag, DeserFlag::kIgnoreUnknown)) {
+			TDocument doc(&accessor.GetAllocator());
+			doc.Parse(unknownJson, static_cast<std::size_t>(unknownLength));
+			if (doc.HasParseError() || !doc.IsObject()) {
+				reader.SetError(rapidjson::kParseErrorValueInvalid);
+				return ErrorCode::kDeserializeParseFailed;
+			}
+			if (detail::Util::IsBitSet(p.deserFlag, DeserFlag::kErrorWhenUnknown) && !doc.ObjectEmpty()) {
+				p.errDoc.UnknownMember(detail::GetJsonStr(doc.MemberBegin()->name));
+				return ErrorCode::kDeserializeSomeUnknownMember;
+			}
+			accessor.m_r.unknown = static_cast<TValue&>(doc); // move
+		}
+
+		if (!detail::Util::IsBitSet(p.deserFlag, DeserFlag::kNotCheckFieldStatus)) {
+			return accessor.CheckFieldState(p.errDoc);
+		}
+		else {
+			return 0;
+		}
+	}
+};
+
+}	// namespace detail
+
+/**
+ * @brief Serialize ijst struct to MessagePack.
+ *
+ * @tparam T 			ijst struct
+ *
+ * @param st 			ijst struct instance
+ * @param output 		The output of result
+ * @param serFlag 		Serialization options about fields, options can be combined by bitwise OR operator (|)
+ * @return				Error code
+ *
+ * @note Only UTF-8 struct is supported
+ * @see MsgPackWriter
+ */
+template<typename T>
+inline int SerializeMsgPack(const T& st, IJST_OUT std::string& output, SerFlag::Flag serFlag = SerFlag::kNoneFlag)
+{
+	return detail::MsgPackCodec<typename T::_ijst_Encoding>::SerializeMsgPack(st._, output, serFlag);
+}
+
+/**
+ * @brief Deserialize ijst struct from MessagePack.
+ *
+ * Events of MessagePack data are routed as parsing json, so DeserFlag options work the same way.
+ *
+ * @tparam T 				ijst struct
+ *
+ * @param st 				ijst struct instance
+ * @param data				MessagePack data
+ * @param length			Length of data
+ * @param deserFlag	 		Deserialization options, options can be combined by bitwise OR operator (|)
+ * @param pErrDocOut		Error message output. Null if do not need error message
+ * @return					Error code
+ *
+ * @note It will free own allocator of st
+ * @note Only UTF-8 struct is supported
+ * @see MsgPackReader
+ */
+template<typename T>
+inline int DeserializeMsgPack(T& st, const char* data, std::size_t length,
+							  DeserFlag::Flag deserFlag = DeserFlag::kNoneFlag,
+							  rapidjson::GenericDocument<typename T::_ijst_Encoding>* pErrDocOut = NULL)
+{
+	return detail::MsgPackCodec<typename T::_ijst_Encoding>::DeserializeMsgPack(st._, data, length, deserFlag, pErrDocOut);
+}
+
+/**
+ * @brief Serialize ijst struct to the schema-indexed binary encoding.
+ *
+ * Fields are written as the varint of index and the value, instead of json name and value. The format is:
+ * - record:	fingerprint of schema (8 bytes, little endian), fields, varint 0, unknown
+ * - field:		varint of ((index + 1) * 2 + isNull), and value if the field is not null
+ * - value:		record if the field is an ijst struct, MessagePack else.
+ * 				Arrays of numbers are written as ext values of MsgPackExt::kPacked*
+ * - unknown:	varint of length, and the json text of unknown members. The length is 0 if there is none
+ *
+ * Varints are unsigned LEB128. The fingerprint is MetaClassInfo::GetSchemaFingerprint(),
+ * so peers must compile the same definition of struct.
+ *
+ * @tparam T 			ijst struct
+ *
+ * @param st 			ijst struct instance
+ * @param output 		The output of result
+ * @param serFlag 		Serialization options about fields, options can be combined by bitwise OR operator (|)
+ * @return				Error code
+ *
+ * @note Only UTF-8 struct is supported
+ * @note ijst structs inside containers are written as MessagePack maps with json names
+ */
+template<typename T>
+inline int SerializeBinary(const T& st, IJST_OUT std::string& output, SerFlag::Flag serFlag = SerFlag::kNoneFlag)
+{
+	return detail::MsgPackCodec<typename T::_ijst_Encoding>::SerializeBinary(st._, output, serFlag);
+}
+
+/**
+ * @brief Deserialize ijst struct from the schema-indexed binary encoding.
+ *
+ * Fields are located by index without looking up json name. Returns ErrorCode::kDeserializeSchemaMismatch
+ * if the fingerprint of a record is not the one of struct.
+ *
+ * @tparam T 				ijst struct
+ *
+ * @param st 				ijst struct instance
+ * @param data				binary data written by SerializeBinary()
+ * @param length			Length of data
+ * @param deserFlag	 		Deserialization options, options can be combined by bitwise OR operator (|)
+ * @param pErrDocOut		Error message output. Null if do not need error message
+ * @return					Error code
+ *
+ * @note It will free own allocator of st
+ * @note Only UTF-8 struct is supported
+ * @see SerializeBinary()
+ */
+template<typename T>
+inline int DeserializeBinary(T& st, const char* data, std::size_t length,
+							 DeserFlag::Flag deserFlag = DeserFlag::kNoneFlag,
+							 rapidjson::GenericDocument<typename T::_ijst_Encoding>* pErrDocOut = NULL)
+{
+	return detail::MsgPackCodec<typename T::_ijst_Encoding>::DeserializeBinary(st._, data, length, deserFlag, pErrDocOut);
+}
+
+}	// namespace ijst
+
+#endif //IJST_MSGPACK_HPP_INCLUDE_
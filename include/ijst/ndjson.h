@@ -0,0 +1,298 @@
+/**************************************************************************************************
+ *		Newline-delimited JSON (NDJSON) reader and writer. Requires C++11
+ **************************************************************************************************/
+
+#ifndef IJST_NDJSON_HPP_INCLUDE_
+#define IJST_NDJSON_HPP_INCLUDE_
+
+#include "ijst.h"
+#include "accessor.h"
+#include "parallel.h"
+
+#include <cstring>		// memchr
+#include <algorithm>	// std::find
+#include <iterator>		// std::iterator_traits
+#include <memory>		// std::unique_ptr
+#include <vector>
+
+/**
+ * @ingroup IJST_CONFIG
+ *
+ *  Input of DeserializeNdjson() is split into chunks whose size is at least IJST_NDJSON_MIN_CHUNK_SIZE bytes
+ *  (except the last one), so small input will not be dispatched to many threads. Default is 64KB.
+ *	User can override it by defining IJST_NDJSON_MIN_CHUNK_SIZE macro.
+ */
+#ifndef IJST_NDJSON_MIN_CHUNK_SIZE
+	#define IJST_NDJSON_MIN_CHUNK_SIZE (64 * 1024)
+#endif
+
+/**
+ * @ingroup IJST_CONFIG
+ *
+ *  Each worker of DeserializeNdjson() parses lines into a intermediate document, whose allocator has a buffer of
+ *  IJST_NDJSON_WORKER_BUFFER_SIZE bytes. The buffer is reused by lines, lines that need more memory allocate it
+ *  from heap. Default is 64KB.
+ *  The buffer is released when the chunk of lines is done, unlike IJST_BATCH_WORKER_BUFFER_SIZE.
+ *	User can override it by defining IJST_NDJSON_WORKER_BUFFER_SIZE macro.
+ */
+#ifndef IJST_NDJSON_WORKER_BUFFER_SIZE
+	#define IJST_NDJSON_WORKER_BUFFER_SIZE (64 * 1024)
+#endif
+
+namespace ijst {
+namespace detail {
+
+inline const char* FindNewline(const char* begin, const char* end)
+{
+	const void* p = std::memchr(begin, '\n', static_cast<std::size_t>(end - begin));
+	return p == NULL ? end : static_cast<const char*>(p);
+}
+
+template<typename CharType>
+inline const CharType* FindNewline(const CharType* begin, const CharType* end)
+{
+	return std::find(begin, end, CharType('\n'));
+}
+
+template<typename CharType>
+inline bool IsBlankLine(const CharType* begin, const CharType* end)
+{
+	for (; begin != end; ++begin) {
+		if (*begin != ' ' && *begin != '\t' && *begin != '\r') {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Deserializer of a line-aligned chunk of NDJSON, which is run in its own thread.
+ *
+ * @tparam parseFlags		parseFlags of rapidjson parse method
+ * @tparam T				ijst struct
+ */
+template<unsigned parseFlags, typename T>
+class NdjsonChunkReader {
+public:
+	typedef typename T::_ijst_Ch Ch;
+
+	struct FailedLine {
+		//! Line number in chunk, starts from 1
+		std::size_t line;
+		const Ch* begin;
+		const Ch* end;
+	};
+
+	NdjsonChunkReader() : begin(NULL), end(NULL), lineCount(0), ret(0) { }
+
+	void Read(DeserFlag::Flag deserFlag)
+	{
+		ReusableDocReader<parseFlags, T> reader(IJST_NDJSON_WORKER_BUFFER_SIZE);
+		for (const Ch* p = begin; p < end; ) {
+			const Ch* const lineEnd = FindNewline(p, end);
+			++lineCount;
+			if (!IsBlankLine(p, lineEnd)) {
+				values.emplace_back();
+				const int lineRet = reader.Read(
+						values.back(), p, static_cast<std::size_t>(lineEnd - p), deserFlag, NULL);
+				if (lineRet != 0) {
+					values.pop_back();
+					if (ret == 0) {
+						ret = lineRet;
+					}
+					FailedLine failedLine = {lineCount, p, lineEnd};
+					failedLines.push_back(failedLine);
+				}
+			}
+			p = lineEnd + 1;
+		}
+	}
+
+	//! Input of chunk
+	const Ch* begin;
+	const Ch* end;
+	//! Successfully deserialized values in order
+	std::vector<T> values;
+	//! Count of lines, including blank lines
+	std::size_t lineCount;
+	//! Error code of first failed line
+	int ret;
+	std::vector<FailedLine> failedLines;
+};
+
+template<unsigned parseFlags, typename T>
+struct NdjsonReadTask {
+	void operator()(std::size_t i) { chunks[i].Read(deserFlag); }
+
+	NdjsonChunkReader<parseFlags, T>* chunks;
+	DeserFlag::Flag deserFlag;
+};
+
+}	// namespace detail
+
+/**
+ * @brief Deserialize newline-delimited JSON, each line of which is a JSON of ijst struct.
+ *
+ * The input is split into line-aligned chunks which are deserialized by worker threads,
+ * and the deserialized values are appended to output in the order of lines. Blank lines are skipped.
+ *
+ * A line which fails to be deserialized is not appended to output, and the deserialization continues.
+ * The error document is an array of errors of failed lines, each of which is in format:
+ * { "type": "ErrInLine", "line": <line number starts from 1>, "err": <error of line> }
+ *
+ * @tparam parseFlags		parseFlags of rapidjson parse method
+ * @tparam T				ijst struct
+ *
+ * @param input				Input
+ * @param length			Length of input
+ * @param output			Output, deserialized values are appended to it
+ * @param deserFlag	 		Deserialization options of each line, options can be combined by bitwise OR operator (|)
+ * @param pErrDocOut		Error message output. Null if do not need error message
+ * @param threadCount		Max count of worker threads, including the calling thread. 0 for count of CPU cores
+ * @return					Error code of the first failed line, 0 if all lines succeed
+ */
+template<unsigned parseFlags, typename T>
+inline int DeserializeNdjson(const typename T::_ijst_Ch* input, std::size_t length, IJST_OUT std::vector<T>& output,
+							 DeserFlag::Flag deserFlag = DeserFlag::kNoneFlag,
+							 rapidjson::GenericDocument<typename T::_ijst_Encoding>* pErrDocOut = NULL,
+							 unsigned threadCount = 0)
+{
+	typedef typename T::_ijst_Ch Ch;
+	typedef typename T::_ijst_Encoding Encoding;
+	typedef detail::NdjsonChunkReader<parseFlags, T> TChunkReader;
+
+	// Split input into chunks at line boundaries
+	std::size_t chunkCount = threadCount == 0 ? detail::GetDefaultThreadCount() : threadCount;
+	const std::size_t maxChunkCount = length * sizeof(Ch) / IJST_NDJSON_MIN_CHUNK_SIZE;
+	chunkCount = std::max<std::size_t>(1, std::min(chunkCount, maxChunkCount));
+	std::unique_ptr<TChunkReader[]> chunks(new TChunkReader[chunkCount]);
+	const Ch* const end = input + length;
+	const Ch* chunkBegin = input;
+	for (std::size_t i = 0; i < chunkCount; ++i) {
+		const Ch* chunkEnd = end;
+		if (i + 1 != chunkCount) {
+			chunkEnd = std::max(chunkBegin, input + length / chunkCount * (i + 1));
+			chunkEnd = detail::FindNewline(chunkEnd, end);
+			chunkEnd = chunkEnd == end ? end : chunkEnd + 1;
+		}
+		chunks[i].begin = chunkBegin;
+		chunks[i].end = chunkEnd;
+		chunkBegin = chunkEnd;
+	}
+
+	detail::NdjsonReadTask<parseFlags, T> task;
+	task.chunks = chunks.get();
+	task.deserFlag = deserFlag;
+	detail::RunInThreads(chunkCount, task);
+
+	// Append results in order
+	int ret = 0;
+	std::size_t valueCount = 0;
+	for (std::size_t i = 0; i < chunkCount; ++i) {
+		valueCount += chunks[i].values.size();
+	}
+	output.reserve(output.size() + valueCount);
+	for (std::size_t i = 0; i < chunkCount; ++i) {
+		output.insert(output.end(), std::make_move_iterator(chunks[i].values.begin()),
+					  std::make_move_iterator(chunks[i].values.end()));
+		if (ret == 0) {
+			ret = chunks[i].ret;
+		}
+	}
+
+	// Failed lines are deserialized again to generate error documents, so the error documents are allocated by
+	// allocator of pErrDocOut instead of allocators of workers
+	if (pErrDocOut != NULL) {
+		pErrDocOut->SetArray();
+		detail::ReusableDocReader<parseFlags, T> reader(IJST_NDJSON_WORKER_BUFFER_SIZE);
+		std::size_t lineOffset = 0;
+		for (std::size_t i = 0; i < chunkCount; ++i) {
+			for (std::size_t j = 0; j < chunks[i].failedLines.size(); ++j) {
+				const typename TChunkReader::FailedLine& failedLine = chunks[i].failedLines[j];
+				rapidjson::GenericDocument<Encoding> err(&pErrDocOut->GetAllocator());
+				T value;
+				reader.Read(value, failedLine.begin, static_cast<std::size_t>(failedLine.end - failedLine.begin),
+							deserFlag, &err);
+				detail::ErrorDocSetter<Encoding>(&err).ErrorInLine(lineOffset + failedLine.line);
+				pErrDocOut->PushBack(static_cast<rapidjson::GenericValue<Encoding>&>(err), pErrDocOut->GetAllocator());
+			}
+			lineOffset += chunks[i].lineCount;
+		}
+	}
+	return ret;
+}
+
+/**
+ * @brief Deserialize newline-delimited JSON, each line of which is a JSON of ijst struct.
+ *
+ * @see DeserializeNdjson<parseFlags, T>()
+ */
+template<typename T>
+inline int DeserializeNdjson(const typename T::_ijst_Ch* input, std::size_t length, IJST_OUT std::vector<T>& output,
+							 DeserFlag::Flag deserFlag = DeserFlag::kNoneFlag,
+							 rapidjson::GenericDocument<typename T::_ijst_Encoding>* pErrDocOut = NULL,
+							 unsigned threadCount = 0)
+{
+	return DeserializeNdjson<IJST_PARSE_DEFAULT_FLAGS>(input, length, output, deserFlag, pErrDocOut, threadCount);
+}
+
+/**
+ * @brief Serialize a range of ijst structs to newline-delimited JSON.
+ *
+ * All values are written by one writer to the stream, and each of them is followed by a '\n'.
+ *
+ * @tparam InputIterator	iterator of ijst struct
+ * @tparam OutputStream		rapidjson OutputStream concept
+ *
+ * @param first				Begin of range
+ * @param last				End of range
+ * @param os				Output stream, which is flushed at the end
+ * @param serFlag 			Serialization options about fields, options can be combined by bitwise OR operator (|)
+ * @return					Error code, ErrorCode::kWriteFailed if FileOutputStream or FdOutputStream fails
+ *
+ * @note Serialization stops at the first failed value
+ */
+template<typename InputIterator, typename OutputStream>
+inline int SerializeNdjsonToStream(InputIterator first, InputIterator last, OutputStream& os,
+								   SerFlag::Flag serFlag = SerFlag::kNoneFlag)
+{
+	typedef typename std::iterator_traits<InputIterator>::value_type T;
+	typedef typename T::_ijst_Encoding Encoding;
+	typedef rapidjson::Writer<OutputStream, Encoding, Encoding> TWriter;
+
+	TWriter writer(os);
+	for (; first != last; ++first) {
+		writer.Reset(os);
+		IJSTI_RET_WHEN_NOT_ZERO(Serialize(*first, writer, serFlag));
+		os.Put('\n');
+	}
+	os.Flush();
+	return detail::StreamFailChecker<OutputStream>::IsFailed(os) ? ErrorCode::kWriteFailed : 0;
+}
+
+/**
+ * @brief Serialize a range of ijst structs to newline-delimited JSON, and append the result to string.
+ *
+ * @tparam InputIterator	iterator of ijst struct
+ *
+ * @param first				Begin of range
+ * @param last				End of range
+ * @param output			The output, result is appended to it
+ * @param serFlag 			Serialization options about fields, options can be combined by bitwise OR operator (|)
+ * @return					Error code
+ *
+ * @see SerializeNdjsonToStream()
+ */
+template<typename InputIterator>
+inline int SerializeNdjson(InputIterator first, InputIterator last,
+						   IJST_OUT std::basic_string<typename std::iterator_traits<InputIterator>::value_type::_ijst_Ch>& output,
+						   SerFlag::Flag serFlag = SerFlag::kNoneFlag)
+{
+	typedef typename std::iterator_traits<InputIterator>::value_type::_ijst_Ch Ch;
+	detail::StringOutputStream<std::basic_string<Ch> > stream(output);
+	return SerializeNdjsonToStream(first, last, stream, serFlag);
+}
+
+}	// namespace ijst
+
+#endif //IJST_NDJSON_HPP_INCLUDE_
@@ -0,0 +1,387 @@
+/**************************************************************************************************
+ *		Thread pool and batch deserialization. Requires C++11
+ **************************************************************************************************/
+
+#ifndef IJST_PARALLEL_HPP_INCLUDE_
+#define IJST_PARALLEL_HPP_INCLUDE_
+
+#include "ijst.h"
+#include "accessor.h"
+#include "detail/parallel.h"
+
+#include <condition_variable>
+#include <functional>
+#include <memory>		// std::unique_ptr
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @ingroup IJST_CONFIG
+ *
+ *  Each thread of BatchDeserialize() parses inputs into a intermediate document, whose allocator has a buffer of
+ *  IJST_BATCH_WORKER_BUFFER_SIZE bytes. The buffer is reused by inputs, inputs that need more memory allocate it
+ *  from heap. Default is 64KB.
+ *  The buffer is thread-local and reused by batches, so it is kept until the thread exits, for each pair of
+ *  parseFlags and struct type the thread has deserialized. Workers of ThreadPool::GetDefault() live as long as
+ *  the process. Memory allocated beyond the buffer is released after each input.
+ *	User can override it by defining IJST_BATCH_WORKER_BUFFER_SIZE macro.
+ */
+#ifndef IJST_BATCH_WORKER_BUFFER_SIZE
+	#define IJST_BATCH_WORKER_BUFFER_SIZE (64 * 1024)
+#endif
+
+namespace ijst {
+
+/**
+ * @brief Thread pool whose workers steal tasks from each other.
+ *
+ * Tasks of a call are split into ranges, one for each worker thread and one for the calling thread.
+ * A thread takes tasks from the front of its own range, and steals half of the remaining tasks from the back of
+ * another range when its own range is exhausted, so that threads keep busy when costs of tasks are uneven.
+ *
+ * It models the executor concept of BatchDeserialize().
+ *
+ * @note Calls from different threads are serialized. Calls from a running task run the tasks in the calling thread.
+ */
+class ThreadPool {
+public:
+	typedef std::function<void(std::size_t)> Task;
+
+	/**
+	 * @brief Constructor
+	 *
+	 * @param threadCount	count of threads that run tasks, including the calling thread. 0 for count of CPU cores
+	 */
+	explicit ThreadPool(unsigned threadCount = 0)
+			: m_rangeCount(threadCount == 0 ? detail::GetDefaultThreadCount() : threadCount)
+			, m_ranges(new Range[m_rangeCount])
+			, m_pTask(NULL), m_generation(0), m_finishedCount(0), m_stop(false)
+	{
+		m_threads.reserve(m_rangeCount - 1);
+		for (unsigned i = 1; i < m_rangeCount; ++i) {
+			m_threads.push_back(std::thread(&ThreadPool::WorkerMain, this, i));
+		}
+	}
+
+	~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stop = true;
+		}
+		m_startCond.notify_all();
+		for (std::size_t i = 0; i < m_threads.size(); ++i) {
+			m_threads[i].join();
+		}
+	}
+
+	//! Count of threads that run tasks, including the calling thread
+	unsigned GetThreadCount() const { return m_rangeCount; }
+
+	/**
+	 * @brief Run task(i) for each i in [0, taskCount). Return after all tasks finished
+	 */
+	void operator()(std::size_t taskCount, const Task& task)
+	{
+		if (taskCount == 0) {
+			return;
+		}
+		if (m_threads.empty() || taskCount == 1 || detail::InParallelTask()) {
+			for (std::size_t i = 0; i < taskCount; ++i) {
+				task(i);
+			}
+			return;
+		}
+
+		std::lock_guard<std::mutex> runLock(m_runMutex);
+		// Workers are idle now
+		for (unsigned i = 0; i < m_rangeCount; ++i) {
+			m_ranges[i].begin = taskCount * i / m_rangeCount;
+			m_ranges[i].end = taskCount * (i + 1) / m_rangeCount;
+		}
+		m_pTask = &task;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_finishedCount = 0;
+			++m_generation;
+		}
+		m_startCond.notify_all();
+
+		RunTasks(0);
+
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_finishCond.wait(lock, [this]() { return m_finishedCount == m_threads.size(); });
+		m_pTask = NULL;
+	}
+
+	//! Pool shared by library, which is created at first use
+	static ThreadPool& GetDefault()
+	{
+		static ThreadPool pool;
+		return pool;
+	}
+
+private:
+	ThreadPool(const ThreadPool&) IJSTI_DELETED;
+	ThreadPool& operator=(ThreadPool) IJSTI_DELETED;
+
+	struct Range {
+		Range() : begin(0), end(0) { }
+		std::mutex mutex;
+		std::size_t begin;
+		std::size_t end;
+	};
+
+	void WorkerMain(unsigned rangeIndex)
+	{
+		unsigned long long generation = 0;
+		while (true) {
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_startCond.wait(lock, [this, generation]() { return m_stop || m_generation != generation; });
+				if (m_stop) {
+					return;
+				}
+				generation = m_generation;
+			}
+
+			RunTasks(rangeIndex);
+
+			bool allFinished;
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				allFinished = ++m_finishedCount == m_threads.size();
+			}
+			if (allFinished) {
+				m_finishCond.notify_one();
+			}
+		}
+	}
+
+	void RunTasks(unsigned rangeIndex)
+	{
+		detail::ParallelTaskScope scope;
+		std::size_t i;
+		while (PopTask(rangeIndex, i) || StealTasks(rangeIndex, i)) {
+			(*m_pTask)(i);
+		}
+	}
+
+	bool PopTask(unsigned rangeIndex, IJST_OUT std::size_t& taskOut)
+	{
+		Range& range = m_ranges[rangeIndex];
+		std::lock_guard<std::mutex> lock(range.mutex);
+		if (range.begin == range.end) {
+			return false;
+		}
+		taskOut = range.begin++;
+		return true;
+	}
+
+	//! Steal half of tasks from other range, and take the first one of them
+	bool StealTasks(unsigned rangeIndex, IJST_OUT std::size_t& taskOut)
+	{
+		for (unsigned offset = 1; offset < m_rangeCount; ++offset) {
+			Range& victim = m_ranges[(rangeIndex + offset) % m_rangeCount];
+			std::size_t begin, end;
+			{
+				std::lock_guard<std::mutex> lock(victim.mutex);
+				if (victim.begin == victim.end) {
+					continue;
+				}
+				end = victim.end;
+				victim.end -= (victim.end - victim.begin + 1) / 2;
+				begin = victim.end;
+			}
+
+			Range& range = m_ranges[rangeIndex];
+			std::lock_guard<std::mutex> lock(range.mutex);
+			range.begin = begin + 1;
+			range.end = end;
+			taskOut = begin;
+			return true;
+		}
+		return false;
+	}
+
+	const unsigned m_rangeCount;
+	std::unique_ptr<Range[]> m_ranges;
+	std::vector<std::thread> m_threads;
+	std::mutex m_runMutex;
+
+	const Task* m_pTask;
+	std::mutex m_mutex;
+	std::condition_variable m_startCond;
+	std::condition_variable m_finishCond;
+	unsigned long long m_generation;
+	std::size_t m_finishedCount;
+	bool m_stop;
+};
+
+namespace detail {
+
+/**
+ * Deserializer of ijst struct, which reuses the intermediate document and its allocator.
+ *
+ * @tparam parseFlags		parseFlags of rapidjson parse method
+ * @tparam T				ijst struct
+ */
+template<unsigned parseFlags, typename T>
+class ReusableDocReader {
+public:
+	typedef typename T::_ijst_Encoding Encoding;
+	typedef typename T::_ijst_Ch Ch;
+
+	explicit ReusableDocReader(std::size_t bufferSize)
+			: m_buffer(bufferSize)
+			, m_allocator(&m_buffer[0], m_buffer.size())
+			, m_doc(&m_allocator, 1024, &m_stackAllocator)
+	{ }
+
+	int Read(IJST_OUT T& value, const Ch* input, std::size_t length, DeserFlag::Flag deserFlag,
+			 rapidjson::GenericDocument<Encoding>* pErrDocOut)
+	{
+		// Values in document refer to allocator which is cleared for each input, so they could not be moved
+		if (Util::IsBitSet(deserFlag, DeserFlag::kNoIntermediateDoc)
+			|| Util::IsBitSet(deserFlag, DeserFlag::kMoveFromIntermediateDoc)) {
+			return value._.template Deserialize<parseFlags>(input, length, deserFlag, pErrDocOut);
+		}
+
+		m_doc.template Parse<parseFlags>(input, length);
+		int ret;
+		if (m_doc.HasParseError()) {
+			ErrorDocSetter<Encoding>(pErrDocOut).ParseFailed(m_doc.GetParseError());
+			ret = ErrorCode::kDeserializeParseFailed;
+		}
+		else {
+			ret = value._.FromJson(m_doc, deserFlag, pErrDocOut);
+		}
+		// Only the buffer is kept between inputs, chunks allocated for large input are freed
+		m_doc.SetNull();
+		m_allocator.Clear();
+		return ret;
+	}
+
+private:
+	ReusableDocReader(const ReusableDocReader&) IJSTI_DELETED;
+	ReusableDocReader& operator=(ReusableDocReader) IJSTI_DELETED;
+
+	std::vector<char> m_buffer;
+	JsonAllocator m_allocator;
+	// Stack of document will not be shrunk when its allocator is not kNeedFree
+	JsonAllocator m_stackAllocator;
+	rapidjson::GenericDocument<Encoding, JsonAllocator, JsonAllocator> m_doc;
+};
+
+/**
+ * Context of a thread in BatchDeserialize(), which is reused by batches.
+ * It lives until the thread exits, see IJST_BATCH_WORKER_BUFFER_SIZE
+ */
+template<unsigned parseFlags, typename T>
+struct BatchWorkerContext {
+	typedef typename T::_ijst_Encoding Encoding;
+
+	BatchWorkerContext() : reader(IJST_BATCH_WORKER_BUFFER_SIZE) { }
+
+	static BatchWorkerContext& Get()
+	{
+		// IJSTI_THREAD_LOCAL may be __declspec(thread) in MSVC, which does not support non-trivial type
+		static thread_local BatchWorkerContext context;
+		return context;
+	}
+
+	ReusableDocReader<parseFlags, T> reader;
+	rapidjson::GenericDocument<Encoding> errDoc;
+	rapidjson::GenericStringBuffer<Encoding> errBuffer;
+};
+
+}	// namespace detail
+
+/**
+ * @brief Deserialize a batch of inputs in parallel.
+ *
+ * Each thread has its own intermediate document and error document, which are reused by inputs and batches.
+ * They are kept by the thread after the batch, see IJST_BATCH_WORKER_BUFFER_SIZE.
+ * Singletons of meta information of T are initialized before the inputs are dispatched.
+ *
+ * @tparam parseFlags		parseFlags of rapidjson parse method
+ * @tparam Inputs			random access container of inputs, e.g., std::vector<std::string>.
+ * 							Each input has methods data() and size()
+ * @tparam T				ijst struct
+ * @tparam Executor			executor which runs tasks, e.g., ThreadPool. It is called as
+ * 							executor(std::size_t taskCount, const std::function<void(std::size_t)>& task),
+ * 							and should run task(i) for each i in [0, taskCount) then return
+ *
+ * @param inputs			Inputs
+ * @param outputs			Outputs, which is resized to size of inputs. outputs[i] is deserialized from inputs[i]
+ * @param executor			Executor
+ * @param deserFlag	 		Deserialization options, options can be combined by bitwise OR operator (|)
+ * @param pErrMsgsOut		Error messages output, which is resized to size of inputs. The error message of
+ * 							a failed input is a serialized error document, and is empty for succeed input.
+ * 							Null if do not need error message
+ * @return					Error codes of each input
+ */
+template<unsigned parseFlags, typename Inputs, typename T, typename Executor>
+inline std::vector<int> BatchDeserialize(const Inputs& inputs, IJST_OUT std::vector<T>& outputs, Executor&& executor,
+										 DeserFlag::Flag deserFlag = DeserFlag::kNoneFlag,
+										 std::vector<std::basic_string<typename T::_ijst_Ch> >* pErrMsgsOut = NULL)
+{
+	typedef typename T::_ijst_Ch Ch;
+	typedef detail::BatchWorkerContext<parseFlags, T> TContext;
+
+	InitSingletons<T>();
+
+	const std::size_t count = inputs.size();
+	std::vector<int> rets(count, 0);
+	outputs.resize(count);
+	if (pErrMsgsOut != NULL) {
+		pErrMsgsOut->assign(count, std::basic_string<Ch>());
+	}
+
+	const ThreadPool::Task task = [&](std::size_t i) {
+		TContext& context = TContext::Get();
+		const int ret = context.reader.Read(outputs[i], inputs[i].data(), inputs[i].size(), deserFlag,
+											pErrMsgsOut == NULL ? NULL : &context.errDoc);
+		rets[i] = ret;
+		if (ret != 0 && pErrMsgsOut != NULL) {
+			context.errBuffer.Clear();
+			rapidjson::Writer<rapidjson::GenericStringBuffer<typename T::_ijst_Encoding> > writer(context.errBuffer);
+			context.errDoc.Accept(writer);
+			(*pErrMsgsOut)[i].assign(context.errBuffer.GetString(), context.errBuffer.GetSize() / sizeof(Ch));
+			context.errDoc.SetNull();
+			context.errDoc.GetAllocator().Clear();
+		}
+	};
+	executor(count, task);
+	return rets;
+}
+
+/**
+ * @brief Deserialize a batch of inputs in parallel.
+ *
+ * @see BatchDeserialize<parseFlags, Inputs, T, Executor>()
+ */
+template<typename Inputs, typename T, typename Executor>
+inline std::vector<int> BatchDeserialize(const Inputs& inputs, IJST_OUT std::vector<T>& outputs, Executor&& executor,
+										 DeserFlag::Flag deserFlag = DeserFlag::kNoneFlag,
+										 std::vector<std::basic_string<typename T::_ijst_Ch> >* pErrMsgsOut = NULL)
+{
+	return BatchDeserialize<IJST_PARSE_DEFAULT_FLAGS>(
+			inputs, outputs, std::forward<Executor>(executor), deserFlag, pErrMsgsOut);
+}
+
+/**
+ * @brief Deserialize a batch of inputs in parallel with ThreadPool::GetDefault().
+ *
+ * @see BatchDeserialize<parseFlags, Inputs, T, Executor>()
+ */
+template<typename Inputs, typename T>
+inline std::vector<int> BatchDeserialize(const Inputs& inputs, IJST_OUT std::vector<T>& outputs)
+{
+	return BatchDeserialize<IJST_PARSE_DEFAULT_FLAGS>(inputs, outputs, ThreadPool::GetDefault());
+}
+
+}	// namespace ijst
+
+#endif //IJST_PARALLEL_HPP_INCLUDE_
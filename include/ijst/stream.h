@@ -0,0 +1,690 @@
+/**************************************************************************************************
+ *		Streams of rapidjson which read from or write to FILE*, file descriptor or std::istream
+ *		with a fixed-size buffer, memory-mapped file, and deserialization of ijst struct from them
+ **************************************************************************************************/
+
+#ifndef IJST_STREAM_HPP_INCLUDE_
+#define	IJST_STREAM_HPP_INCLUDE_
+
+#include "ijst.h"
+#include "accessor.h"
+#include "detail/utils.h"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdio>
+#include <istream>
+
+/**
+ * @ingroup IJST_CONFIG
+ *
+ *  Size of buffer on stack when deserializing from std::istream. Default is 4096.
+ *	User can override it by defining IJST_STREAM_BUFFER_SIZE macro.
+ */
+#ifndef IJST_STREAM_BUFFER_SIZE
+	#define IJST_STREAM_BUFFER_SIZE 4096
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+	#define IJSTI_HAS_POSIX_IO	1
+#else
+	#define IJSTI_HAS_POSIX_IO	0
+#endif
+
+#if IJSTI_HAS_POSIX_IO
+	#include <cerrno>
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+namespace ijst {
+namespace detail {
+
+/**
+ * Output stream which collects characters in a fixed-size buffer, and writes the buffer to sink when it is full.
+ *
+ * @tparam Derived		class with method bool WriteSink(const char*, std::size_t) and bool FlushSink()
+ */
+template<typename Derived>
+class BufferedOutputStream {
+public:
+	typedef char Ch;
+
+	void Put(Ch c)
+	{
+		if (m_cur == m_end) {
+			FlushBuffer();
+		}
+		*m_cur++ = c;
+	}
+
+	//! Write buffer and flush sink
+	void Flush()
+	{
+		FlushBuffer();
+		if (!m_hasError && !static_cast<Derived*>(this)->FlushSink()) {
+			m_hasError = true;
+		}
+	}
+
+	//! Whether error occurs when writing to sink. Following output is dropped after error
+	bool HasError() const { return m_hasError; }
+
+protected:
+	BufferedOutputStream(Ch* buffer, std::size_t bufferSize)
+			: m_buffer(buffer), m_cur(buffer), m_end(buffer + bufferSize), m_hasError(false)
+	{
+		assert(buffer != NULL && bufferSize > 0);
+	}
+
+private:
+	BufferedOutputStream(const BufferedOutputStream&) IJSTI_DELETED;
+	BufferedOutputStream& operator=(BufferedOutputStream) IJSTI_DELETED;
+
+	void FlushBuffer()
+	{
+		if (!m_hasError && m_cur != m_buffer
+			&& !static_cast<Derived*>(this)->WriteSink(m_buffer, static_cast<std::size_t>(m_cur - m_buffer)))
+		{
+			m_hasError = true;
+		}
+		m_cur = m_buffer;
+	}
+
+	Ch* const m_buffer;
+	Ch* m_cur;
+	Ch* const m_end;
+	bool m_hasError;
+};
+
+/**
+ * Input stream which reads from source to a fixed-size buffer. Peek() returns '\0' at the end of input.
+ *
+ * @tparam Derived		class with method std::size_t ReadSource(char*, std::size_t),
+ * 						which returns 0 at the end of input or when error occurs
+ */
+template<typename Derived>
+class BufferedInputStream {
+public:
+	typedef char Ch;
+
+	Ch Peek() const { return *m_cur; }
+	Ch Take() { const Ch c = *m_cur; Read(); return c; }
+	std::size_t Tell() const { return m_count + static_cast<std::size_t>(m_cur - m_buffer); }
+
+	// Not implemented
+	void Put(Ch) { assert(false); }
+	void Flush() { assert(false); }
+	Ch* PutBegin() { assert(false); return NULL; }
+	std::size_t PutEnd(Ch*) { assert(false); return 0; }
+
+	//! Whether error occurs when reading from source
+	bool HasError() const { return m_hasError; }
+
+protected:
+	BufferedInputStream(Ch* buffer, std::size_t bufferSize)
+			: m_buffer(buffer), m_bufferSize(bufferSize), m_cur(buffer), m_last(buffer)
+			  , m_readCount(0), m_count(0), m_eof(false), m_hasError(false)
+	{
+		assert(buffer != NULL && bufferSize > 0);
+		*m_cur = '\0';
+	}
+
+	//! Fill the buffer at first time. Called by derived class after it is constructed
+	void Init() { Fill(); }
+
+	//! Called by derived class when reading from source fails
+	void SetError() { m_hasError = true; }
+
+private:
+	BufferedInputStream(const BufferedInputStream&) IJSTI_DELETED;
+	BufferedInputStream& operator=(BufferedInputStream) IJSTI_DELETED;
+
+	void Read()
+	{
+		if (m_cur < m_last) {
+			++m_cur;
+		}
+		else if (!m_eof) {
+			Fill();
+		}
+	}
+
+	void Fill()
+	{
+		m_count += m_readCount;
+		m_readCount = static_cast<Derived*>(this)->ReadSource(m_buffer, m_bufferSize);
+		m_cur = m_buffer;
+		if (m_readCount == 0) {
+			m_buffer[0] = '\0';
+			m_last = m_buffer;
+			m_eof = true;
+		}
+		else {
+			m_last = m_buffer + m_readCount - 1;
+		}
+	}
+
+	Ch* const m_buffer;
+	const std::size_t m_bufferSize;
+	Ch* m_cur;
+	Ch* m_last;
+	std::size_t m_readCount;
+	std::size_t m_count;
+	bool m_eof;
+	bool m_hasError;
+};
+
+}	// namespace detail
+
+/**
+ * @brief Output stream of rapidjson::Writer which writes to FILE*.
+ *
+ * Memory usage is bounded by the buffer no matter how large the output is.
+ *
+ * @see Accessor::SerializeToStream()
+ */
+class FileOutputStream : public detail::BufferedOutputStream<FileOutputStream> {
+public:
+	/**
+	 * @brief Constructor
+	 *
+	 * @param fp			file to write, which is not closed by this object
+	 * @param buffer		buffer of output, whose lifecycle should be longer than this object
+	 * @param bufferSize	size of buffer, must be greater than 0
+	 */
+	FileOutputStream(std::FILE* fp, char* buffer, std::size_t bufferSize)
+			: detail::BufferedOutputStream<FileOutputStream>(buffer, bufferSize), m_fp(fp)
+	{
+		assert(fp != NULL);
+	}
+
+private:
+	friend class detail::BufferedOutputStream<FileOutputStream>;
+	bool WriteSink(const char* data, std::size_t length)
+	{
+		return std::fwrite(data, 1, length, m_fp) == length;
+	}
+
+	bool FlushSink() { return std::fflush(m_fp) == 0; }
+
+	std::FILE* const m_fp;
+};
+
+namespace detail {
+template<>
+struct StreamFailChecker<FileOutputStream> {
+	static bool IsFailed(const FileOutputStream& os) { return os.HasError(); }
+};
+}	// namespace detail
+
+/**
+ * @brief Input stream of rapidjson which reads from FILE*.
+ *
+ * @see Accessor::DeserializeStream()
+ */
+class FileInputStream : public detail::BufferedInputStream<FileInputStream> {
+public:
+	/**
+	 * @brief Constructor
+	 *
+	 * @param fp			file to read, which is not closed by this object
+	 * @param buffer		buffer of input, whose lifecycle should be longer than this object
+	 * @param bufferSize	size of buffer, must be greater than 0
+	 */
+	FileInputStream(std::FILE* fp, char* buffer, std::size_t bufferSize)
+			: detail::BufferedInputStream<FileInputStream>(buffer, bufferSize), m_fp(fp)
+	{
+		assert(fp != NULL);
+		Init();
+	}
+
+private:
+	friend class detail::BufferedInputStream<FileInputStream>;
+	std::size_t ReadSource(char* buffer, std::size_t size)
+	{
+		const std::size_t readCount = std::fread(buffer, 1, size, m_fp);
+		if (readCount == 0 && std::ferror(m_fp)) {
+			SetError();
+		}
+		return readCount;
+	}
+
+	std::FILE* const m_fp;
+};
+
+namespace detail {
+template<>
+struct StreamFailChecker<FileInputStream> {
+	static bool IsFailed(const FileInputStream& is) { return is.HasError(); }
+};
+}	// namespace detail
+
+/**
+ * @brief Input stream of rapidjson which reads from std::istream.
+ *
+ * Different from rapidjson::IStreamWrapper, it reads the std::istream block by block instead of character by character.
+ *
+ * @see Accessor::DeserializeStream()
+ */
+class IStreamInputStream : public detail::BufferedInputStream<IStreamInputStream> {
+public:
+	/**
+	 * @brief Constructor
+	 *
+	 * @param is			stream to read
+	 * @param buffer		buffer of input, whose lifecycle should be longer than this object
+	 * @param bufferSize	size of buffer, must be greater than 0
+	 */
+	IStreamInputStream(std::istream& is, char* buffer, std::size_t bufferSize)
+			: detail::BufferedInputStream<IStreamInputStream>(buffer, bufferSize), m_is(is)
+	{
+		Init();
+	}
+
+private:
+	friend class detail::BufferedInputStream<IStreamInputStream>;
+	std::size_t ReadSource(char* buffer, std::size_t size)
+	{
+		m_is.read(buffer, static_cast<std::streamsize>(size));
+		if (m_is.bad()) {
+			SetError();
+		}
+		return static_cast<std::size_t>(m_is.gcount());
+	}
+
+	std::istream& m_is;
+};
+
+namespace detail {
+template<>
+struct StreamFailChecker<IStreamInputStream> {
+	static bool IsFailed(const IStreamInputStream& is) { return is.HasError(); }
+};
+}	// namespace detail
+
+/**
+ * @brief Deserialize ijst struct from std::istream.
+ *
+ * The stream is read block by block through a buffer on stack of IJST_STREAM_BUFFER_SIZE bytes.
+ *
+ * @tparam T 				ijst struct
+ *
+ * @param st 				ijst struct instance
+ * @param is				Input stream, whose content is encoded in UTF-8
+ * @param deserFlag	 		Deserialization options, options can be combined by bitwise OR operator (|)
+ * @param pErrDocOut		Error message output. Null if do not need error message
+ * @return					Error code, ErrorCode::kReadFailed if reading from is fails
+ *
+ * @see Accessor::DeserializeStream(), IStreamInputStream
+ */
+template<typename T>
+inline int Deserialize(T& st, std::istream& is,
+					   DeserFlag::Flag deserFlag = DeserFlag::kNoneFlag,
+					   rapidjson::GenericDocument<typename T::_ijst_Encoding>* pErrDocOut = NULL)
+{
+	char buffer[IJST_STREAM_BUFFER_SIZE];
+	IStreamInputStream stream(is, buffer, sizeof(buffer));
+	return st._.template DeserializeStream<IJST_PARSE_DEFAULT_FLAGS, rapidjson::UTF8<> >(
+			stream, deserFlag, pErrDocOut);
+}
+
+/**
+ * @brief Deserialize ijst struct from FILE*.
+ *
+ * The file is read block by block through a buffer on stack of IJST_STREAM_BUFFER_SIZE bytes.
+ *
+ * @tparam T 				ijst struct
+ *
+ * @param st 				ijst struct instance
+ * @param fp				File to read, whose content is encoded in UTF-8. It is not closed by this function
+ * @param deserFlag	 		Deserialization options, options can be combined by bitwise OR operator (|)
+ * @param pErrDocOut		Error message output. Null if do not need error message
+ * @return					Error code, ErrorCode::kReadFailed if reading from fp fails
+ *
+ * @see Accessor::DeserializeStream(), FileInputStream
+ */
+template<typename T>
+inline int Deserialize(T& st, std::FILE* fp,
+					   DeserFlag::Flag deserFlag = DeserFlag::kNoneFlag,
+					   rapidjson::GenericDocument<typename T::_ijst_Encoding>* pErrDocOut = NULL)
+{
+	char buffer[IJST_STREAM_BUFFER_SIZE];
+	FileInputStream stream(fp, buffer, sizeof(buffer));
+	return st._.template DeserializeStream<IJST_PARSE_DEFAULT_FLAGS, rapidjson::UTF8<> >(
+			stream, deserFlag, pErrDocOut);
+}
+
+#if IJSTI_HAS_POSIX_IO
+/**
+ * @brief Output stream of rapidjson::Writer which writes to POSIX file descriptor.
+ *
+ * Memory usage is bounded by the buffer no matter how large the output is.
+ *
+ * @see Accessor::SerializeToStream()
+ */
+class FdOutputStream : public detail::BufferedOutputStream<FdOutputStream> {
+public:
+	/**
+	 * @brief Constructor
+	 *
+	 * @param fd			file descriptor to write, which is not closed by this object
+	 * @param buffer		buffer of output, whose lifecycle should be longer than this object
+	 * @param bufferSize	size of buffer, must be greater than 0
+	 */
+	FdOutputStream(int fd, char* buffer, std::size_t bufferSize)
+			: detail::BufferedOutputStream<FdOutputStream>(buffer, bufferSize), m_fd(fd)
+	{ }
+
+private:
+	friend class detail::BufferedOutputStream<FdOutputStream>;
+	bool WriteSink(const char* data, std::size_t length)
+	{
+		while (length > 0) {
+			const ssize_t written = ::write(m_fd, data, length);
+			if (written < 0) {
+				if (errno == EINTR) {
+					continue;
+				}
+				return false;
+			}
+			data += written;
+			length -= static_cast<std::size_t>(written);
+		}
+		return true;
+	}
+
+	bool FlushSink() { return true; }
+
+	const int m_fd;
+};
+
+namespace detail {
+template<>
+struct StreamFailChecker<FdOutputStream> {
+	static bool IsFailed(const FdOutputStream& os) { return os.HasError(); }
+};
+}	// namespace detail
+
+/**
+ * @brief Input stream of rapidjson which reads from POSIX file descriptor.
+ *
+ * @see Accessor::DeserializeStream()
+ */
+class FdInputStream : public detail::BufferedInputStream<FdInputStream> {
+public:
+	/**
+	 * @brief Constructor
+	 *
+	 * @param fd			file descriptor to read, which is not closed by this object
+	 * @param buffer		buffer of input, whose lifecycle should be longer than this object
+	 * @param bufferSize	size of buffer, must be greater than 0
+	 */
+	FdInputStream(int fd, char* buffer, std::size_t bufferSize)
+			: detail::BufferedInputStream<FdInputStream>(buffer, bufferSize), m_fd(fd)
+	{
+		Init();
+	}
+
+private:
+	friend class detail::BufferedInputStream<FdInputStream>;
+	std::size_t ReadSource(char* buffer, std::size_t size)
+	{
+		while (true) {
+			const ssize_t readCount = ::read(m_fd, buffer, size);
+			if (readCount >= 0) {
+				return static_cast<std::size_t>(readCount);
+			}
+			if (errno != EINTR) {
+				SetError();
+				return 0;
+			}
+		}
+	}
+
+	const int m_fd;
+};
+
+namespace detail {
+template<>
+struct StreamFailChecker<FdInputStream> {
+	static bool IsFailed(const FdInputStream& is) { return is.HasError(); }
+};
+}	// namespace detail
+
+/**
+ * @brief Deserialize ijst struct from POSIX file descriptor.
+ *
+ * The file is read block by block through a buffer on stack of IJST_STREAM_BUFFER_SIZE bytes.
+ *
+ * @tparam T 				ijst struct
+ *
+ * @param st 				ijst struct instance
+ * @param fd				File descriptor to read, whose content is encoded in UTF-8. It is not closed by this function
+ * @param deserFlag	 		Deserialization options, options can be combined by bitwise OR operator (|)
+ * @param pErrDocOut		Error message output. Null if do not need error message
+ * @return					Error code, ErrorCode::kReadFailed if reading from fd fails
+ *
+ * @see Accessor::DeserializeStream(), FdInputStream
+ */
+template<typename T>
+inline int Deserialize(T& st, int fd,
+					   DeserFlag::Flag deserFlag = DeserFlag::kNoneFlag,
+					   rapidjson::GenericDocument<typename T::_ijst_Encoding>* pErrDocOut = NULL)
+{
+	char buffer[IJST_STREAM_BUFFER_SIZE];
+	FdInputStream stream(fd, buffer, sizeof(buffer));
+	return st._.template DeserializeStream<IJST_PARSE_DEFAULT_FLAGS, rapidjson::UTF8<> >(
+			stream, deserFlag, pErrDocOut);
+}
+
+/**
+ * @brief Memory-mapped file.
+ *
+ * Pages are loaded by the kernel on demand instead of being copied by read().
+ *
+ * @see DeserializeFile(), DeserializeFileInsitu()
+ */
+class MappedFile {
+public:
+	enum Mode {
+		//! Map read-only. The content is not null-terminated
+		kReadOnly,
+		//! Map private copy-on-write, followed by a '\0'. Modification is not written back to file
+		kCopyOnWrite
+	};
+
+	MappedFile() : m_data(NULL), m_size(0), m_mapSize(0) { m_empty[0] = '\0'; }
+	~MappedFile() { Close(); }
+
+	/**
+	 * @brief Map file. Previous mapping will be unmapped
+	 *
+	 * @param path		path of regular file
+	 * @param mode		mapping mode
+	 * @return			true if succeed
+	 */
+	bool Open(const char* path, Mode mode = kReadOnly)
+	{
+		Close();
+		int fd;
+		do {
+			fd = ::open(path, O_RDONLY);
+		} while (fd < 0 && errno == EINTR);
+		if (fd < 0) {
+			return false;
+		}
+
+		const bool succ = Map(fd, mode);
+		::close(fd);
+		return succ;
+	}
+
+	//! Unmap file
+	void Close()
+	{
+		if (m_mapSize != 0) {
+			::munmap(m_data, m_mapSize);
+		}
+		m_data = NULL;
+		m_size = 0;
+		m_mapSize = 0;
+	}
+
+	bool IsOpen() const { return m_data != NULL; }
+	//! Content of file. It is writable only when mapped by kCopyOnWrite mode
+	char* Data() const { return m_data; }
+	//! Size of file, not including the '\0' in kCopyOnWrite mode
+	std::size_t Size() const { return m_size; }
+
+private:
+	MappedFile(const MappedFile&) IJSTI_DELETED;
+	MappedFile& operator=(MappedFile) IJSTI_DELETED;
+
+	bool Map(int fd, Mode mode)
+	{
+		struct stat st;
+		if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+			return false;
+		}
+		const std::size_t size = static_cast<std::size_t>(st.st_size);
+
+		if (mode == kReadOnly) {
+			if (size == 0) {
+				m_data = m_empty;
+				return true;
+			}
+			void* p = ::mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (p == MAP_FAILED) {
+				return false;
+			}
+			SetMapping(p, size, size);
+			return true;
+		}
+
+		// Reserve one more byte for the '\0'. The bytes after end of file in last page of file are zero,
+		// but accessing a page beyond end of file raises SIGBUS, so anonymous pages are mapped first
+		const std::size_t pageSize = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+		const std::size_t mapSize = (size + 1 + pageSize - 1) / pageSize * pageSize;
+		void* p = ::mmap(NULL, mapSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+		if (p == MAP_FAILED) {
+			return false;
+		}
+		if (size != 0
+			&& ::mmap(p, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED) {
+			::munmap(p, mapSize);
+			return false;
+		}
+		SetMapping(p, size, mapSize);
+		return true;
+	}
+
+	void SetMapping(void* p, std::size_t size, std::size_t mapSize)
+	{
+		// JSON is parsed from beginning to end
+		(void)::posix_madvise(p, mapSize, POSIX_MADV_SEQUENTIAL);
+		m_data = static_cast<char*>(p);
+		m_size = size;
+		m_mapSize = mapSize;
+	}
+
+	char* m_data;
+	std::size_t m_size;
+	std::size_t m_mapSize;
+	char m_empty[1];
+};
+
+/**
+ * @brief Deserialize ijst struct from file, which is mapped into memory read-only.
+ *
+ * Input is parsed straight from the mapping without being copied by read(). The mapping is released before return.
+ *
+ * @tparam parseFlags		parseFlags of rapidjson parse method
+ * @tparam T 				ijst struct
+ *
+ * @param st 				ijst struct instance
+ * @param path				Path of file, whose content is encoded in UTF-8
+ * @param deserFlag	 		Deserialization options, options can be combined by bitwise OR operator (|)
+ * @param pErrDocOut		Error message output. Null if do not need error message
+ * @return					Error code. ErrorCode::kReadFailed if file could not be mapped
+ *
+ * @note It will free own allocator of st, unless the file could not be mapped
+ */
+template<unsigned parseFlags, typename T>
+inline int DeserializeFile(T& st, const char* path,
+						   DeserFlag::Flag deserFlag = DeserFlag::kNoneFlag,
+						   rapidjson::GenericDocument<typename T::_ijst_Encoding>* pErrDocOut = NULL)
+{
+	MappedFile file;
+	if (!file.Open(path, MappedFile::kReadOnly)) {
+		detail::ErrorDocSetter<typename T::_ijst_Encoding>(pErrDocOut).ReadFailed(path);
+		return ErrorCode::kReadFailed;
+	}
+	return st._.template Deserialize<parseFlags, rapidjson::UTF8<> >(
+			file.Data(), file.Size(), deserFlag, pErrDocOut);
+}
+
+/**
+ * @brief Deserialize ijst struct from file, which is mapped into memory read-only.
+ *
+ * @see DeserializeFile<parseFlags, T>()
+ */
+template<typename T>
+inline int DeserializeFile(T& st, const char* path,
+						   DeserFlag::Flag deserFlag = DeserFlag::kNoneFlag,
+						   rapidjson::GenericDocument<typename T::_ijst_Encoding>* pErrDocOut = NULL)
+{
+	return DeserializeFile<IJST_PARSE_DEFAULT_FLAGS>(st, path, deserFlag, pErrDocOut);
+}
+
+/**
+ * @brief Deserialize ijst struct from file in situ, which is mapped into memory private copy-on-write.
+ *
+ * The mapping is parsed by Accessor::DeserializeInsitu(), so the keys and strings of unknown fields, T_raw fields
+ * and T_strview fields refer to the mapping. Only pages containing escaped strings are copied by the kernel.
+ *
+ * @tparam parseFlags		parseFlags of rapidjson parse method
+ * @tparam T 				ijst struct
+ *
+ * @param st 				ijst struct instance
+ * @param path				Path of file, whose content is encoded in UTF-8
+ * @param fileOut			Mapping of file output. Previous mapping of it will be released
+ * @param deserFlag	 		Deserialization options, options can be combined by bitwise OR operator (|)
+ * @param pErrDocOut		Error message output. Null if do not need error message
+ * @return					Error code. ErrorCode::kReadFailed if file could not be mapped
+ *
+ * @note It will free own allocator of st, unless the file could not be mapped
+ * @note fileOut must outlive st (or until ShrinkAllocator() of st is called)
+ * @note Only available when character type of T is char
+ */
+template<unsigned parseFlags, typename T>
+inline int DeserializeFileInsitu(T& st, const char* path, IJST_OUT MappedFile& fileOut,
+								 DeserFlag::Flag deserFlag = DeserFlag::kNoneFlag,
+								 rapidjson::GenericDocument<typename T::_ijst_Encoding>* pErrDocOut = NULL)
+{
+	if (!fileOut.Open(path, MappedFile::kCopyOnWrite)) {
+		detail::ErrorDocSetter<typename T::_ijst_Encoding>(pErrDocOut).ReadFailed(path);
+		return ErrorCode::kReadFailed;
+	}
+	return st._.template DeserializeInsitu<parseFlags>(fileOut.Data(), deserFlag, pErrDocOut);
+}
+
+/**
+ * @brief Deserialize ijst struct from file in situ, which is mapped into memory private copy-on-write.
+ *
+ * @see DeserializeFileInsitu<parseFlags, T>()
+ */
+template<typename T>
+inline int DeserializeFileInsitu(T& st, const char* path, IJST_OUT MappedFile& fileOut,
+								 DeserFlag::Flag deserFlag = DeserFlag::kNoneFlag,
+								 rapidjson::GenericDocument<typename T::_ijst_Encoding>* pErrDocOut = NULL)
+{
+	return DeserializeFileInsitu<IJST_PARSE_DEFAULT_FLAGS>(st, path, fileOut, deserFlag, pErrDocOut);
+}
+#endif	// IJSTI_HAS_POSIX_IO
+
+}	// namespace ijst
+
+#endif //IJST_STREAM_HPP_INCLUDE_
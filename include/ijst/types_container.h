@@ -10,6 +10,48 @@
 #include <map>
 #include <list>
 #include <deque>
+#include <algorithm>
+#if __cplusplus >= 201103L
+	#include <unordered_map>
+	#include <tuple>
+#endif
+
+/**
+ * @ingroup IJST_CONFIG
+ *
+ *  By default, DeserFlag::kParallelArray is ignored, so that ijst does not start threads.
+ *  User can set IJST_ENABLE_PARALLEL_ARRAY to 1 to deserialize large array of ijst structs in multiple threads,
+ *  which requires C++11. The macro should have the same value in all translation units of a program.
+ */
+#ifndef IJST_ENABLE_PARALLEL_ARRAY
+	#define IJST_ENABLE_PARALLEL_ARRAY			0
+#endif
+
+#if IJST_ENABLE_PARALLEL_ARRAY
+	#include "detail/parallel.h"
+#endif
+
+/**
+ * @ingroup IJST_CONFIG
+ *
+ *  When deserializing with DeserFlag::kParallelArray, array of ijst structs is split into shards of at least
+ *  IJST_PARALLEL_ARRAY_MIN_SHARD_SIZE elements, so small arrays are deserialized in the calling thread. Default is 1024.
+ *	User can override it by defining IJST_PARALLEL_ARRAY_MIN_SHARD_SIZE macro.
+ */
+#ifndef IJST_PARALLEL_ARRAY_MIN_SHARD_SIZE
+	#define IJST_PARALLEL_ARRAY_MIN_SHARD_SIZE	1024
+#endif
+
+/**
+ * @ingroup IJST_CONFIG
+ *
+ *  Max count of threads to deserialize an array with DeserFlag::kParallelArray, including the calling thread.
+ *  Default is 0, which means the count of CPU cores.
+ *	User can override it by defining IJST_PARALLEL_ARRAY_THREAD_COUNT macro.
+ */
+#ifndef IJST_PARALLEL_ARRAY_THREAD_COUNT
+	#define IJST_PARALLEL_ARRAY_THREAD_COUNT	0
+#endif
 
 #ifdef _MSC_VER
 	#define IJSTI_IMPL_WRAPPER(Name, ... )	IJSTI_EXPAND(IJSTI_PP_CONCAT(IJSTI_ ## Name ## _IMPL_, IJSTI_PP_NARGS(__VA_ARGS__))(__VA_ARGS__))
@@ -42,6 +84,11 @@
 //! @ingroup IJST_MACRO_API
 #define IJST_TMAP(...)						IJST_TYPE(::std::map< ::std::basic_string<_ijst_Ch>, __VA_ARGS__ >)
 
+//! @brief IJST_TUMAP(T, Hash=std::hash, Pred=std::equal_to, Alloc=std::allocator<T>), use for declaring a unordered_map<string, T, Hash, Pred, Alloc> field in ijst struct.
+//! Only available in C++11 or later.
+//! @ingroup IJST_MACRO_API
+#define IJST_TUMAP(...)						IJST_TYPE(::std::unordered_map< ::std::basic_string<_ijst_Ch>, __VA_ARGS__ >)
+
 //! @brief Declare a vector of members of json object
 //!	#define IJST_TOBJ(T, Alloc=DefaultAlloc) 	std::vector<ijst::T_Member<T>, Alloc>
 //! @ingroup IJST_MACRO_API
@@ -49,6 +96,13 @@
 #define IJSTI_TOBJ_IMPL_1(T)				IJST_TYPE(::std::vector< ::ijst::T_Member< T, _ijst_Ch> >)
 #define IJSTI_TOBJ_IMPL_2(T, Alloc)			IJST_TYPE(::std::vector< ::ijst::T_Member< T, _ijst_Ch>, Alloc >)
 
+//! @brief Declare a sorted vector of members of json object, which could be searched by key
+//!	#define IJST_TFLATMAP(T, Alloc=DefaultAlloc) 	ijst::T_FlatMap<T, Ch, Alloc>
+//! @ingroup IJST_MACRO_API
+#define IJST_TFLATMAP(...)					IJSTI_IMPL_WRAPPER(TFLATMAP, __VA_ARGS__)
+#define IJSTI_TFLATMAP_IMPL_1(T)			IJST_TYPE(::ijst::T_FlatMap< T, _ijst_Ch>)
+#define IJSTI_TFLATMAP_IMPL_2(T, Alloc)		IJST_TYPE(::ijst::T_FlatMap< T, _ijst_Ch, Alloc >)
+
 //! @brief Declare a object field which T is a ijst struct type.
 //! @ingroup IJST_MACRO_API
 #define IJST_TST(T)							T
@@ -75,6 +129,158 @@ struct T_Member {
 #endif
 };
 
+/**
+ * @brief Map stored in a sorted vector of members
+ *
+ * Members are stored contiguously and sorted by name, so lookup is a binary search without pointer chasing.
+ * Inserting or erasing is O(n), it is suitable for dictionaries that are read mostly.
+ *
+ * @tparam T		value type
+ * @tparam CharType	character type of string
+ * @tparam Alloc	allocator of T_Member<T, CharType>
+ */
+template<typename T, typename CharType = char, typename Alloc = std::allocator<T_Member<T, CharType> > >
+class T_FlatMap {
+public:
+	typedef std::basic_string<CharType> key_type;
+	typedef T mapped_type;
+	typedef T_Member<T, CharType> value_type;
+	typedef std::vector<value_type, Alloc> container_type;
+	typedef typename container_type::size_type size_type;
+	typedef typename container_type::iterator iterator;
+	typedef typename container_type::const_iterator const_iterator;
+
+	iterator begin() { return m_members.begin(); }
+	iterator end() { return m_members.end(); }
+	const_iterator begin() const { return m_members.begin(); }
+	const_iterator end() const { return m_members.end(); }
+	size_type size() const { return m_members.size(); }
+	bool empty() const { return m_members.empty(); }
+	void clear() { m_members.clear(); }
+	void reserve(size_type n) { m_members.reserve(n); }
+	void swap(T_FlatMap& rhs) { m_members.swap(rhs.m_members); }
+	//! Members sorted by name
+	const container_type& members() const { return m_members; }
+
+	iterator find(const key_type& key)
+	{
+		iterator it = lower_bound(key);
+		return (it != m_members.end() && it->name == key) ? it : m_members.end();
+	}
+
+	const_iterator find(const key_type& key) const
+	{
+		const_iterator it = lower_bound(key);
+		return (it != m_members.end() && it->name == key) ? it : m_members.end();
+	}
+
+	size_type count(const key_type& key) const { return find(key) == m_members.end() ? 0 : 1; }
+
+	iterator lower_bound(const key_type& key)
+	{ return std::lower_bound(m_members.begin(), m_members.end(), key, LessName()); }
+
+	const_iterator lower_bound(const key_type& key) const
+	{ return std::lower_bound(m_members.begin(), m_members.end(), key, LessName()); }
+
+	//! Insert the member if the name is not exist
+	std::pair<iterator, bool> insert(const value_type& member)
+	{
+		iterator it = lower_bound(member.name);
+		if (it != m_members.end() && it->name == member.name) {
+			return std::make_pair(it, false);
+		}
+		return std::make_pair(m_members.insert(it, member), true);
+	}
+
+	//! Get the value of key, insert a default one if the key is not exist
+	T& operator[](const key_type& key)
+	{
+		iterator it = lower_bound(key);
+		if (it == m_members.end() || it->name != key) {
+			it = m_members.insert(it, value_type(key, T()));
+		}
+		return it->value;
+	}
+
+	iterator erase(iterator it) { return m_members.erase(it); }
+
+	size_type erase(const key_type& key)
+	{
+		iterator it = find(key);
+		if (it == m_members.end()) {
+			return 0;
+		}
+		m_members.erase(it);
+		return 1;
+	}
+
+	friend bool operator==(const T_FlatMap& lhs, const T_FlatMap& rhs)
+	{
+		if (lhs.size() != rhs.size()) {
+			return false;
+		}
+		for (const_iterator itL = lhs.begin(), itR = rhs.begin(), itEnd = lhs.end(); itL != itEnd; ++itL, ++itR) {
+			if (itL->name != itR->name || !(itL->value == itR->value)) {
+				return false;
+			}
+		}
+		return true;
+	}
+	friend bool operator!=(const T_FlatMap& lhs, const T_FlatMap& rhs) { return !(lhs == rhs); }
+
+private:
+	template<typename, typename> friend class detail::FSerializer;
+
+	struct LessName {
+		bool operator()(const value_type& lhs, const value_type& rhs) const { return lhs.name < rhs.name; }
+		bool operator()(const value_type& lhs, const key_type& rhs) const { return lhs.name < rhs; }
+		bool operator()(const key_type& lhs, const value_type& rhs) const { return lhs < rhs.name; }
+	};
+
+	container_type m_members;
+};
+
+/**
+ * Specialization for T_FlatMap type of Optional template.
+ * This specialization add operator[] (string key) for getter chaining, which is a binary search.
+ *
+ * @tparam TElem		map value type
+ * @tparam CharType		character type of map key
+ */
+template <typename TElem, typename CharType, typename Alloc>
+class Optional <T_FlatMap<TElem, CharType, Alloc> >
+{
+	typedef T_FlatMap<TElem, CharType, Alloc> ValType;
+	IJSTI_OPTIONAL_BASE_DEFINE(ValType)
+public:
+	//! return Optional(elemInstance) if key is found, Optional(null) else
+	Optional<TElem> operator[](const std::basic_string<CharType>& key) const
+	{
+		if (m_pVal == NULL) {
+			return Optional<TElem>(NULL);
+		}
+		typename ValType::iterator it = m_pVal->find(key);
+		return Optional<TElem>(it == m_pVal->end() ? NULL : &it->value);
+	}
+};
+
+template <typename TElem, typename CharType, typename Alloc>
+class Optional <const T_FlatMap<TElem, CharType, Alloc> >
+{
+	typedef const T_FlatMap<TElem, CharType, Alloc> ValType;
+	IJSTI_OPTIONAL_BASE_DEFINE(ValType)
+public:
+	//! return Optional(const elemInstance) if key is found, Optional(null) else
+	Optional<const TElem> operator[](const std::basic_string<CharType>& key) const
+	{
+		if (m_pVal == NULL) {
+			return Optional<const TElem>(NULL);
+		}
+		typename ValType::const_iterator it = m_pVal->find(key);
+		return Optional<const TElem>(it == m_pVal->end() ? NULL : &it->value);
+	}
+};
+
 /**
  * Specialization for map type of Optional template.
  * This specialization add operator[] (string key) for getter chaining.
@@ -143,6 +349,76 @@ public:
 	}
 };
 
+#if __cplusplus >= 201103L
+/**
+ * Specialization for unordered_map type of Optional template.
+ * This specialization add operator[] (string key) for getter chaining.
+ *
+ * @tparam TElem		map value type
+ * @tparam CharType		character type of map key
+ */
+template <typename TElem, typename CharType, typename Hash, typename Pred, typename Alloc>
+class Optional <std::unordered_map<std::basic_string<CharType>, TElem, Hash, Pred, Alloc> >
+{
+	typedef std::unordered_map<std::basic_string<CharType>, TElem, Hash, Pred, Alloc> ValType;
+	IJSTI_OPTIONAL_BASE_DEFINE(ValType)
+public:
+	/**
+	 * Get element by key
+	 *
+	 * @param key 	key
+	 * @return 		Optional(elemInstance) if key is found, Optional(null) else
+	 */
+	Optional<TElem> operator[](const std::basic_string<CharType>& key) const
+	{
+		if (m_pVal == NULL) {
+			return Optional<TElem>(NULL);
+		}
+		typename ValType::iterator it = m_pVal->find(key);
+		if (it == m_pVal->end()){
+			return Optional<TElem>(NULL);
+		}
+		else {
+			return Optional<TElem>(&it->second);
+		}
+	}
+};
+
+/**
+ * const version Specialization for unordered_map type of Optional template.
+ * This specialization add operator[] (string key) for getter chaining.
+ *
+ * @tparam TElem		map value type
+ * @tparam CharType		character type of map key
+ */
+template <typename TElem, typename CharType, typename Hash, typename Pred, typename Alloc>
+class Optional <const std::unordered_map<std::basic_string<CharType>, TElem, Hash, Pred, Alloc> >
+{
+	typedef const std::unordered_map<std::basic_string<CharType>, TElem, Hash, Pred, Alloc> ValType;
+	IJSTI_OPTIONAL_BASE_DEFINE(ValType)
+public:
+	/**
+	 * Get element by key
+	 *
+	 * @param key 	key
+	 * @return 		Optional(const elemInstance) if key is found, Optional(null) else
+	 */
+	Optional<const TElem> operator[](const std::basic_string<CharType>& key) const
+	{
+		if (m_pVal == NULL) {
+			return Optional<const TElem>(NULL);
+		}
+		typename ValType::const_iterator it = m_pVal->find(key);
+		if (it == m_pVal->end()){
+			return Optional<const TElem>(NULL);
+		}
+		else {
+			return Optional<const TElem>(&it->second);
+		}
+	}
+};
+#endif
+
 /**
  * Specialization for vector or deque type of Optional template.
  * This specialization add operator[] (size_type i) for getter chaining.
@@ -177,30 +453,206 @@ IJSTI_OPTIONAL_ARRAY_DEFINE(const, std::deque)
 namespace ijst {
 namespace detail {
 
+//! Storage of containers in heap, estimated by size of elements for node-based containers
+template<typename T, typename Alloc>
+inline size_t ContainerStorageBytes(const std::vector<T, Alloc>& field)
+{ return field.capacity() * sizeof(T); }
+
+template<typename T, typename Alloc>
+inline size_t ContainerStorageBytes(const std::deque<T, Alloc>& field)
+{ return field.size() * sizeof(T); }
+
+template<typename T, typename Alloc>
+inline size_t ContainerStorageBytes(const std::list<T, Alloc>& field)
+{ return field.size() * (sizeof(T) + 2 * sizeof(void*)); }
+
+template<typename Key, typename T, typename Compare, typename Alloc>
+inline size_t ContainerStorageBytes(const std::map<Key, T, Compare, Alloc>& field)
+{ return field.size() * (sizeof(typename std::map<Key, T, Compare, Alloc>::value_type) + 4 * sizeof(void*)); }
+
+#if __cplusplus >= 201103L
+template<typename Key, typename T, typename Hash, typename Pred, typename Alloc>
+inline size_t ContainerStorageBytes(const std::unordered_map<Key, T, Hash, Pred, Alloc>& field)
+{
+	return field.size() * (sizeof(typename std::unordered_map<Key, T, Hash, Pred, Alloc>::value_type) + 2 * sizeof(void*))
+		   + field.bucket_count() * sizeof(void*);
+}
+#endif
+
+//! Get the element to deserialize in place. Elements before index are deserialized, others are reusable
+template<typename VarType>
+inline typename VarType::value_type& NextElem(VarType& field, size_t index)
+{
+	if (index >= field.size()) {
+		field.push_back(typename VarType::value_type());
+	}
+	return field[index];
+}
+
+template<typename T, typename Alloc>
+inline T& NextElem(std::list<T, Alloc>& field, size_t index)
+{
+	// The reusable elements are kept in front, move the first one to back
+	if (index < field.size()) {
+		field.splice(field.end(), field, field.begin());
+	}
+	else {
+		field.push_back(T());
+	}
+	return field.back();
+}
+
+//! Remove the reusable elements after getting count elements by NextElem()
+template<typename VarType>
+inline void RemoveUnusedElem(VarType& field, size_t count)
+{
+	field.resize(count);
+}
+
+template<typename T, typename Alloc>
+inline void RemoveUnusedElem(std::list<T, Alloc>& field, size_t count)
+{
+	while (field.size() > count) {
+		field.pop_front();
+	}
+}
+
+//! Whether T is ijst struct
+template<typename T, typename Enable = void>
+struct IsIjstStruct { enum { value = 0 }; };
+
+template<typename T>
+struct IsIjstStruct<T, /*EnableIf*/ typename HasType<typename T::_ijst_AccessorType>::Void> { enum { value = 1 }; };
+
+/**
+ * Deserialization of array with DeserFlag::kParallelArray.
+ * Only array of ijst struct could be sharded (see the specialization), other arrays are deserialized serially.
+ */
+template<typename ElemType, typename VarType, typename Encoding, bool isIjstStruct = (IsIjstStruct<ElemType>::value != 0)>
+class ParallelArrayDeserializer {
+public:
+	IJSTI_PROPAGATE_SINTERFACE_TYPE(Encoding);
+
+	//! Returns true and sets ret if the array is deserialized in threads, otherwise caller should deserialize it
+	static bool TryFromJson(const FromJsonReq& req, IJST_OUT FromJsonResp& resp,
+							SerializerInterface<Encoding>& intf, IJST_OUT int& ret)
+	{
+		(void)req; (void)resp; (void)intf; (void)ret;
+		return false;
+	}
+};
+
+#if IJST_ENABLE_PARALLEL_ARRAY
+// ijst struct does not use req.allocator when not moving source, so its elements could be sharded
 template<typename ElemType, typename VarType, typename Encoding>
-class ContainerSerializer : public SerializerInterface<Encoding> {
+class ParallelArrayDeserializer<ElemType, VarType, Encoding, true> {
 public:
 	IJSTI_PROPAGATE_SINTERFACE_TYPE(Encoding);
 
-	virtual int Serialize(const SerializeReq &req) IJSTI_OVERRIDE
+	static bool TryFromJson(const FromJsonReq& req, IJST_OUT FromJsonResp& resp,
+							SerializerInterface<Encoding>& intf, IJST_OUT int& ret)
 	{
-		assert(req.pField != NULL);
-		const VarType& field = *static_cast<const VarType*>(req.pField);
-		SerializerInterface<Encoding>& intf = IJSTI_FSERIALIZER_INS(ElemType, Encoding);
+		if (!Util::IsBitSet(req.deserFlag, DeserFlag::kParallelArray) || InParallelTask()) {
+			return false;
+		}
+		const VarType& field = *static_cast<VarType *>(req.pFieldBuffer);
+		const size_t threadCount =
+				IJST_PARALLEL_ARRAY_THREAD_COUNT == 0 ? GetDefaultThreadCount() : IJST_PARALLEL_ARRAY_THREAD_COUNT;
+		const size_t shardCount = std::min<size_t>(threadCount, field.size() / IJST_PARALLEL_ARRAY_MIN_SHARD_SIZE);
+		if (shardCount <= 1) {
+			return false;
+		}
+		ret = FromJsonInShards(req, resp, intf, shardCount);
+		return true;
+	}
+
+private:
+	/**
+	 * Deserialize elements in shards, each in its own thread.
+	 * The elements copy from source into their own allocators, so the shards do not share allocator.
+	 * Errors are not recorded in threads, the first failed element is deserialized again to build error doc.
+	 */
+	static int FromJsonInShards(const FromJsonReq& req, IJST_OUT FromJsonResp& resp,
+								SerializerInterface<Encoding>& intf, size_t shardCount)
+	{
+		VarType& field = *static_cast<VarType *>(req.pFieldBuffer);
+		const size_t size = field.size();
+
+		std::vector<const void*> visited;
+		intf.InitSingletons(visited);
+
+		std::vector<typename VarType::iterator> shardBegins(shardCount);
+		shardBegins[0] = field.begin();
+		for (size_t iShard = 1; iShard < shardCount; ++iShard) {
+			shardBegins[iShard] = shardBegins[iShard - 1];
+			std::advance(shardBegins[iShard], ShardBegin(size, shardCount, iShard) - ShardBegin(size, shardCount, iShard - 1));
+		}
+		// Index of first failed element in each shard, size if none
+		std::vector<size_t> failedIndexes(shardCount, size);
+
+		auto task = [&](size_t iShard) {
+			ErrorDocSetter<Encoding> noErrDoc(NULL);
+			typename VarType::iterator itField = shardBegins[iShard];
+			for (size_t i = ShardBegin(size, shardCount, iShard), iEnd = ShardBegin(size, shardCount, iShard + 1);
+				 i != iEnd; ++i, ++itField)
+			{
+				FromJsonReq elemReq(req.stream[static_cast<rapidjson::SizeType>(i)], req.allocator,
+									req.deserFlag, /*canMoveSrc=*/false, &*itField, FDesc::NoneFlag);
+				FromJsonResp elemResp(noErrDoc);
+				if (intf.FromJson(elemReq, elemResp) != 0) {
+					failedIndexes[iShard] = i;
+					return;
+				}
+			}
+		};
+		RunInThreads(shardCount, task);
+
+		const size_t failedIndex = *std::min_element(failedIndexes.begin(), failedIndexes.end());
+		if (failedIndex == size) {
+			return 0;
+		}
+
+		typename VarType::iterator itField = field.begin();
+		std::advance(itField, failedIndex);
+		FromJsonReq elemReq(req.stream[static_cast<rapidjson::SizeType>(failedIndex)], req.allocator,
+							req.deserFlag, /*canMoveSrc=*/false, &*itField, FDesc::NoneFlag);
+		FromJsonResp elemResp(resp.errDoc);
+		const int elemRet = intf.FromJson(elemReq, elemResp);
+		assert(elemRet != 0);
+		field.resize(failedIndex);
+		resp.errDoc.ErrorInArray(static_cast<rapidjson::SizeType>(failedIndex));
+		return elemRet;
+	}
+
+	static size_t ShardBegin(size_t size, size_t shardCount, size_t iShard)
+	{
+		return size * iShard / shardCount;
+	}
+};
+#endif
 
-		IJSTI_RET_WHEN_WRITE_FAILD(req.writer.StartArray());
+template<typename ElemType, typename VarType, typename Encoding>
+class ContainerSerializer : public SerializerInterface<Encoding> {
+public:
+	IJSTI_PROPAGATE_SINTERFACE_TYPE(Encoding);
+
+	template<typename Handler>
+	static int Serialize(const VarType& field, Handler& writer, SerFlag::Flag serFlag)
+	{
+		IJSTI_RET_WHEN_WRITE_FAILD(writer.StartArray());
 
 		for (typename VarType::const_iterator itera = field.begin(), itEnd = field.end(); itera != itEnd; ++itera)
 		{
-			SerializeReq elemReq(req.writer, &(*itera), req.serFlag);
-			IJSTI_RET_WHEN_NOT_ZERO(intf.Serialize(elemReq));
+			IJSTI_RET_WHEN_NOT_ZERO(
+					(FSerializer<ElemType, Encoding>::Serialize(*itera, writer, serFlag)) );
 		}
 
 		IJSTI_RET_WHEN_WRITE_FAILD(
-				req.writer.EndArray(static_cast<rapidjson::SizeType>(field.size())) );
+				writer.EndArray(static_cast<rapidjson::SizeType>(field.size())) );
 
 		return 0;
 	}
+	IJSTI_DEFINE_SERIALIZE_BY_STATIC()
 
 	virtual int FromJson(const FromJsonReq &req, FromJsonResp &resp) IJSTI_OVERRIDE
 	{
@@ -208,11 +660,20 @@ public:
 
 		assert(req.pFieldBuffer != NULL);
 		VarType& field = *static_cast<VarType *>(req.pFieldBuffer);
-		field.clear();
+		if (!Util::IsBitSet(req.deserFlag, DeserFlag::kReuseFields)) {
+			field.clear();
+		}
 		// Alloc buffer
 		field.resize(req.stream.Size());
 		SerializerInterface<Encoding>& intf = IJSTI_FSERIALIZER_INS(ElemType, Encoding);
 
+		int parallelRet = 0;
+		if (ParallelArrayDeserializer<ElemType, VarType, Encoding>::TryFromJson(req, resp, intf, parallelRet)) {
+			IJSTI_RET_WHEN_NOT_ZERO(parallelRet);
+			IJSTI_RET_WHEN_VALUE_IS_DEFAULT((field.empty()));
+			return 0;
+		}
+
 		size_t i = 0;
 		typename VarType::iterator itField = field.begin();
 		for (typename rapidjson::GenericValue<Encoding>::ValueIterator itVal = req.stream.Begin(), itEnd = req.stream.End();
@@ -239,6 +700,50 @@ public:
 		return 0;
 	}
 
+	virtual int FromSAX(const FromSAXReq &req, IJST_OUT FromJsonResp &resp) IJSTI_OVERRIDE
+	{
+		if (req.state.isDom || (!req.state.isStarted && req.event.type != SAXEvent::kStartArray)) {
+			return this->DomFromSAX(req, resp);
+		}
+
+		assert(req.state.pFieldBuffer != NULL);
+		VarType& field = *static_cast<VarType *>(req.state.pFieldBuffer);
+		// count is the count of elements deserialized
+		if (!req.state.isStarted) {
+			assert(req.event.type == SAXEvent::kStartArray);
+			req.state.isStarted = true;
+			if (!Util::IsBitSet(req.deserFlag, DeserFlag::kReuseFields)) {
+				field.clear();
+			}
+			return 0;
+		}
+
+		switch (req.event.type) {
+			case SAXEvent::kEndArray:
+				req.state.isEnd = true;
+				RemoveUnusedElem(field, req.state.count);
+				IJSTI_RET_WHEN_VALUE_IS_DEFAULT((field.empty()));
+				return 0;
+			case SAXEvent::kEndValue:
+				if (req.event.ret != 0)
+				{
+					RemoveUnusedElem(field, req.state.count);
+					field.pop_back();
+					resp.errDoc.ErrorInArray(static_cast<rapidjson::SizeType>(field.size()));
+				}
+				return req.event.ret;
+			default:
+			{
+				// New element
+				ElemType& elem = NextElem(field, req.state.count);
+				++req.state.count;
+				req.handler.PushValue(&IJSTI_FSERIALIZER_INS(ElemType, Encoding), &elem,
+									  FDesc::NoneFlag, req.allocator);	// element desc is always default
+				return 0;
+			}
+		}
+	}
+
 	virtual void ShrinkAllocator(void* pField) IJSTI_OVERRIDE
 	{
 		VarType& field = *static_cast<VarType *>(pField);
@@ -248,16 +753,137 @@ public:
 			intf.ShrinkAllocator(&*itField);
 		}
 	}
+
+	virtual void GetMemoryUsage(const void* pField, IJST_OUT MemoryUsage& usage) IJSTI_OVERRIDE
+	{
+		const VarType& field = *static_cast<const VarType *>(pField);
+		usage.containerBytes += ContainerStorageBytes(field);
+		SerializerInterface<Encoding>& intf = IJSTI_FSERIALIZER_INS(ElemType, Encoding);
+		for (typename VarType::const_iterator itField = field.begin(), itEnd = field.end(); itField != itEnd; ++itField)
+		{
+			intf.GetMemoryUsage(&*itField, usage);
+		}
+	}
+
+	virtual void InitSingletons(IJST_OUT std::vector<const void*>& visited) IJSTI_OVERRIDE
+	{
+		IJSTI_FSERIALIZER_INS(ElemType, Encoding).InitSingletons(visited);
+	}
+
+	virtual uint64_t GetTypeTag() IJSTI_OVERRIDE
+	{
+		return TypeTag::Container(TypeTag::kArray, IJSTI_FSERIALIZER_INS(ElemType, Encoding).GetTypeTag());
+	}
+};
+
+/**
+ * Serialization of vector of numbers.
+ * Elements are type checked and converted in a tight loop, without the request and virtual call per element,
+ * and the array is written in one pass.
+ */
+template<typename T, typename Alloc, typename Encoding>
+class NumberVectorSerializer : public ContainerSerializer<T, std::vector<T, Alloc>, Encoding> {
+	typedef std::vector<T, Alloc> VarType;
+	typedef ContainerSerializer<T, VarType, Encoding> BaseType;
+	typedef NumberTraits<T> Traits;
+public:
+	IJSTI_PROPAGATE_SINTERFACE_TYPE(Encoding);
+
+	template<typename Handler>
+	static int Serialize(const VarType& field, Handler& writer, SerFlag::Flag serFlag)
+	{
+		(void)serFlag;
+		const T* vals = field.empty() ? NULL : &field[0];
+		return WriteArray(writer, vals, static_cast<rapidjson::SizeType>(field.size())) ? 0 : ErrorCode::kWriteFailed;
+	}
+	IJSTI_DEFINE_SERIALIZE_BY_STATIC()
+
+	virtual int FromJson(const FromJsonReq &req, IJST_OUT FromJsonResp &resp) IJSTI_OVERRIDE
+	{
+		IJSTI_RET_WHEN_TYPE_MISMATCH((req.stream.IsArray()), "array");
+
+		assert(req.pFieldBuffer != NULL);
+		VarType& field = *static_cast<VarType *>(req.pFieldBuffer);
+		// All elements are overwritten, so need not to clear
+		const rapidjson::SizeType size = req.stream.Size();
+		field.resize(size);
+		const rapidjson::GenericValue<Encoding>* vals = size == 0 ? NULL : &req.stream[0];
+		for (rapidjson::SizeType i = 0; i < size; ++i)
+		{
+			if (!Traits::Is(vals[i])) {
+				field.resize(i);
+				resp.errDoc.ElementTypeMismatch(Traits::TypeName(), vals[i]);
+				resp.errDoc.ErrorInArray(i);
+				return ErrorCode::kDeserializeValueTypeError;
+			}
+			field[i] = Traits::Get(vals[i]);
+		}
+
+		IJSTI_RET_WHEN_VALUE_IS_DEFAULT((field.empty()));
+		return 0;
+	}
+
+	virtual int FromSAX(const FromSAXReq &req, IJST_OUT FromJsonResp &resp) IJSTI_OVERRIDE
+	{
+		if (req.state.isDom || !req.state.isStarted || !req.event.IsScalar()) {
+			return BaseType::FromSAX(req, resp);
+		}
+
+		// Convert scalar element directly instead of pushing it
+		VarType& field = *static_cast<VarType *>(req.state.pFieldBuffer);
+		rapidjson::GenericValue<Encoding> val;
+		req.event.ToValue(val, req.handler.GetScratchAllocator());
+		if (!Traits::Is(val)) {
+			RemoveUnusedElem(field, req.state.count);
+			resp.errDoc.ElementTypeMismatch(Traits::TypeName(), val);
+			resp.errDoc.ErrorInArray(static_cast<rapidjson::SizeType>(field.size()));
+			return ErrorCode::kDeserializeValueTypeError;
+		}
+		NextElem(field, req.state.count) = Traits::Get(val);
+		++req.state.count;
+		return 0;
+	}
+
+private:
+	template<typename Handler>
+	static bool WriteArray(Handler& writer, const T* vals, rapidjson::SizeType count)
+	{ return WriteNumberArray(writer, vals, count); }
+
+	//! Only one virtual call for the whole array
+	static bool WriteArray(HandlerBase<typename Encoding::Ch>& writer, const T* vals, rapidjson::SizeType count)
+	{ return Traits::WriteArray(writer, vals, count); }
 };
 
+//! Select serializer of vector, NumberVectorSerializer is used if element is number
+template<typename T, typename Alloc, typename Encoding, typename Enable = void>
+struct VectorSerializerSelector {
+	typedef ContainerSerializer<T, std::vector<T, Alloc>, Encoding> Type;
+};
+
+template<typename T, typename Alloc, typename Encoding>
+struct VectorSerializerSelector<T, Alloc, Encoding, /*EnableIf*/ typename HasType<typename NumberTraits<T>::ValType>::Void> {
+	typedef NumberVectorSerializer<T, Alloc, Encoding> Type;
+};
+
+//! Define the serializer of container by delegating to ImplType
 #define IJSTI_SERIALIZER_CONTAINER_DEFINE()																		\
 	IJSTI_PROPAGATE_SINTERFACE_TYPE(Encoding);																	\
-	virtual int Serialize(const SerializeReq &req) IJSTI_OVERRIDE												\
-	{ return Singleton<ContainerSerializer<T, VarType, Encoding> >().Serialize(req); }										\
+	template<typename Handler>																					\
+	static int Serialize(const VarType& field, Handler& writer, SerFlag::Flag serFlag)							\
+	{ return ImplType::Serialize(field, writer, serFlag); }														\
+	IJSTI_DEFINE_SERIALIZE_BY_STATIC()																			\
 	virtual int FromJson(const FromJsonReq &req, IJST_OUT FromJsonResp &resp) IJSTI_OVERRIDE					\
-	{ return Singleton<ContainerSerializer<T, VarType, Encoding> >().FromJson(req, resp); }									\
+	{ return Singleton<ImplType>().FromJson(req, resp); }														\
 	virtual void ShrinkAllocator(void* pField) IJSTI_OVERRIDE													\
-	{ return Singleton<ContainerSerializer<T, VarType, Encoding> >().ShrinkAllocator(pField); }
+	{ return Singleton<ImplType>().ShrinkAllocator(pField); }													\
+	virtual void GetMemoryUsage(const void* pField, IJST_OUT MemoryUsage& usage) IJSTI_OVERRIDE				\
+	{ return Singleton<ImplType>().GetMemoryUsage(pField, usage); }											\
+	virtual int FromSAX(const FromSAXReq &req, IJST_OUT FromJsonResp &resp) IJSTI_OVERRIDE						\
+	{ return Singleton<ImplType>().FromSAX(req, resp); }														\
+	virtual void InitSingletons(IJST_OUT std::vector<const void*>& visited) IJSTI_OVERRIDE						\
+	{ return Singleton<ImplType>().InitSingletons(visited); }													\
+	virtual uint64_t GetTypeTag() IJSTI_OVERRIDE																\
+	{ return Singleton<ImplType>().GetTypeTag(); }
 
 /**
  * Serialization class of Vector types
@@ -266,6 +892,7 @@ public:
 template<class T, typename Alloc, typename Encoding>
 class FSerializer<std::vector<T, Alloc>, Encoding> : public SerializerInterface<Encoding> {
 	typedef std::vector<T, Alloc> VarType;
+	typedef typename VectorSerializerSelector<T, Alloc, Encoding>::Type ImplType;
 public:
 	IJSTI_SERIALIZER_CONTAINER_DEFINE()
 };
@@ -277,6 +904,7 @@ public:
 template<class T, typename Alloc, typename Encoding>
 class FSerializer<std::deque<T, Alloc>, Encoding> : public SerializerInterface<Encoding> {
 	typedef std::deque<T, Alloc> VarType;
+	typedef ContainerSerializer<T, VarType, Encoding> ImplType;
 public:
 	IJSTI_SERIALIZER_CONTAINER_DEFINE()
 };
@@ -288,43 +916,61 @@ public:
 template<class T, typename Alloc, typename Encoding>
 class FSerializer<std::list<T, Alloc>, Encoding> : public SerializerInterface<Encoding> {
 	typedef std::list<T, Alloc> VarType;
+	typedef ContainerSerializer<T, VarType, Encoding> ImplType;
 public:
 	IJSTI_SERIALIZER_CONTAINER_DEFINE()
 };
 
-/**
- * Serialization class of Map types
- * @tparam T class
- */
-template<class T, typename Compare, typename Alloc, typename Encoding>
-class FSerializer<std::map<std::basic_string<typename Encoding::Ch>, T, Compare, Alloc>, Encoding> : public SerializerInterface<Encoding> {
+//! Reserve space for n more elements if the map supports
+template<typename VarType>
+inline void ReserveElem(VarType& /*field*/, size_t /*n*/)
+{ }
+
+#if __cplusplus >= 201103L
+template<typename Key, typename T, typename Hash, typename Pred, typename Alloc>
+inline void ReserveElem(std::unordered_map<Key, T, Hash, Pred, Alloc>& field, size_t n)
+{
+	field.reserve(field.size() + n);
+}
+#endif
+
+//! Insert a default element with key (str, length) to map, construct the key and value in place if possible
+template<typename VarType, typename Ch>
+inline std::pair<typename VarType::iterator, bool> EmplaceElem(VarType& field, const Ch* str, size_t length)
+{
+#if __cplusplus >= 201103L
+	return field.emplace(std::piecewise_construct, std::forward_as_tuple(str, length), std::forward_as_tuple());
+#else
+	return field.insert(typename VarType::value_type(typename VarType::key_type(str, length), typename VarType::mapped_type()));
+#endif
+}
+
+template<typename T, typename VarType, typename Encoding>
+class MapSerializer : public SerializerInterface<Encoding> {
 	typedef typename Encoding::Ch Ch;
-	typedef std::map<std::basic_string<Ch>, T, Compare, Alloc> VarType;
 public:
 	IJSTI_PROPAGATE_SINTERFACE_TYPE(Encoding);
 
-	virtual int Serialize(const SerializeReq &req) IJSTI_OVERRIDE
+	template<typename Handler>
+	static int Serialize(const VarType& field, Handler& writer, SerFlag::Flag serFlag)
 	{
-		assert(req.pField != NULL);
-		const VarType& field = *static_cast<const VarType *>(req.pField);
-		SerializerInterface<Encoding>& intf = IJSTI_FSERIALIZER_INS(T, Encoding);
-
-		IJSTI_RET_WHEN_WRITE_FAILD(req.writer.StartObject());
+		IJSTI_RET_WHEN_WRITE_FAILD(writer.StartObject());
 
 		for (typename VarType::const_iterator itFieldMember = field.begin(), itEnd = field.end(); itFieldMember != itEnd; ++itFieldMember)
 		{
 			const std::basic_string<Ch>& key = itFieldMember->first;
 			IJSTI_RET_WHEN_WRITE_FAILD(
-					req.writer.Key(key.data(), static_cast<rapidjson::SizeType>(key.size())) );
+					writer.Key(key.data(), static_cast<rapidjson::SizeType>(key.size())) );
 
-			SerializeReq elemReq(req.writer, &(itFieldMember->second), req.serFlag);
-			IJSTI_RET_WHEN_NOT_ZERO(intf.Serialize(elemReq));
+			IJSTI_RET_WHEN_NOT_ZERO(
+					(FSerializer<T, Encoding>::Serialize(itFieldMember->second, writer, serFlag)) );
 		}
 
 		IJSTI_RET_WHEN_WRITE_FAILD(
-				req.writer.EndObject(static_cast<rapidjson::SizeType>(field.size())) );
+				writer.EndObject(static_cast<rapidjson::SizeType>(field.size())) );
 		return 0;
 	}
+	IJSTI_DEFINE_SERIALIZE_BY_STATIC()
 
 	virtual int FromJson(const FromJsonReq &req, IJST_OUT FromJsonResp &resp) IJSTI_OVERRIDE
 	{
@@ -332,18 +978,45 @@ public:
 
 		assert(req.pFieldBuffer != NULL);
 		VarType& field = *static_cast<VarType *>(req.pFieldBuffer);
-		field.clear();
+		// Elements of the old map, which are reused by key
+		VarType oldField;
+		if (Util::IsBitSet(req.deserFlag, DeserFlag::kReuseFields)) {
+			field.swap(oldField);
+		}
+		else {
+			field.clear();
+		}
+		ReserveElem(field, req.stream.MemberCount());
 		SerializerInterface<Encoding>& intf = IJSTI_FSERIALIZER_INS(T, Encoding);
 
+		std::basic_string<Ch> key;
 		for (typename rapidjson::GenericValue<Encoding>::MemberIterator itMember = req.stream.MemberBegin(), itEnd = req.stream.MemberEnd();
 			 itMember != itEnd; ++itMember)
 		{
-			// New a elem buffer in container first to avoid copy
-			std::pair<typename VarType::iterator, bool> insertRet = field.insert(
-					std::pair<const std::basic_string<Ch>, T>(GetJsonStr(itMember->name), T()));
+			// New a elem buffer in container first to avoid copy, or move the element with same key from old map
+			std::pair<typename VarType::iterator, bool> insertRet;
+			typename VarType::iterator itOld = oldField.end();
+			if (!oldField.empty()) {
+				key.assign(itMember->name.GetString(), itMember->name.GetStringLength());
+				itOld = oldField.find(key);
+			}
+			if (itOld != oldField.end()) {
+#if __cplusplus >= 201703L
+				// Move the node, the key is never in new map since it was in old map
+				insertRet.first = field.insert(oldField.extract(itOld)).position;
+				insertRet.second = true;
+#else
+				insertRet = EmplaceElem(field, key.data(), key.size());
+				std::swap(insertRet.first->second, itOld->second);
+				oldField.erase(itOld);
+#endif
+			}
+			else {
+				insertRet = EmplaceElem(field, itMember->name.GetString(), itMember->name.GetStringLength());
+			}
 			// Check duplicate
 			if (!insertRet.second) {
-				resp.errDoc.ElementMapKeyDuplicated(GetJsonStr(itMember->name));
+				resp.errDoc.ElementMapKeyDuplicated(insertRet.first->first);
 				return ErrorCode::kDeserializeMapKeyDuplicated;
 			}
 
@@ -355,8 +1028,8 @@ public:
 			int ret = intf.FromJson(elemReq, elemResp);
 			if (ret != 0)
 			{
-				const std::basic_string<Ch> fieldName = GetJsonStr(itMember->name);
-				field.erase(fieldName);
+				const std::basic_string<Ch> fieldName = insertRet.first->first;
+				field.erase(insertRet.first);
 				resp.errDoc.ErrorInMap(fieldName);
 				return ret;
 			}
@@ -365,6 +1038,55 @@ public:
 		return 0;
 	}
 
+	virtual int FromSAX(const FromSAXReq &req, IJST_OUT FromJsonResp &resp) IJSTI_OVERRIDE
+	{
+		if (req.state.isDom || (!req.state.isStarted && req.event.type != SAXEvent::kStartObject)) {
+			return this->DomFromSAX(req, resp);
+		}
+
+		assert(req.state.pFieldBuffer != NULL);
+		VarType& field = *static_cast<VarType *>(req.state.pFieldBuffer);
+		// pCursor is the element being deserialized
+		typedef typename VarType::value_type ElemPair;
+		if (!req.state.isStarted) {
+			assert(req.event.type == SAXEvent::kStartObject);
+			req.state.isStarted = true;
+			// Elements are not reused by key here, since the old elements could not be kept between events
+			field.clear();
+			return 0;
+		}
+
+		switch (req.event.type) {
+			case SAXEvent::kEndObject:
+				req.state.isEnd = true;
+				IJSTI_RET_WHEN_VALUE_IS_DEFAULT((field.empty()));
+				return 0;
+			case SAXEvent::kKey:
+			{
+				std::pair<typename VarType::iterator, bool> insertRet = EmplaceElem(field, req.event.str, req.event.length);
+				// Check duplicate
+				if (!insertRet.second) {
+					resp.errDoc.ElementMapKeyDuplicated(insertRet.first->first);
+					return ErrorCode::kDeserializeMapKeyDuplicated;
+				}
+				req.state.pCursor = &*insertRet.first;
+				return 0;
+			}
+			case SAXEvent::kEndValue:
+				if (req.event.ret != 0)
+				{
+					const std::basic_string<Ch> fieldName = static_cast<ElemPair*>(req.state.pCursor)->first;
+					field.erase(fieldName);
+					resp.errDoc.ErrorInMap(fieldName);
+				}
+				return req.event.ret;
+			default:
+				req.handler.PushValue(&IJSTI_FSERIALIZER_INS(T, Encoding), &static_cast<ElemPair*>(req.state.pCursor)->second,
+									  FDesc::NoneFlag, req.allocator);	// element desc is always default
+				return 0;
+		}
+	}
+
 	virtual void ShrinkAllocator(void* pField) IJSTI_OVERRIDE
 	{
 		VarType& field = *static_cast<VarType *>(pField);
@@ -374,8 +1096,73 @@ public:
 			intf.ShrinkAllocator(&itField->second);
 		}
 	}
+
+	virtual void GetMemoryUsage(const void* pField, IJST_OUT MemoryUsage& usage) IJSTI_OVERRIDE
+	{
+		const VarType& field = *static_cast<const VarType *>(pField);
+		usage.containerBytes += ContainerStorageBytes(field);
+		SerializerInterface<Encoding>& intf = IJSTI_FSERIALIZER_INS(T, Encoding);
+		for (typename VarType::const_iterator itField = field.begin(), itEnd = field.end(); itField != itEnd; ++itField)
+		{
+			usage.stringBytes += StringHeapBytes(itField->first);
+			intf.GetMemoryUsage(&itField->second, usage);
+		}
+	}
+
+	virtual void InitSingletons(IJST_OUT std::vector<const void*>& visited) IJSTI_OVERRIDE
+	{
+		IJSTI_FSERIALIZER_INS(T, Encoding).InitSingletons(visited);
+	}
+
+	virtual uint64_t GetTypeTag() IJSTI_OVERRIDE
+	{
+		return TypeTag::Container(TypeTag::kObject, IJSTI_FSERIALIZER_INS(T, Encoding).GetTypeTag());
+	}
+};
+
+#define IJSTI_SERIALIZER_MAP_DEFINE()																			\
+	IJSTI_PROPAGATE_SINTERFACE_TYPE(Encoding);																	\
+	template<typename Handler>																					\
+	static int Serialize(const VarType& field, Handler& writer, SerFlag::Flag serFlag)							\
+	{ return MapSerializer<T, VarType, Encoding>::Serialize(field, writer, serFlag); }							\
+	IJSTI_DEFINE_SERIALIZE_BY_STATIC()																			\
+	virtual int FromJson(const FromJsonReq &req, IJST_OUT FromJsonResp &resp) IJSTI_OVERRIDE					\
+	{ return Singleton<MapSerializer<T, VarType, Encoding> >().FromJson(req, resp); }							\
+	virtual void ShrinkAllocator(void* pField) IJSTI_OVERRIDE													\
+	{ return Singleton<MapSerializer<T, VarType, Encoding> >().ShrinkAllocator(pField); }						\
+	virtual void GetMemoryUsage(const void* pField, IJST_OUT MemoryUsage& usage) IJSTI_OVERRIDE				\
+	{ return Singleton<MapSerializer<T, VarType, Encoding> >().GetMemoryUsage(pField, usage); }				\
+	virtual int FromSAX(const FromSAXReq &req, IJST_OUT FromJsonResp &resp) IJSTI_OVERRIDE						\
+	{ return Singleton<MapSerializer<T, VarType, Encoding> >().FromSAX(req, resp); }							\
+	virtual void InitSingletons(IJST_OUT std::vector<const void*>& visited) IJSTI_OVERRIDE						\
+	{ return Singleton<MapSerializer<T, VarType, Encoding> >().InitSingletons(visited); }						\
+	virtual uint64_t GetTypeTag() IJSTI_OVERRIDE																\
+	{ return Singleton<MapSerializer<T, VarType, Encoding> >().GetTypeTag(); }
+
+/**
+ * Serialization class of Map types
+ * @tparam T class
+ */
+template<class T, typename Compare, typename Alloc, typename Encoding>
+class FSerializer<std::map<std::basic_string<typename Encoding::Ch>, T, Compare, Alloc>, Encoding> : public SerializerInterface<Encoding> {
+	typedef std::map<std::basic_string<typename Encoding::Ch>, T, Compare, Alloc> VarType;
+public:
+	IJSTI_SERIALIZER_MAP_DEFINE()
 };
 
+#if __cplusplus >= 201103L
+/**
+ * Serialization class of Unordered map types
+ * @tparam T class
+ */
+template<class T, typename Hash, typename Pred, typename Alloc, typename Encoding>
+class FSerializer<std::unordered_map<std::basic_string<typename Encoding::Ch>, T, Hash, Pred, Alloc>, Encoding> : public SerializerInterface<Encoding> {
+	typedef std::unordered_map<std::basic_string<typename Encoding::Ch>, T, Hash, Pred, Alloc> VarType;
+public:
+	IJSTI_SERIALIZER_MAP_DEFINE()
+};
+#endif
+
 /**
  * Serialization class of Object types
  */
@@ -388,28 +1175,26 @@ class FSerializer<std::vector<T_Member<T, typename Encoding::Ch>, Alloc>, Encodi
 public:
 	IJSTI_PROPAGATE_SINTERFACE_TYPE(Encoding);
 
-	virtual int Serialize(const SerializeReq &req) IJSTI_OVERRIDE
+	template<typename Handler>
+	static int Serialize(const VarType& field, Handler& writer, SerFlag::Flag serFlag)
 	{
-		assert(req.pField != NULL);
-		const VarType& field = *static_cast<const VarType *>(req.pField);
-		SerializerInterface<Encoding>& intf = IJSTI_FSERIALIZER_INS(ValType, Encoding);
-
-		IJSTI_RET_WHEN_WRITE_FAILD(req.writer.StartObject());
+		IJSTI_RET_WHEN_WRITE_FAILD(writer.StartObject());
 
 		for (typename VarType::const_iterator itMember = field.begin(), itEnd = field.end(); itMember != itEnd; ++itMember)
 		{
 			const std::basic_string<Ch>& key = itMember->name;
 			IJSTI_RET_WHEN_WRITE_FAILD(
-					req.writer.Key(key.data(), static_cast<rapidjson::SizeType>(key.size())) );
+					writer.Key(key.data(), static_cast<rapidjson::SizeType>(key.size())) );
 
-			SerializeReq elemReq(req.writer, &(itMember->value), req.serFlag);
-			IJSTI_RET_WHEN_NOT_ZERO(intf.Serialize(elemReq));
+			IJSTI_RET_WHEN_NOT_ZERO(
+					(FSerializer<ValType, Encoding>::Serialize(itMember->value, writer, serFlag)) );
 		}
 
 		IJSTI_RET_WHEN_WRITE_FAILD(
-				req.writer.EndObject(static_cast<rapidjson::SizeType>(field.size())) );
+				writer.EndObject(static_cast<rapidjson::SizeType>(field.size())) );
 		return 0;
 	}
+	IJSTI_DEFINE_SERIALIZE_BY_STATIC()
 
 	virtual int FromJson(const FromJsonReq &req, IJST_OUT FromJsonResp &resp) IJSTI_OVERRIDE
 	{
@@ -417,7 +1202,9 @@ public:
 
 		assert(req.pFieldBuffer != NULL);
 		VarType& field = *static_cast<VarType *>(req.pFieldBuffer);
-		field.clear();
+		if (!Util::IsBitSet(req.deserFlag, DeserFlag::kReuseFields)) {
+			field.clear();
+		}
 		// pField->shrink_to_fit();
 		SerializerInterface<Encoding>& intf = IJSTI_FSERIALIZER_INS(ValType, Encoding);
 
@@ -430,7 +1217,7 @@ public:
 		{
 			assert(i < field.size());
 			MemberType& memberBuf = field[i];
-			memberBuf.name = GetJsonStr(itMember->name);
+			memberBuf.name.assign(itMember->name.GetString(), itMember->name.GetStringLength());
 			ValType &elemBuffer = memberBuf.value;
 			FromJsonReq elemReq(itMember->value, req.allocator,
 								req.deserFlag, req.canMoveSrc, &elemBuffer, FDesc::NoneFlag);	// element desc is always default
@@ -449,6 +1236,49 @@ public:
 		return 0;
 	}
 
+	virtual int FromSAX(const FromSAXReq &req, IJST_OUT FromJsonResp &resp) IJSTI_OVERRIDE
+	{
+		if (req.state.isDom || (!req.state.isStarted && req.event.type != SAXEvent::kStartObject)) {
+			return this->DomFromSAX(req, resp);
+		}
+
+		assert(req.state.pFieldBuffer != NULL);
+		VarType& field = *static_cast<VarType *>(req.state.pFieldBuffer);
+		// count is the count of members deserialized, and the last one is being deserialized
+		if (!req.state.isStarted) {
+			assert(req.event.type == SAXEvent::kStartObject);
+			req.state.isStarted = true;
+			if (!Util::IsBitSet(req.deserFlag, DeserFlag::kReuseFields)) {
+				field.clear();
+			}
+			return 0;
+		}
+
+		switch (req.event.type) {
+			case SAXEvent::kEndObject:
+				req.state.isEnd = true;
+				RemoveUnusedElem(field, req.state.count);
+				IJSTI_RET_WHEN_VALUE_IS_DEFAULT((field.empty()));
+				return 0;
+			case SAXEvent::kKey:
+				NextElem(field, req.state.count).name.assign(req.event.str, req.event.length);
+				++req.state.count;
+				return 0;
+			case SAXEvent::kEndValue:
+				if (req.event.ret != 0)
+				{
+					RemoveUnusedElem(field, req.state.count);
+					resp.errDoc.ErrorInMap(field.back().name);
+					field.pop_back();
+				}
+				return req.event.ret;
+			default:
+				req.handler.PushValue(&IJSTI_FSERIALIZER_INS(ValType, Encoding), &field[req.state.count - 1].value,
+									  FDesc::NoneFlag, req.allocator);	// element desc is always default
+				return 0;
+		}
+	}
+
 	virtual void ShrinkAllocator(void* pField) IJSTI_OVERRIDE
 	{
 		VarType& field = *static_cast<VarType*>(pField);
@@ -458,6 +1288,128 @@ public:
 			intf.ShrinkAllocator(&itField->value);
 		}
 	}
+
+	virtual void GetMemoryUsage(const void* pField, IJST_OUT MemoryUsage& usage) IJSTI_OVERRIDE
+	{
+		const VarType& field = *static_cast<const VarType*>(pField);
+		usage.containerBytes += ContainerStorageBytes(field);
+		SerializerInterface<Encoding>& intf = IJSTI_FSERIALIZER_INS(ValType, Encoding);
+		for (typename VarType::const_iterator itField = field.begin(), itEnd = field.end(); itField != itEnd; ++itField)
+		{
+			usage.stringBytes += StringHeapBytes(itField->name);
+			intf.GetMemoryUsage(&itField->value, usage);
+		}
+	}
+
+	virtual void InitSingletons(IJST_OUT std::vector<const void*>& visited) IJSTI_OVERRIDE
+	{
+		IJSTI_FSERIALIZER_INS(ValType, Encoding).InitSingletons(visited);
+	}
+
+	virtual uint64_t GetTypeTag() IJSTI_OVERRIDE
+	{
+		return TypeTag::Container(TypeTag::kObject, IJSTI_FSERIALIZER_INS(ValType, Encoding).GetTypeTag());
+	}
+};
+
+/**
+ * Serialization class of flat map types.
+ * Members are deserialized by the serializer of object types, then sorted and checked duplicated once.
+ */
+template<class T, typename Alloc, typename Encoding>
+class FSerializer<T_FlatMap<T, typename Encoding::Ch, Alloc>, Encoding> : public SerializerInterface<Encoding> {
+	typedef typename Encoding::Ch Ch;
+	typedef T_FlatMap<T, Ch, Alloc> VarType;
+	typedef typename VarType::container_type ContainerType;
+	typedef FSerializer<ContainerType, Encoding> ContainerSerializer;
+public:
+	IJSTI_PROPAGATE_SINTERFACE_TYPE(Encoding);
+
+	template<typename Handler>
+	static int Serialize(const VarType& field, Handler& writer, SerFlag::Flag serFlag)
+	{ return ContainerSerializer::Serialize(field.m_members, writer, serFlag); }
+	IJSTI_DEFINE_SERIALIZE_BY_STATIC()
+
+	virtual int FromJson(const FromJsonReq &req, IJST_OUT FromJsonResp &resp) IJSTI_OVERRIDE
+	{
+		assert(req.pFieldBuffer != NULL);
+		VarType& field = *static_cast<VarType *>(req.pFieldBuffer);
+		FromJsonReq containerReq(req.stream, req.allocator, req.deserFlag, req.canMoveSrc, &field.m_members, req.fDesc);
+		const int ret = Singleton<ContainerSerializer>().FromJson(containerReq, resp);
+		// Keep sorted even if error occurs
+		return SortAndCheck(field.m_members, ret, resp);
+	}
+
+	virtual int FromSAX(const FromSAXReq &req, IJST_OUT FromJsonResp &resp) IJSTI_OVERRIDE
+	{
+		if (req.state.isDom || (!req.state.isStarted && req.event.type != SAXEvent::kStartObject)) {
+			return this->DomFromSAX(req, resp);
+		}
+
+		assert(req.state.pFieldBuffer != NULL);
+		VarType& field = *static_cast<VarType *>(req.state.pFieldBuffer);
+		req.state.pFieldBuffer = &field.m_members;
+		int ret = Singleton<ContainerSerializer>().FromSAX(req, resp);
+		req.state.pFieldBuffer = &field;
+		if (req.event.type == SAXEvent::kEndObject || (req.event.type == SAXEvent::kEndValue && ret != 0)) {
+			ret = SortAndCheck(field.m_members, ret, resp);
+		}
+		return ret;
+	}
+
+	virtual void ShrinkAllocator(void* pField) IJSTI_OVERRIDE
+	{
+		VarType& field = *static_cast<VarType*>(pField);
+		Singleton<ContainerSerializer>().ShrinkAllocator(&field.m_members);
+	}
+
+	virtual void GetMemoryUsage(const void* pField, IJST_OUT MemoryUsage& usage) IJSTI_OVERRIDE
+	{
+		const VarType& field = *static_cast<const VarType*>(pField);
+		Singleton<ContainerSerializer>().GetMemoryUsage(&field.m_members, usage);
+	}
+
+	virtual void InitSingletons(IJST_OUT std::vector<const void*>& visited) IJSTI_OVERRIDE
+	{
+		Singleton<ContainerSerializer>().InitSingletons(visited);
+	}
+
+	virtual uint64_t GetTypeTag() IJSTI_OVERRIDE
+	{
+		return Singleton<ContainerSerializer>().GetTypeTag();
+	}
+
+private:
+	//! Sort members by name, and remove the duplicated ones in one pass.
+	//! Duplicated key is reported only when there is no previous error
+	static int SortAndCheck(ContainerType& members, int prevRet, IJST_OUT FromJsonResp &resp)
+	{
+		std::sort(members.begin(), members.end(), typename VarType::LessName());
+		if (members.empty()) {
+			return prevRet;
+		}
+
+		typename ContainerType::iterator itLast = members.begin();
+		typename ContainerType::iterator itDup = members.end();
+		for (typename ContainerType::iterator it = itLast + 1, itEnd = members.end(); it != itEnd; ++it) {
+			if (it->name == itLast->name) {
+				if (itDup == members.end() && prevRet == 0) {
+					resp.errDoc.ElementMapKeyDuplicated(it->name);
+				}
+				itDup = it;
+				continue;
+			}
+			++itLast;
+			if (itLast != it) {
+				std::swap(*itLast, *it);
+			}
+		}
+		if (itDup == members.end()) {
+			return prevRet;
+		}
+		members.erase(itLast + 1, members.end());
+		return prevRet != 0 ? prevRet : ErrorCode::kDeserializeMapKeyDuplicated;
+	}
 };
 
 }	// namespace detail
@@ -36,6 +36,11 @@ typedef double 					T_double;
 #define IJST_TSTR				::std::basic_string<_ijst_Ch>
 //! string -> std::string, for backward compatibility
 typedef std::string 			T_string;
+//! string -> a view of string in the source of deserialization
+#define IJST_TSTRVIEW			::ijst::T_GenericStrView<_ijst_Ch>
+//! string -> a view of char string
+template<typename CharType> class T_GenericStrView;
+typedef T_GenericStrView<char> 	T_strview;
 //! anything -> a wrapper of rapidjson::GenericValue<Encoding>
 #define IJST_TRAW				::ijst::T_GenericRaw<_ijst_Encoding>
 //! anything -> a wrapper of rapidjson::Value, for backward compatibility
@@ -59,6 +64,64 @@ private:
 	bool m_val;
 };
 
+/**
+ * @brief View of string, which points to the string in the source of deserialization instead of copying it.
+ *
+ * When the source is moved during deserialization (DeserFlag::kMoveFromIntermediateDoc, MoveFromJson(), or in
+ * ArenaScope), the view points to the string in the document, or to the source buffer if it is parsed in situ.
+ * Otherwise the string is copied to the allocator of the accessor, instead of allocating a std::basic_string.
+ *
+ * @tparam CharType		character type
+ *
+ * @note	The view is not always null-terminated.
+ * @note	The view is invalid after the memory it points to is released, e.g., the allocator is cleared when the
+ * 			object is deserialized again or ShrinkAllocator() is called, or the source buffer is freed.
+ */
+template<typename CharType>
+class T_GenericStrView {
+public:
+	typedef CharType Ch;
+
+	T_GenericStrView() : m_str(EmptyStr()), m_length(0) {}
+	T_GenericStrView(const Ch* str) : m_str(str), m_length(std::char_traits<Ch>::length(str)) {}
+	T_GenericStrView(const Ch* str, std::size_t length) : m_str(str), m_length(length) {}
+	template<typename Traits, typename Alloc>
+	T_GenericStrView(const std::basic_string<Ch, Traits, Alloc>& str) : m_str(str.data()), m_length(str.length()) {}
+
+	const Ch* data() const { return m_str; }
+	std::size_t size() const { return m_length; }
+	std::size_t length() const { return m_length; }
+	bool empty() const { return m_length == 0; }
+	const Ch& operator[](std::size_t pos) const { return m_str[pos]; }
+
+	//! Copy to std::basic_string
+	std::basic_string<Ch> str() const { return std::basic_string<Ch>(m_str, m_length); }
+
+	int compare(const T_GenericStrView& rhs) const
+	{
+		const std::size_t minLength = m_length < rhs.m_length ? m_length : rhs.m_length;
+		const int ret = std::char_traits<Ch>::compare(m_str, rhs.m_str, minLength);
+		if (ret != 0) {
+			return ret;
+		}
+		return m_length == rhs.m_length ? 0 : (m_length < rhs.m_length ? -1 : 1);
+	}
+
+	friend bool operator==(const T_GenericStrView& lhs, const T_GenericStrView& rhs) { return lhs.compare(rhs) == 0; }
+	friend bool operator!=(const T_GenericStrView& lhs, const T_GenericStrView& rhs) { return lhs.compare(rhs) != 0; }
+	friend bool operator<(const T_GenericStrView& lhs, const T_GenericStrView& rhs) { return lhs.compare(rhs) < 0; }
+
+private:
+	static const Ch* EmptyStr()
+	{
+		static const Ch empty[1] = {Ch()};
+		return empty;
+	}
+
+	const Ch* m_str;
+	std::size_t m_length;
+};
+
 /**
  * @brief Object that contain raw rapidjson::Value and Allocator.
  *
@@ -68,15 +131,15 @@ template<typename Encoding>
 class T_GenericRaw {
 public:
 	T_GenericRaw()
+		: m_pOwnAllocator(NULL), m_pAllocator(NULL)
 	{
-		m_pOwnAllocator = new detail::JsonAllocator();
-		m_pAllocator = m_pOwnAllocator;
+		ResetAllocator();
 	}
 
 	T_GenericRaw(const T_GenericRaw &rhs)
+		: m_pOwnAllocator(NULL), m_pAllocator(NULL)
 	{
-		m_pOwnAllocator = new detail::JsonAllocator();
-		m_pAllocator = m_pOwnAllocator;
+		ResetAllocator();
 		v.CopyFrom(rhs.v, *m_pAllocator);
 	}
 
@@ -100,7 +163,7 @@ public:
 			return;
 		}
 
-		delete m_pOwnAllocator;
+		detail::DeleteResource(m_pOwnAllocator);
 		m_pOwnAllocator = rhs.m_pOwnAllocator;
 		rhs.m_pOwnAllocator = NULL;
 
@@ -111,7 +174,7 @@ public:
 
 	~T_GenericRaw()
 	{
-		delete m_pOwnAllocator;
+		detail::DeleteResource(m_pOwnAllocator);
 		m_pOwnAllocator = NULL;
 	}
 
@@ -122,12 +185,25 @@ public:
 	rapidjson::MemoryPoolAllocator<>& GetAllocator() {return *m_pAllocator;}
 	const rapidjson::MemoryPoolAllocator<>& GetAllocator() const {return *m_pAllocator;}
 	//! See ijst::Accessor::GetOwnAllocator
-	rapidjson::MemoryPoolAllocator<>& GetOwnAllocator() {return *m_pOwnAllocator;}
-	const rapidjson::MemoryPoolAllocator<>& GetOwnAllocator() const {return *m_pOwnAllocator;}
+	rapidjson::MemoryPoolAllocator<>& GetOwnAllocator()
+	{
+		if (m_pOwnAllocator == NULL) {
+			m_pOwnAllocator = detail::NewResource<detail::JsonAllocator>();
+		}
+		return *m_pOwnAllocator;
+	}
+	const rapidjson::MemoryPoolAllocator<>& GetOwnAllocator() const {return const_cast<T_GenericRaw*>(this)->GetOwnAllocator();}
 
 private:
 	typedef rapidjson::GenericValue<Encoding> TValue;
 
+	//! Use allocator of ArenaScope if it is alive, or own allocator else
+	void ResetAllocator()
+	{
+		detail::JsonAllocator* pArenaAllocator = ArenaScope::GetCurrentAllocator();
+		m_pAllocator = (pArenaAllocator != NULL) ? pArenaAllocator : &GetOwnAllocator();
+	}
+
 	friend class detail::FSerializer<T_GenericRaw, Encoding>;
 	detail::JsonAllocator* m_pOwnAllocator;
 	detail::JsonAllocator* m_pAllocator;
@@ -151,11 +227,13 @@ namespace detail {
 
 //--- T_ubool
 IJSTI_DEFINE_SERIALIZE_INTERFACE_BEGIN(T_ubool)
-	virtual int Serialize(const SerializeReq &req) IJSTI_OVERRIDE
+	template<typename Handler>
+	static int Serialize(const VarType& field, Handler& writer, SerFlag::Flag serFlag)
 	{
-		const VarType *pField = static_cast<const VarType *>(req.pField);
-		return (req.writer.Bool((*pField) != 0) ? 0 : ErrorCode::kWriteFailed);
+		(void)serFlag;
+		return (writer.Bool(field != 0) ? 0 : ErrorCode::kWriteFailed);
 	}
+	IJSTI_DEFINE_SERIALIZE_BY_STATIC()
 
 	virtual int FromJson(const FromJsonReq &req, IJST_OUT FromJsonResp &resp) IJSTI_OVERRIDE
 	{
@@ -166,15 +244,20 @@ IJSTI_DEFINE_SERIALIZE_INTERFACE_BEGIN(T_ubool)
 		*pField = static_cast<VarType>(req.stream.GetBool() ? 1 : 0);
 		return 0;
 	}
+
+	virtual uint64_t GetTypeTag() IJSTI_OVERRIDE
+	{ return TypeTag::kBool; }
 IJSTI_DEFINE_SERIALIZE_INTERFACE_END()
 
 
 #define IJSTI_SERIALIZER_BOOL_DEFINE()																			\
-	virtual int Serialize(const SerializeReq &req) IJSTI_OVERRIDE												\
+	template<typename Handler>																					\
+	static int Serialize(const VarType& field, Handler& writer, SerFlag::Flag serFlag)							\
 	{																											\
-		const VarType *pField = static_cast<const VarType *>(req.pField);										\
-		return (req.writer.Bool(*pField) ? 0 : ErrorCode::kWriteFailed);										\
+		(void)serFlag;																							\
+		return (writer.Bool(field) ? 0 : ErrorCode::kWriteFailed);												\
 	}																											\
+	IJSTI_DEFINE_SERIALIZE_BY_STATIC()																			\
 																												\
 
 #define IJSTI_SERIALIZER_BOOL_DEFINE_FROM_JSON()																\
@@ -185,7 +268,10 @@ IJSTI_DEFINE_SERIALIZE_INTERFACE_END()
 		*pField = req.stream.GetBool();																			\
 		IJSTI_RET_WHEN_VALUE_IS_DEFAULT((*pField == false));													\
 		return 0;																								\
-	}
+	}																											\
+																												\
+	virtual uint64_t GetTypeTag() IJSTI_OVERRIDE																\
+	{ return TypeTag::kBool; }
 
 
 //--- T_bool
@@ -200,125 +286,168 @@ IJSTI_DEFINE_SERIALIZE_INTERFACE_BEGIN(T_wbool)
 	IJSTI_SERIALIZER_BOOL_DEFINE_FROM_JSON()
 IJSTI_DEFINE_SERIALIZE_INTERFACE_END()
 
+#define IJSTI_SERIALIZER_NUMBER_DEFINE()																		\
+	template<typename Handler>																					\
+	static int Serialize(const VarType& field, Handler& writer, SerFlag::Flag serFlag)							\
+	{																											\
+		(void)serFlag;																							\
+		return (NumberTraits<VarType>::Write(writer, field) ? 0 : ErrorCode::kWriteFailed);						\
+	}																											\
+	IJSTI_DEFINE_SERIALIZE_BY_STATIC()																			\
+																												\
+	virtual int FromJson(const FromJsonReq &req, IJST_OUT FromJsonResp &resp) IJSTI_OVERRIDE					\
+	{																											\
+		IJSTI_RET_WHEN_TYPE_MISMATCH((NumberTraits<VarType>::Is(req.stream)), NumberTraits<VarType>::TypeName());	\
+		VarType *pField = static_cast<VarType *>(req.pFieldBuffer);												\
+		*pField = NumberTraits<VarType>::Get(req.stream);														\
+		IJSTI_RET_WHEN_VALUE_IS_DEFAULT((*pField == 0));														\
+		return 0;																								\
+	}																											\
+																												\
+	virtual uint64_t GetTypeTag() IJSTI_OVERRIDE																\
+	{ return NumberTraits<VarType>::Tag(); }
+
 //--- T_int
 IJSTI_DEFINE_SERIALIZE_INTERFACE_BEGIN(T_int)
-	virtual int Serialize(const SerializeReq &req) IJSTI_OVERRIDE
-	{
-		const VarType *pField = static_cast<const VarType *>(req.pField);
-		return (req.writer.Int(*pField) ? 0 : ErrorCode::kWriteFailed);
-	}
-
-	virtual int FromJson(const FromJsonReq &req, IJST_OUT FromJsonResp &resp) IJSTI_OVERRIDE
-	{
-		IJSTI_RET_WHEN_TYPE_MISMATCH((req.stream.IsInt()), "int");
-		VarType *pField = static_cast<VarType *>(req.pFieldBuffer);
-		*pField = req.stream.GetInt();
-		IJSTI_RET_WHEN_VALUE_IS_DEFAULT((*pField == 0));
-		return 0;
-	}
+	IJSTI_SERIALIZER_NUMBER_DEFINE()
 IJSTI_DEFINE_SERIALIZE_INTERFACE_END()
 
 //--- T_int64
 IJSTI_DEFINE_SERIALIZE_INTERFACE_BEGIN(T_int64)
-	virtual int Serialize(const SerializeReq &req) IJSTI_OVERRIDE
-	{
-		const VarType *pField = static_cast<const VarType *>(req.pField);
-		return (req.writer.Int64(*pField) ? 0 : ErrorCode::kWriteFailed);
-	}
-
-	virtual int FromJson(const FromJsonReq &req, IJST_OUT FromJsonResp &resp) IJSTI_OVERRIDE
-	{
-		IJSTI_RET_WHEN_TYPE_MISMATCH((req.stream.IsInt64()), "int64");
-		VarType *pField = static_cast<VarType *>(req.pFieldBuffer);
-		*pField = req.stream.GetInt64();
-		IJSTI_RET_WHEN_VALUE_IS_DEFAULT((*pField == 0));
-		return 0;
-	}
+	IJSTI_SERIALIZER_NUMBER_DEFINE()
 IJSTI_DEFINE_SERIALIZE_INTERFACE_END()
 
 //--- T_uint
 IJSTI_DEFINE_SERIALIZE_INTERFACE_BEGIN(T_uint)
-	virtual int Serialize(const SerializeReq &req) IJSTI_OVERRIDE
-	{
-		const VarType *pField = static_cast<const VarType *>(req.pField);
-		return (req.writer.Uint(*pField) ? 0 : ErrorCode::kWriteFailed);
-	}
-
-	virtual int FromJson(const FromJsonReq &req, IJST_OUT FromJsonResp &resp) IJSTI_OVERRIDE
-	{
-		IJSTI_RET_WHEN_TYPE_MISMATCH((req.stream.IsUint()), "uint");
-		VarType *pField = static_cast<VarType *>(req.pFieldBuffer);
-		*pField = req.stream.GetUint();
-		IJSTI_RET_WHEN_VALUE_IS_DEFAULT((*pField == 0));
-		return 0;
-	}
+	IJSTI_SERIALIZER_NUMBER_DEFINE()
 IJSTI_DEFINE_SERIALIZE_INTERFACE_END()
 
 //--- T_uint64
 IJSTI_DEFINE_SERIALIZE_INTERFACE_BEGIN(T_uint64)
-	virtual int Serialize(const SerializeReq &req) IJSTI_OVERRIDE
+	IJSTI_SERIALIZER_NUMBER_DEFINE()
+IJSTI_DEFINE_SERIALIZE_INTERFACE_END()
+
+//--- T_double
+IJSTI_DEFINE_SERIALIZE_INTERFACE_BEGIN(T_double)
+	IJSTI_SERIALIZER_NUMBER_DEFINE()
+IJSTI_DEFINE_SERIALIZE_INTERFACE_END()
+
+//--- IJST_TSTR
+template<typename Traits, typename Alloc, typename Encoding>
+class FSerializer<std::basic_string<typename Encoding::Ch, Traits, Alloc>, Encoding> : public SerializerInterface<Encoding> {
+	typedef std::basic_string<typename Encoding::Ch, Traits, Alloc> VarType;
+	IJSTI_PROPAGATE_SINTERFACE_TYPE(Encoding);
+public:
+	template<typename Handler>
+	static int Serialize(const VarType& field, Handler& writer, SerFlag::Flag serFlag)
 	{
-		const VarType *pField = static_cast<const VarType *>(req.pField);
-		return (req.writer.Uint64(*pField) ? 0 : ErrorCode::kWriteFailed);
+		(void)serFlag;
+		return (writer.String(field.data(), static_cast<rapidjson::SizeType>(field.size())) ? 0 : ErrorCode::kWriteFailed);
 	}
+	IJSTI_DEFINE_SERIALIZE_BY_STATIC()
 
 	virtual int FromJson(const FromJsonReq &req, IJST_OUT FromJsonResp &resp) IJSTI_OVERRIDE
 	{
-		IJSTI_RET_WHEN_TYPE_MISMATCH((req.stream.IsUint64()), "uint64");
+		IJSTI_RET_WHEN_TYPE_MISMATCH((req.stream.IsString()), "string");
 		VarType *pField = static_cast<VarType *>(req.pFieldBuffer);
-		*pField = req.stream.GetUint64();
-		IJSTI_RET_WHEN_VALUE_IS_DEFAULT((*pField == 0));
+		pField->assign(req.stream.GetString(), req.stream.GetStringLength());
+		IJSTI_RET_WHEN_VALUE_IS_DEFAULT((pField->empty()));
 		return 0;
 	}
-IJSTI_DEFINE_SERIALIZE_INTERFACE_END()
 
-//--- T_double
-IJSTI_DEFINE_SERIALIZE_INTERFACE_BEGIN(T_double)
-	virtual int Serialize(const SerializeReq &req) IJSTI_OVERRIDE
+	virtual int FromSAX(const FromSAXReq &req, IJST_OUT FromJsonResp &resp) IJSTI_OVERRIDE
 	{
-		const VarType *pField = static_cast<const VarType *>(req.pField);
-		return (req.writer.Double(*pField) ? 0 : ErrorCode::kWriteFailed);
+		if (req.event.type != SAXEvent::kString) {
+			return this->DomFromSAX(req, resp);
+		}
+		VarType *pField = static_cast<VarType *>(req.state.pFieldBuffer);
+		pField->assign(req.event.str, req.event.length);
+		req.state.isEnd = true;
+		IJSTI_RET_WHEN_VALUE_IS_DEFAULT((pField->empty()));
+		return 0;
 	}
 
-	virtual int FromJson(const FromJsonReq &req, IJST_OUT FromJsonResp &resp) IJSTI_OVERRIDE
+	virtual void GetMemoryUsage(const void* pField, IJST_OUT MemoryUsage& usage) IJSTI_OVERRIDE
 	{
-		IJSTI_RET_WHEN_TYPE_MISMATCH((req.stream.IsNumber()), "number");
-		VarType *pField = static_cast<VarType *>(req.pFieldBuffer);
-		*pField = req.stream.GetDouble();
-		IJSTI_RET_WHEN_VALUE_IS_DEFAULT((*pField == 0.0));
-		return 0;
+		usage.stringBytes += StringHeapBytes(*static_cast<const VarType*>(pField));
 	}
-IJSTI_DEFINE_SERIALIZE_INTERFACE_END()
 
-//--- IJST_TSTR
-template<typename Traits, typename Alloc, typename Encoding>
-class FSerializer<std::basic_string<typename Encoding::Ch, Traits, Alloc>, Encoding> : public SerializerInterface<Encoding> {
-	typedef std::basic_string<typename Encoding::Ch, Traits, Alloc> VarType;
+	virtual uint64_t GetTypeTag() IJSTI_OVERRIDE
+	{ return TypeTag::kString; }
+};
+
+//--- IJST_TSTRVIEW
+template<typename Encoding>
+class FSerializer<T_GenericStrView<typename Encoding::Ch>, Encoding> : public SerializerInterface<Encoding> {
+	typedef typename Encoding::Ch Ch;
+	typedef T_GenericStrView<Ch> VarType;
 	IJSTI_PROPAGATE_SINTERFACE_TYPE(Encoding);
 public:
-	virtual int Serialize(const SerializeReq &req) IJSTI_OVERRIDE
+	template<typename Handler>
+	static int Serialize(const VarType& field, Handler& writer, SerFlag::Flag serFlag)
 	{
-		const VarType& field = *static_cast<const VarType *>(req.pField);
-		return (req.writer.String(field.data(), static_cast<rapidjson::SizeType>(field.size())) ? 0 : ErrorCode::kWriteFailed);
+		(void)serFlag;
+		return (writer.String(field.data(), static_cast<rapidjson::SizeType>(field.size())) ? 0 : ErrorCode::kWriteFailed);
 	}
+	IJSTI_DEFINE_SERIALIZE_BY_STATIC()
 
 	virtual int FromJson(const FromJsonReq &req, IJST_OUT FromJsonResp &resp) IJSTI_OVERRIDE
 	{
 		IJSTI_RET_WHEN_TYPE_MISMATCH((req.stream.IsString()), "string");
 		VarType *pField = static_cast<VarType *>(req.pFieldBuffer);
-		*pField = VarType(req.stream.GetString(), req.stream.GetStringLength());
+		const Ch* str = req.stream.GetString();
+		const rapidjson::SizeType length = req.stream.GetStringLength();
+
+		// The source is kept by accessor when it could be moved, except short string that stored in the value itself
+		const char* pValueBegin = reinterpret_cast<const char*>(&req.stream);
+		const char* pStr = reinterpret_cast<const char*>(str);
+		if (req.canMoveSrc && (pStr < pValueBegin || pStr >= pValueBegin + sizeof(req.stream))) {
+			*pField = VarType(str, length);
+		}
+		else {
+			*pField = CopyToAllocator(str, length, req.allocator);
+		}
+		IJSTI_RET_WHEN_VALUE_IS_DEFAULT((pField->empty()));
+		return 0;
+	}
+
+	virtual int FromSAX(const FromSAXReq &req, IJST_OUT FromJsonResp &resp) IJSTI_OVERRIDE
+	{
+		if (req.event.type != SAXEvent::kString) {
+			return this->DomFromSAX(req, resp);
+		}
+		VarType *pField = static_cast<VarType *>(req.state.pFieldBuffer);
+		*pField = CopyToAllocator(req.event.str, req.event.length, req.allocator);
+		req.state.isEnd = true;
 		IJSTI_RET_WHEN_VALUE_IS_DEFAULT((pField->empty()));
 		return 0;
 	}
+
+	virtual uint64_t GetTypeTag() IJSTI_OVERRIDE
+	{ return TypeTag::kString; }
+
+private:
+	static VarType CopyToAllocator(const Ch* str, std::size_t length, JsonAllocator& allocator)
+	{
+		if (length == 0) {
+			return VarType();
+		}
+		Ch* buffer = static_cast<Ch*>(allocator.Malloc((length + 1) * sizeof(Ch)));
+		std::char_traits<Ch>::copy(buffer, str, length);
+		buffer[length] = Ch();
+		return VarType(buffer, length);
+	}
 };
 
 //--- IJST_TRAW
 IJSTI_DEFINE_SERIALIZE_INTERFACE_BEGIN(T_GenericRaw<Encoding>)
-	virtual int Serialize(const SerializeReq &req) IJSTI_OVERRIDE
+	template<typename Handler>
+	static int Serialize(const VarType& field, Handler& writer, SerFlag::Flag serFlag)
 	{
-		const VarType *pField = static_cast<const VarType *>(req.pField);
-		return (pField->V().Accept(req.writer) ? 0 : ErrorCode::kWriteFailed);
+		(void)serFlag;
+		return (field.V().Accept(writer) ? 0 : ErrorCode::kWriteFailed);
 	}
+	IJSTI_DEFINE_SERIALIZE_BY_STATIC()
 
 	virtual int FromJson(const FromJsonReq &req, IJST_OUT FromJsonResp &resp) IJSTI_OVERRIDE
 	{
@@ -330,13 +459,30 @@ IJSTI_DEFINE_SERIALIZE_INTERFACE_BEGIN(T_GenericRaw<Encoding>)
 			pField->v.Swap(req.stream);
 		}
 		else {
-			pField->m_pAllocator = pField->m_pOwnAllocator;
+			pField->ResetAllocator();
 			pField->v.CopyFrom(req.stream, *pField->m_pAllocator);
 		}
 		IJSTI_RET_WHEN_VALUE_IS_DEFAULT((pField->v.IsNull()));
 		return 0;
 	}
 
+	virtual int FromSAX(const FromSAXReq &req, IJST_OUT FromJsonResp &resp) IJSTI_OVERRIDE
+	{
+		VarType *pField = static_cast<VarType *>(req.state.pFieldBuffer);
+		if (!req.state.isStarted) {
+			// Build value in own allocator (or allocator of arena) directly
+			req.state.isStarted = true;
+			pField->ResetAllocator();
+			req.handler.PushDom(&pField->v, *pField->m_pAllocator);
+			return 0;
+		}
+
+		assert(req.event.type == SAXEvent::kEndValue);
+		req.state.isEnd = true;
+		IJSTI_RET_WHEN_VALUE_IS_DEFAULT((pField->v.IsNull()));
+		return 0;
+	}
+
 	virtual void ShrinkAllocator(void *pField) IJSTI_OVERRIDE
 	{
 		VarType& field = *static_cast<VarType*>(pField);
@@ -348,15 +494,27 @@ IJSTI_DEFINE_SERIALIZE_INTERFACE_BEGIN(T_GenericRaw<Encoding>)
 		}
 
 		// new allocator and value
-		detail::JsonAllocator* newAllocaltor = new detail::JsonAllocator();
+		detail::JsonAllocator* newAllocaltor = detail::NewResource<detail::JsonAllocator>();
 		typename VarType::TValue newVal(field.v, *newAllocaltor);
 
 		// swap back
 		field.v.Swap(newVal);
-		delete field.m_pOwnAllocator;
+		detail::DeleteResource(field.m_pOwnAllocator);
 		field.m_pOwnAllocator = newAllocaltor;
 		field.m_pAllocator = newAllocaltor;
 	}
+
+	virtual void GetMemoryUsage(const void* pField, IJST_OUT MemoryUsage& usage) IJSTI_OVERRIDE
+	{
+		const VarType& field = *static_cast<const VarType*>(pField);
+		// Value in outer allocator is counted by the owner of allocator
+		if (field.m_pOwnAllocator != NULL) {
+			AddAllocatorUsage(*field.m_pOwnAllocator, usage);
+		}
+	}
+
+	virtual uint64_t GetTypeTag() IJSTI_OVERRIDE
+	{ return TypeTag::kRaw; }
 IJSTI_DEFINE_SERIALIZE_INTERFACE_END()
 
 }	//namespace detail
@@ -250,6 +250,71 @@ TEST(BasicAPI, HashCollision)
 	CheckFieldInfo<rapidjson::UTF8<> >(metaInfo, "int_4", "altarages", (char*)&st.int_4 - (char*)&st, FDesc::NoneFlag);
 }
 
+IJST_DEFINE_STRUCT(
+		WideSt
+		, (T_int, f00, "a")
+		, (T_int, f01, "b")
+		, (T_int, f02, "ab")
+		, (T_int, f03, "ba")
+		, (T_int, f04, "abc")
+		, (T_int, f05, "cba")
+		, (T_int, f06, "id")
+		, (T_int, f07, "ID")
+		, (T_int, f08, "Id")
+		, (T_int, f09, "name")
+		, (T_int, f10, "names")
+		, (T_int, f11, "name_")
+		, (T_int, f12, "_name")
+		, (T_int, f13, "value")
+		, (T_int, f14, "val")
+		, (T_int, f15, "v")
+		, (T_int, f16, "x0")
+		, (T_int, f17, "x1")
+		, (T_int, f18, "x2")
+		, (T_int, f19, "x3")
+		, (T_int, f20, "x4")
+		, (T_int, f21, "x5")
+		, (T_int, f22, "x6")
+		, (T_int, f23, "x7")
+		, (T_int, f24, "x8")
+		, (T_int, f25, "x9")
+		, (T_int, f26, "key")
+		, (T_int, f27, "keys")
+		, (T_int, f28, "type")
+		, (T_int, f29, "Type")
+		, (T_int, f30, "TYPE")
+		, (T_int, f31, "data")
+		, (T_int, f32, "meta")
+		, (T_int, f33, "metadata")
+		, (T_int, f34, "count")
+		, (T_int, f35, "counter")
+		, (T_int, f36, "size")
+		, (T_int, f37, "sizes")
+		, (T_int, f38, "len")
+		, (T_int, f39, "length")
+)
+
+TEST(BasicAPI, FindFieldByJsonNameInWideStruct)
+{
+	const MetaClassInfo<char>& metaInfo = ijst::GetMetaInfo<WideSt>();
+	const std::vector<MetaFieldInfo<char> >& fieldsInfo = metaInfo.GetFieldsInfo();
+	ASSERT_EQ(fieldsInfo.size(), 40u);
+	for (size_t i = 0; i < fieldsInfo.size(); ++i) {
+		ASSERT_EQ(&fieldsInfo[i], metaInfo.FindFieldByJsonName(fieldsInfo[i].jsonName));
+		ASSERT_EQ(&fieldsInfo[i], metaInfo.FindFieldByJsonName(fieldsInfo[i].jsonName.c_str(), fieldsInfo[i].jsonName.length()));
+	}
+
+	// prefix, suffix and case variants of json names
+	ASSERT_EQ(NULL, metaInfo.FindFieldByJsonName(""));
+	ASSERT_EQ(NULL, metaInfo.FindFieldByJsonName("c"));
+	ASSERT_EQ(NULL, metaInfo.FindFieldByJsonName("nam"));
+	ASSERT_EQ(NULL, metaInfo.FindFieldByJsonName("name__"));
+	ASSERT_EQ(NULL, metaInfo.FindFieldByJsonName("iD"));
+	ASSERT_EQ(NULL, metaInfo.FindFieldByJsonName("x10"));
+	ASSERT_EQ(NULL, metaInfo.FindFieldByJsonName("length", 5));
+	ASSERT_EQ(&fieldsInfo[38], metaInfo.FindFieldByJsonName("length", 3));
+}
+
 TEST(BasicAPI, Setter)
 {
 	SimpleSt simpleSt;
@@ -302,6 +367,25 @@ TEST(BasicAPI, FieldStatus)
 	IJST_MARK_VALID(simpleSt, int_2);
 	ASSERT_EQ(IJST_GET_STATUS(simpleSt, int_2), (EFStatus)FStatus::kValid);
 
+	// Mark status in turn, other fields are not affected
+	IJST_MARK_NULL(simpleSt, int_2);
+	ASSERT_EQ(IJST_GET_STATUS(simpleSt, int_2), (EFStatus)FStatus::kNull);
+	IJST_MARK_MISSING(simpleSt, int_2);
+	ASSERT_EQ(IJST_GET_STATUS(simpleSt, int_2), (EFStatus)FStatus::kMissing);
+	IJST_MARK_NULL(simpleSt, int_2);
+	IJST_MARK_VALID(simpleSt, int_2);
+	ASSERT_EQ(IJST_GET_STATUS(simpleSt, int_2), (EFStatus)FStatus::kValid);
+	ASSERT_EQ(IJST_GET_STATUS(simpleSt, int_1), (EFStatus)FStatus::kValid);
+	ASSERT_EQ(IJST_GET_STATUS(simpleSt, str_1), (EFStatus)FStatus::kValid);
+	ASSERT_EQ(IJST_GET_STATUS(simpleSt, str_2), (EFStatus)FStatus::kMissing);
+
+	// Copy
+	IJST_MARK_NULL(simpleSt, str_1);
+	SimpleSt copySt(simpleSt);
+	ASSERT_EQ(IJST_GET_STATUS(copySt, int_1), (EFStatus)FStatus::kValid);
+	ASSERT_EQ(IJST_GET_STATUS(copySt, str_1), (EFStatus)FStatus::kNull);
+	ASSERT_EQ(IJST_GET_STATUS(copySt, str_2), (EFStatus)FStatus::kMissing);
+
 	// IsField
 	ASSERT_TRUE(simpleSt._.HasField(&simpleSt.int_1));
 	ASSERT_FALSE(simpleSt._.HasField(&simpleSt.str_2 + 1));
@@ -386,7 +470,9 @@ TEST(BasicAPI, Constructor4RValue)
 	{
 		SimpleSt temp1;
 		IJST_SET(temp1, int_1, 0x5A5A);
-		void* streamTemp1 = &temp1._.GetUnknown();
+		temp1._.GetUnknown().AddMember("k", 1, temp1._.GetAllocator());
+		// unknown is kept in accessor, its members are moved
+		void* streamTemp1 = &temp1._.GetUnknown().MemberBegin()->value;
 		void* allocatorTemp1 = &temp1._.GetAllocator();
 		void* ownAllocatorTemp1 = &temp1._.GetOwnAllocator();
 
@@ -395,7 +481,7 @@ TEST(BasicAPI, Constructor4RValue)
 		ASSERT_EQ(IJST_GET_STATUS(st1, int_1), (EFStatus)FStatus::kValid);
 		ASSERT_EQ(st1.int_1, 0x5A5A);
 		// inner stream
-		ASSERT_EQ(&st1._.GetUnknown(), streamTemp1);
+		ASSERT_EQ(&st1._.GetUnknown().MemberBegin()->value, streamTemp1);
 		ASSERT_EQ(&st1._.GetAllocator(), allocatorTemp1);
 		ASSERT_EQ(&st1._.GetOwnAllocator(), ownAllocatorTemp1);
 		//	ASSERT_ANY_THROW(temp1._.GetUnknown());
@@ -405,7 +491,9 @@ TEST(BasicAPI, Constructor4RValue)
 	{
 		SimpleSt temp2;
 		IJST_SET(temp2, int_1, 0x5A5A);
-		void* streamTemp2 = &temp2._.GetUnknown();
+		temp2._.GetUnknown().AddMember("k", 1, temp2._.GetAllocator());
+		// unknown is kept in accessor, its members are moved
+		void* streamTemp2 = &temp2._.GetUnknown().MemberBegin()->value;
 		void* allocatorTemp2 = &temp2._.GetAllocator();
 		void* ownAllocatorTemp2 = &temp2._.GetOwnAllocator();
 
@@ -415,7 +503,7 @@ TEST(BasicAPI, Constructor4RValue)
 		ASSERT_EQ(IJST_GET_STATUS(st2, int_1), (EFStatus)FStatus::kValid);
 		ASSERT_EQ(st2.int_1, 0x5A5A);
 		// inner stream
-		ASSERT_EQ(&st2._.GetUnknown(), streamTemp2);
+		ASSERT_EQ(&st2._.GetUnknown().MemberBegin()->value, streamTemp2);
 		ASSERT_EQ(&st2._.GetAllocator(), allocatorTemp2);
 		ASSERT_EQ(&st2._.GetOwnAllocator(), ownAllocatorTemp2);
 		//	ASSERT_ANY_THROW(temp2._.GetUnknown());
@@ -423,6 +511,107 @@ TEST(BasicAPI, Constructor4RValue)
 }
 #endif
 
+IJST_DEFINE_STRUCT(
+		MemUsageSt
+		, (T_string, str_v, "str_val", FDesc::Optional)
+		, (IJST_TVEC(T_int), vec_v, "vec_val", FDesc::Optional)
+		, (IJST_TMAP(T_string), map_v, "map_val", FDesc::Optional)
+		, (IJST_TST(SimpleSt), st_v, "st_val", FDesc::Optional)
+)
+
+TEST(BasicAPI, NoAllocationOfDefaultConstructed)
+{
+	MemUsageSt st;
+	const MemUsageSt& cst = st;
+	// const access neither chooses nor creates allocator
+	ASSERT_EQ(cst._.GetAllocator().Capacity(), 0u);
+	ASSERT_EQ(cst._.GetOwnAllocator().Capacity(), 0u);
+	ASSERT_EQ(&cst._.GetAllocator(), &cst._.GetOwnAllocator());
+	ASSERT_EQ(st._.GetMemoryUsage().accessorBytes, 0u);
+	ASSERT_EQ(st._.GetMemoryUsage().allocatorCapacity, 0u);
+
+	// own allocator is created at the first non-const access
+	void* pOwnAllocator = &st._.GetOwnAllocator();
+	ASSERT_EQ(&cst._.GetOwnAllocator(), pOwnAllocator);
+	ASSERT_GE(st._.GetMemoryUsage().accessorBytes, sizeof(rapidjson::Document));
+	ASSERT_EQ(&st._.GetAllocator(), pOwnAllocator);
+	ASSERT_EQ(&cst._.GetAllocator(), pOwnAllocator);
+}
+
+TEST(BasicAPI, GetMemoryUsage)
+{
+	MemUsageSt st;
+	{
+		const MemoryUsage usage = st._.GetMemoryUsage();
+		ASSERT_EQ(usage.accessorBytes, 0u);
+		ASSERT_EQ(usage.allocatorCapacity, 0u);
+		ASSERT_EQ(usage.containerBytes, 0u);
+		ASSERT_EQ(usage.unknownBytes, 0u);
+		ASSERT_EQ(usage.Total(), usage.stringBytes);
+	}
+
+	const std::string longStr(1000, 'x');
+	st.str_v = longStr;
+	st.vec_v.reserve(100);
+	st.map_v["k"] = longStr;
+	st.st_v.str_1 = longStr;
+	{
+		const MemoryUsage usage = st._.GetMemoryUsage();
+		ASSERT_EQ(usage.accessorBytes, 0u);
+		ASSERT_GE(usage.stringBytes, 3 * longStr.capacity());
+		ASSERT_GE(usage.containerBytes, 100 * sizeof(int) + sizeof(std::map<std::string, std::string>::value_type));
+		ASSERT_EQ(usage.unknownBytes, 0u);
+		ASSERT_EQ(usage.Total(), usage.stringBytes + usage.containerBytes);
+	}
+
+	// unknown field and allocator of nested object
+	st.st_v._.GetUnknown().AddMember("unknown", rapidjson::Value().SetString(longStr.c_str(), st.st_v._.GetAllocator()), st.st_v._.GetAllocator());
+	{
+		const MemoryUsage usage = st._.GetMemoryUsage();
+		ASSERT_GE(usage.accessorBytes, sizeof(rapidjson::Document));
+		ASSERT_GE(usage.allocatorUsed, longStr.size());
+		ASSERT_GE(usage.allocatorCapacity, usage.allocatorUsed);
+		ASSERT_GE(usage.unknownBytes, longStr.size());
+	}
+
+	MemoryUsage sum;
+	sum += st._.GetMemoryUsage();
+	sum += st._.GetMemoryUsage();
+	ASSERT_EQ(sum.Total(), 2 * st._.GetMemoryUsage().Total());
+}
+
+#if IJST_USE_RESOURCE_POOL && __cplusplus >= 201103L
+TEST(BasicAPI, ResourcePool)
+{
+	detail::ResourcePool::Trim();
+	void* pOwnAllocator = NULL;
+	{
+		SimpleSt st;
+		ASSERT_EQ(detail::ResourcePool::GetCachedCount(), 0u);
+		pOwnAllocator = &st._.GetOwnAllocator();
+	}
+	ASSERT_EQ(detail::ResourcePool::GetCachedCount(), 1u);
+
+	// Resource of accessor is recycled
+	{
+		SimpleSt st;
+		ASSERT_EQ(&st._.GetOwnAllocator(), pOwnAllocator);
+		ASSERT_EQ(detail::ResourcePool::GetCachedCount(), 0u);
+	}
+
+	// Allocator of T_raw is recycled
+	{
+		T_raw raw;
+		pOwnAllocator = &raw.GetOwnAllocator();
+	}
+	{
+		T_raw raw;
+		ASSERT_EQ(&raw.GetOwnAllocator(), pOwnAllocator);
+	}
+	detail::ResourcePool::Trim();
+}
+#endif
+
 // TODO: Constructor for out buffer
 
 TEST(BasicAPI, GetOptional)
@@ -2,6 +2,8 @@
 // Created by h46incon on 2017/9/30.
 //
 #include "util.h"
+#include <ijst/stream.h>
+#include <sstream>
 
 using std::vector;
 using std::map;
@@ -569,6 +571,459 @@ TEST(Deserialize, Allocator)
 	}
 }
 
+TEST(Deserialize, ArenaScope)
+{
+	const std::string srcJson =
+			"{"
+				"\"val\": {\"unk1\": \"v1\"}, "
+				"\"vec\": [{\"unk2\": \"v2\"}, {\"unk22\": \"v22\"}], "
+				"\"deq\": [{\"unk3\": \"v3\"}, {\"unk33\": \"v33\"}], "
+				"\"list\": [{\"unk4\": \"v4\"}, {\"unk44\": \"v44\"}], "
+				"\"map\": {\"k1\": {\"unk5\": \"v5\"}, \"k11\": {\"unk55\": \"v55\"}}, "
+				"\"obj\": {\"k2\": {\"unk6\": \"v6\"}, \"k22\": {\"unk66\": \"v66\"}}, "
+				"\"raw\": \"v7\""
+			"}";
+
+	rapidjson::Document srcDoc;
+	srcDoc.Parse(srcJson.c_str());
+	ASSERT_FALSE(srcDoc.HasParseError());
+
+	ASSERT_TRUE(ArenaScope::GetCurrentAllocator() == NULL);
+	const DeserFlag::Flag flags[] = {DeserFlag::kNoneFlag, DeserFlag::kNoIntermediateDoc};
+	for (size_t i = 0; i < sizeof(flags) / sizeof(flags[0]); ++i)
+	{
+		// object is constructed out of scope
+		StAllocShrink st;
+		{
+			ArenaScope arena;
+			ASSERT_EQ(ArenaScope::GetCurrentAllocator(), &arena.GetAllocator());
+
+			int ret = st._.Deserialize(srcJson, flags[i]);
+			ASSERT_EQ(ret, 0);
+			ASSERT_EQ(&st._.GetAllocator(), &arena.GetAllocator());
+			ASSERT_GT(arena.GetAllocator().Size(), 0u);
+
+			// No allocator is created by objects in tree, except the unused one of raw constructed out of scope
+			const MemoryUsage usage = st._.GetMemoryUsage();
+			ASSERT_EQ(usage.accessorBytes, 0u);
+			ASSERT_EQ(usage.allocatorCapacity, sizeof(rapidjson::MemoryPoolAllocator<>));
+
+			// Copy values to own allocators before the arena is destroyed
+			st._.ShrinkAllocator();
+		}
+		ASSERT_TRUE(ArenaScope::GetCurrentAllocator() == NULL);
+		CheckUseOwnAllocator(st);
+
+		std::string destJson;
+		ASSERT_EQ(st._.Serialize(destJson), 0);
+		rapidjson::Document destDoc;
+		destDoc.Parse(destJson.c_str());
+		ASSERT_EQ(srcDoc, destDoc);
+	}
+
+	// Nested scope
+	{
+		char buffer[1024];
+		ArenaScope outer(buffer, sizeof(buffer));
+		{
+			ArenaScope inner;
+			T_raw raw;
+			ASSERT_EQ(&raw.GetAllocator(), &inner.GetAllocator());
+			ASSERT_NE(&raw.GetOwnAllocator(), &inner.GetAllocator());
+		}
+		ASSERT_EQ(ArenaScope::GetCurrentAllocator(), &outer.GetAllocator());
+
+		StAllocShrink st;
+		ASSERT_EQ(&st._.GetAllocator(), &outer.GetAllocator());
+		ASSERT_EQ(&st.raw.GetAllocator(), &outer.GetAllocator());
+	}
+	ASSERT_TRUE(ArenaScope::GetCurrentAllocator() == NULL);
+}
+
+IJST_DEFINE_VALUE(
+		ValStrView, T_strview, v, 0
+)
+
+IJST_DEFINE_VALUE(
+		ValVecStrView, IJST_TVEC(T_strview), v, 0
+)
+
+TEST(Deserialize, ValueStrViewNotReferToSource)
+{
+	ValStrView st;
+	ValVecStrView vecSt;
+	{
+		// Longer than short string of rapidjson, which is stored in the value itself
+		const std::string json = "\"string view of value\"";
+		ASSERT_EQ(st._.Deserialize(json), 0);
+		const std::string vecJson = "[\"string view of elem 0\", \"string view of elem 1\"]";
+		ASSERT_EQ(vecSt._.Deserialize(vecJson), 0);
+	}
+	// Reuse memory of intermediate documents above
+	{
+		ValVecStrView other;
+		ASSERT_EQ(other._.Deserialize(std::string("[\"xxxxxxxxxxxxxxxxxxxxxx\", \"yyyyyyyyyyyyyyyyyyyyyy\"]")), 0);
+	}
+
+	ASSERT_EQ(st.v, T_strview("string view of value"));
+	ASSERT_EQ(vecSt.v.size(), 2u);
+	ASSERT_EQ(vecSt.v[0], T_strview("string view of elem 0"));
+	ASSERT_EQ(vecSt.v[1], T_strview("string view of elem 1"));
+
+	// Views are copied into allocator of accessor
+	ASSERT_GE(st._.GetMemoryUsage().allocatorUsed, st.v.size());
+}
+
+IJST_DEFINE_STRUCT(
+		StInsitu
+		, (T_string, str, "str", 0)
+		, (T_strview, view, "view", 0)
+		, (IJST_TVEC(T_strview), vecView, "vec_view", 0)
+		, (T_raw, raw, "raw", 0)
+)
+
+TEST(Deserialize, DeserializeInsitu)
+{
+	const std::string json = "{\"str\": \"s\\tr\", \"view\": \"v\\u0041\", \"vec_view\": [\"v1\", \"v2\"]"
+			", \"raw\": {\"k\": \"raw\"}, \"unknown\": \"unk\"}";
+
+	//*** Refer to buffer
+	{
+		std::vector<char> buffer(json.begin(), json.end());
+		buffer.push_back('\0');
+		const char* pBegin = &buffer.front();
+		const char* pEnd = &buffer.back();
+
+		StInsitu st;
+		int ret = st._.DeserializeInsitu(&buffer[0]);
+		ASSERT_EQ(ret, 0);
+		ASSERT_EQ(st.str, "s\tr");
+		ASSERT_EQ(st.view, T_strview("vA"));
+		ASSERT_EQ(st.vecView.size(), 2u);
+		ASSERT_EQ(st.vecView[1], T_strview("v2"));
+		ASSERT_STREQ(st.raw.V()["k"].GetString(), "raw");
+		ASSERT_STREQ(st._.GetUnknown()["unknown"].GetString(), "unk");
+
+		// strings are not copied
+		const char* pViewStr = st.view.data();
+		const char* pRawStr = st.raw.V()["k"].GetString();
+		const char* pUnknownKey = st._.GetUnknown().MemberBegin()->name.GetString();
+		const char* pUnknownStr = st._.GetUnknown()["unknown"].GetString();
+		ASSERT_TRUE(pViewStr >= pBegin && pViewStr <= pEnd);
+		ASSERT_TRUE(pRawStr >= pBegin && pRawStr <= pEnd);
+		ASSERT_TRUE(pUnknownKey >= pBegin && pUnknownKey <= pEnd);
+		ASSERT_TRUE(pUnknownStr >= pBegin && pUnknownStr <= pEnd);
+
+		std::string serialized;
+		ASSERT_EQ(st._.Serialize(serialized), 0);
+		rapidjson::Document srcDoc, destDoc;
+		srcDoc.Parse(json.c_str());
+		destDoc.Parse(serialized.c_str());
+		ASSERT_EQ(srcDoc, destDoc);
+	}
+
+	//*** No intermediate doc
+	{
+		std::vector<char> buffer(json.begin(), json.end());
+		buffer.push_back('\0');
+
+		StInsitu st;
+		int ret = st._.DeserializeInsitu(&buffer[0], DeserFlag::kNoIntermediateDoc);
+		ASSERT_EQ(ret, 0);
+		ASSERT_EQ(st.str, "s\tr");
+		ASSERT_EQ(st.view, T_strview("vA"));
+		ASSERT_STREQ(st.raw.V()["k"].GetString(), "raw");
+		ASSERT_STREQ(st._.GetUnknown()["unknown"].GetString(), "unk");
+	}
+
+	//*** Error
+	{
+		std::string errJson = "{\"str\": 1}";
+		std::vector<char> buffer(errJson.begin(), errJson.end());
+		buffer.push_back('\0');
+		StInsitu st;
+		ASSERT_EQ(st._.DeserializeInsitu(&buffer[0]), ErrorCode::kDeserializeValueTypeError);
+
+		char parseErrorBuffer[] = "{\"str\": ";
+		ASSERT_EQ(st._.DeserializeInsitu(parseErrorBuffer), ErrorCode::kDeserializeParseFailed);
+	}
+}
+
+IJST_DEFINE_STRUCT(
+		StReuseInner
+		, (T_string, str, "str", 0)
+		, (T_int, opt, "opt", FDesc::Optional)
+)
+
+IJST_DEFINE_STRUCT(
+		StReuse
+		, (IJST_TVEC(T_string), vec, "vec", 0)
+		, (IJST_TLIST(T_string), lst, "lst", 0)
+		, (IJST_TDEQUE(T_int), deq, "deq", 0)
+		, (IJST_TMAP(IJST_TVEC(T_int)), map, "map", 0)
+		, (IJST_TOBJ(T_string), obj, "obj", 0)
+		, (IJST_TVEC(IJST_TST(StReuseInner)), vecSt, "vec_st", 0)
+)
+
+TEST(Deserialize, ReuseFields)
+{
+	const std::string longStr1 = "a string that is long enough to be allocated in heap 1";
+	const std::string longStr2 = "a string that is long enough to be allocated in heap 2";
+	const std::string json1 = "{\"vec\": [\"" + longStr1 + "\", \"v2\"], \"lst\": [\"" + longStr1 + "\", \"l2\"]"
+			", \"deq\": [1, 2], \"map\": {\"k1\": [1, 2, 3], \"k2\": [4]}, \"obj\": {\"" + longStr1 + "\": \"o1\"}"
+			", \"vec_st\": [{\"str\": \"" + longStr1 + "\", \"opt\": 1}]}";
+	const std::string json2 = "{\"vec\": [\"" + longStr2 + "\", \"v22\"], \"lst\": [\"" + longStr2 + "\", \"l22\"]"
+			", \"deq\": [11, 22], \"map\": {\"k2\": [44], \"k1\": [11, 22, 33]}, \"obj\": {\"" + longStr2 + "\": \"o11\"}"
+			", \"vec_st\": [{\"str\": \"" + longStr2 + "\"}]}";
+	const std::string json3 = "{\"vec\": [\"v3\"], \"lst\": [\"l3\"], \"deq\": [], \"map\": {\"k3\": [], \"k1\": [3]}"
+			", \"obj\": {}, \"vec_st\": [{\"str\": \"s3\"}, {\"str\": \"s33\"}]}";
+
+	const DeserFlag::Flag flags[] = {DeserFlag::kNoneFlag, DeserFlag::kNoIntermediateDoc};
+	for (size_t i = 0; i < sizeof(flags) / sizeof(flags[0]); ++i)
+	{
+		const bool isSAX = (flags[i] == DeserFlag::kNoIntermediateDoc);
+		StReuse st;
+		ASSERT_EQ(st._.Deserialize(json1, flags[i]), 0);
+		const std::string* pVecData = st.vec.data();
+		const char* pVecStr = st.vec[0].data();
+		const std::string* pListFront = &st.lst.front();
+		const char* pListStr = st.lst.front().data();
+		const int* pMapVecData = st.map["k1"].data();
+		const char* pObjName = st.obj[0].name.data();
+		const char* pInnerStr = st.vecSt[0].str.data();
+		ASSERT_EQ(IJST_GET_STATUS(st.vecSt[0], opt), (EFStatus)FStatus::kValid);
+
+		// Memory of fields is reused
+		ASSERT_EQ(st._.Deserialize(json2, flags[i] | DeserFlag::kReuseFields), 0);
+		ASSERT_EQ(st.vec[0], longStr2);
+		ASSERT_EQ(st.vec[1], "v22");
+		ASSERT_EQ(st.lst.front(), longStr2);
+		ASSERT_EQ(st.lst.back(), "l22");
+		ASSERT_EQ(st.deq[1], 22);
+		ASSERT_EQ(st.map.size(), 2u);
+		ASSERT_EQ(st.map["k1"][2], 33);
+		ASSERT_EQ(st.map["k2"][0], 44);
+		ASSERT_EQ(st.obj[0].name, longStr2);
+		ASSERT_EQ(st.obj[0].value, "o11");
+		ASSERT_EQ(st.vecSt[0].str, longStr2);
+		// Field missing in json is reset to kMissing, though the old value is kept
+		ASSERT_EQ(IJST_GET_STATUS(st.vecSt[0], opt), (EFStatus)FStatus::kMissing);
+
+		ASSERT_EQ(st.vec.data(), pVecData);
+		ASSERT_EQ(st.vec[0].data(), pVecStr);
+		ASSERT_EQ(&st.lst.front(), pListFront);
+		ASSERT_EQ(st.lst.front().data(), pListStr);
+		if (!isSAX) {
+			ASSERT_EQ(st.map["k1"].data(), pMapVecData);
+		}
+		ASSERT_EQ(st.obj[0].name.data(), pObjName);
+		ASSERT_EQ(st.vecSt[0].str.data(), pInnerStr);
+
+		// Elements not in json are removed
+		ASSERT_EQ(st._.Deserialize(json3, flags[i] | DeserFlag::kReuseFields), 0);
+		ASSERT_EQ(st.vec.size(), 1u);
+		ASSERT_EQ(st.vec[0], "v3");
+		ASSERT_EQ(st.lst.size(), 1u);
+		ASSERT_EQ(st.lst.front(), "l3");
+		ASSERT_TRUE(st.deq.empty());
+		ASSERT_EQ(st.map.size(), 2u);
+		ASSERT_EQ(st.map["k1"].size(), 1u);
+		ASSERT_EQ(st.map["k1"][0], 3);
+		ASSERT_TRUE(st.map["k3"].empty());
+		ASSERT_TRUE(st.obj.empty());
+		ASSERT_EQ(st.vecSt.size(), 2u);
+		ASSERT_EQ(st.vecSt[1].str, "s33");
+
+		std::string serialized;
+		ASSERT_EQ(st._.Serialize(serialized, SerFlag::kIgnoreMissing), 0);
+		rapidjson::Document srcDoc, destDoc;
+		srcDoc.Parse(json3.c_str());
+		destDoc.Parse(serialized.c_str());
+		ASSERT_EQ(srcDoc, destDoc);
+
+		// Errors are still reported
+		const std::string dupJson = "{\"vec\": [], \"lst\": [], \"deq\": [], \"map\": {\"k1\": [], \"k1\": []}"
+				", \"obj\": {}, \"vec_st\": []}";
+		ASSERT_EQ(st._.Deserialize(dupJson, flags[i] | DeserFlag::kReuseFields), ErrorCode::kDeserializeMapKeyDuplicated);
+		const std::string errJson = "{\"vec\": [\"v1\", 2], \"lst\": [], \"deq\": [], \"map\": {}, \"obj\": {}, \"vec_st\": []}";
+		ASSERT_EQ(st._.Deserialize(errJson, flags[i] | DeserFlag::kReuseFields), ErrorCode::kDeserializeValueTypeError);
+		ASSERT_EQ(st.vec.size(), 1u);
+	}
+}
+
+#if __cplusplus >= 201103L
+IJST_DEFINE_STRUCT_WITH_GETTER(
+		StUMap
+		, (IJST_TUMAP(T_int), umap, "umap", 0)
+		, (IJST_TUMAP(IJST_TUMAP(T_string)), umap2, "umap2", FDesc::Optional)
+)
+
+TEST(Deserialize, UnorderedMap)
+{
+	const std::string json = "{\"umap\": {\"k1\": 1, \"k2\": 2, \"k3\": 3}, \"umap2\": {\"o1\": {\"i1\": \"s1\"}, \"o2\": {}}}";
+	const DeserFlag::Flag flags[] = {DeserFlag::kNoneFlag, DeserFlag::kNoIntermediateDoc};
+	for (size_t i = 0; i < sizeof(flags) / sizeof(flags[0]); ++i)
+	{
+		StUMap st;
+		ASSERT_EQ(st._.Deserialize(json, flags[i]), 0);
+		ASSERT_EQ(st.umap.size(), 3u);
+		ASSERT_EQ(st.umap["k1"], 1);
+		ASSERT_EQ(st.umap["k3"], 3);
+		ASSERT_EQ(st.umap2.size(), 2u);
+		ASSERT_EQ(st.umap2["o1"]["i1"], "s1");
+		ASSERT_TRUE(st.umap2["o2"].empty());
+
+		// Getter chaining
+		ASSERT_EQ(st.get_umap()["k2"].Ptr(), &st.umap["k2"]);
+		ASSERT_EQ(NULL, st.get_umap()["k4"].Ptr());
+		ASSERT_EQ(st.get_umap2()["o1"]["i1"].Ptr(), &st.umap2["o1"]["i1"]);
+		ASSERT_EQ(NULL, st.get_umap2()["o3"]["i1"].Ptr());
+		const StUMap& cref = st;
+		ASSERT_EQ(cref.get_umap()["k2"].Ptr(), &st.umap["k2"]);
+
+		// Serialize
+		std::string serialized;
+		ASSERT_EQ(st._.Serialize(serialized), 0);
+		rapidjson::Document srcDoc, destDoc;
+		srcDoc.Parse(json.c_str());
+		destDoc.Parse(serialized.c_str());
+		ASSERT_EQ(srcDoc, destDoc);
+
+		// Memory usage
+		ASSERT_GT(st._.GetMemoryUsage().containerBytes, 3 * sizeof(std::pair<const std::string, int>));
+
+		// Reuse
+		ASSERT_EQ(st._.Deserialize("{\"umap\": {\"k2\": 22, \"k4\": 4}}", flags[i] | DeserFlag::kReuseFields), 0);
+		ASSERT_EQ(st.umap.size(), 2u);
+		ASSERT_EQ(st.umap["k2"], 22);
+		ASSERT_EQ(st.umap["k4"], 4);
+
+		// Duplicate key
+		rapidjson::Document errDoc;
+		ASSERT_EQ(st._.Deserialize("{\"umap\": {\"k1\": 1, \"k1\": 1}}", flags[i], &errDoc), ErrorCode::kDeserializeMapKeyDuplicated);
+		ASSERT_STREQ(errDoc["member"].GetString(), "umap");
+		ASSERT_STREQ(errDoc["err"]["type"].GetString(), "MapKeyDuplicated");
+		ASSERT_STREQ(errDoc["err"]["key"].GetString(), "k1");
+
+		// Type error of element
+		ASSERT_EQ(st._.Deserialize("{\"umap\": {\"k1\": 1, \"k2\": \"2\"}}", flags[i], &errDoc), ErrorCode::kDeserializeValueTypeError);
+		ASSERT_STREQ(errDoc["err"]["type"].GetString(), "ErrInMap");
+		ASSERT_STREQ(errDoc["err"]["member"].GetString(), "k2");
+		ASSERT_EQ(st.umap.count("k2"), 0u);
+	}
+}
+#endif
+
+IJST_DEFINE_STRUCT_WITH_GETTER(
+		StFlatMap
+		, (IJST_TFLATMAP(T_int), fmap, "fmap", 0)
+		, (IJST_TFLATMAP(IJST_TVEC(T_string)), fmap2, "fmap2", FDesc::Optional)
+)
+
+TEST(Deserialize, FlatMap)
+{
+	const std::string json = "{\"fmap\": {\"k3\": 3, \"k1\": 1, \"k2\": 2}, \"fmap2\": {\"v\": [\"s1\", \"s2\"]}}";
+	const DeserFlag::Flag flags[] = {DeserFlag::kNoneFlag, DeserFlag::kNoIntermediateDoc};
+	for (size_t i = 0; i < sizeof(flags) / sizeof(flags[0]); ++i)
+	{
+		StFlatMap st;
+		ASSERT_EQ(st._.Deserialize(json, flags[i]), 0);
+		ASSERT_EQ(st.fmap.size(), 3u);
+		// Sorted
+		ASSERT_EQ(st.fmap.members()[0].name, "k1");
+		ASSERT_EQ(st.fmap.members()[1].name, "k2");
+		ASSERT_EQ(st.fmap.members()[2].value, 3);
+		ASSERT_EQ(st.fmap["k2"], 2);
+		ASSERT_EQ(st.fmap.count("k4"), 0u);
+		ASSERT_EQ(st.fmap2["v"][1], "s2");
+
+		// Getter chaining
+		ASSERT_EQ(st.get_fmap()["k3"].Ptr(), &st.fmap.members()[2].value);
+		ASSERT_EQ(NULL, st.get_fmap()["k0"].Ptr());
+		ASSERT_EQ(st.get_fmap2()["v"][0].Ptr(), &st.fmap2["v"][0]);
+		ASSERT_EQ(NULL, st.get_fmap2()["w"][0].Ptr());
+		const StFlatMap& cref = st;
+		ASSERT_EQ(cref.get_fmap()["k1"].Ptr(), &st.fmap.members()[0].value);
+
+		// Serialize in order of key
+		std::string serialized;
+		ASSERT_EQ(st._.Serialize(serialized), 0);
+		ASSERT_EQ(serialized, "{\"fmap\":{\"k1\":1,\"k2\":2,\"k3\":3},\"fmap2\":{\"v\":[\"s1\",\"s2\"]}}");
+
+		// Duplicate key
+		rapidjson::Document errDoc;
+		ASSERT_EQ(st._.Deserialize("{\"fmap\": {\"k2\": 1, \"k1\": 1, \"k2\": 2}}", flags[i], &errDoc), ErrorCode::kDeserializeMapKeyDuplicated);
+		ASSERT_STREQ(errDoc["member"].GetString(), "fmap");
+		ASSERT_STREQ(errDoc["err"]["type"].GetString(), "MapKeyDuplicated");
+		ASSERT_STREQ(errDoc["err"]["key"].GetString(), "k2");
+
+		// Type error of element
+		ASSERT_EQ(st._.Deserialize("{\"fmap\": {\"k2\": 2, \"k1\": \"1\"}}", flags[i], &errDoc), ErrorCode::kDeserializeValueTypeError);
+		ASSERT_STREQ(errDoc["err"]["type"].GetString(), "ErrInMap");
+		ASSERT_STREQ(errDoc["err"]["member"].GetString(), "k1");
+	}
+
+	// Modify
+	T_FlatMap<int> fmap;
+	ASSERT_TRUE(fmap.insert(T_Member<int>("b", 2)).second);
+	ASSERT_TRUE(fmap.insert(T_Member<int>("a", 1)).second);
+	ASSERT_FALSE(fmap.insert(T_Member<int>("a", 3)).second);
+	fmap["c"] = 3;
+	ASSERT_EQ(fmap.size(), 3u);
+	ASSERT_EQ(fmap.begin()->name, "a");
+	ASSERT_EQ(fmap.begin()->value, 1);
+	ASSERT_EQ(fmap.erase("b"), 1u);
+	ASSERT_EQ(fmap.erase("b"), 0u);
+	ASSERT_TRUE(fmap.find("b") == fmap.end());
+	ASSERT_EQ(fmap.find("c")->value, 3);
+}
+
+IJST_DEFINE_STRUCT(
+		StNumberVec
+		, (IJST_TVEC(T_int), vi, "vi", 0)
+		, (IJST_TVEC(T_uint64), vu64, "vu64", 0)
+		, (IJST_TVEC(T_double), vd, "vd", FDesc::NotDefault)
+)
+
+TEST(Deserialize, NumberVector)
+{
+	const DeserFlag::Flag flags[] = {DeserFlag::kNoneFlag, DeserFlag::kNoIntermediateDoc};
+	for (size_t i = 0; i < sizeof(flags) / sizeof(flags[0]); ++i)
+	{
+		StNumberVec st;
+		const std::string json = "{\"vi\": [1, -2, 3], \"vu64\": [18446744073709551615], \"vd\": [1, 2.5, -3e2]}";
+		ASSERT_EQ(st._.Deserialize(json, flags[i]), 0);
+		ASSERT_EQ(st.vi.size(), 3u);
+		ASSERT_EQ(st.vi[1], -2);
+		ASSERT_EQ(st.vu64[0], 18446744073709551615ULL);
+		ASSERT_EQ(st.vd.size(), 3u);
+		ASSERT_DOUBLE_EQ(st.vd[0], 1.0);
+		ASSERT_DOUBLE_EQ(st.vd[2], -300.0);
+
+		// Type error
+		rapidjson::Document errDoc;
+		ASSERT_EQ(st._.Deserialize("{\"vi\": [1, 2.5], \"vu64\": [], \"vd\": [1]}", flags[i], &errDoc),
+				  ErrorCode::kDeserializeValueTypeError);
+		ASSERT_STREQ(errDoc["member"].GetString(), "vi");
+		ASSERT_STREQ(errDoc["err"]["type"].GetString(), "ErrInArray");
+		ASSERT_EQ(errDoc["err"]["index"].GetInt(), 1);
+		CheckTypeMismatch(errDoc["err"]["err"], "int", "2.5");
+		ASSERT_EQ(st.vi.size(), 1u);
+
+		ASSERT_EQ(st._.Deserialize("{\"vi\": [], \"vu64\": [-1], \"vd\": [1]}", flags[i], &errDoc),
+				  ErrorCode::kDeserializeValueTypeError);
+		CheckTypeMismatch(errDoc["err"]["err"], "uint64", "-1");
+
+		ASSERT_EQ(st._.Deserialize("{\"vi\": [], \"vu64\": [], \"vd\": [1, [2]]}", flags[i], &errDoc),
+				  ErrorCode::kDeserializeValueTypeError);
+		CheckTypeMismatch(errDoc["err"]["err"], "number", "[2]");
+
+		// Not default
+		ASSERT_EQ(st._.Deserialize("{\"vi\": [], \"vu64\": [], \"vd\": []}", flags[i], &errDoc),
+				  ErrorCode::kDeserializeValueIsDefault);
+	}
+}
+
 TEST(Deserialize, ErrDoc_MemberMissing)
 {
 	string json = "{}";
@@ -785,3 +1240,562 @@ TEST(Deserialize, ErrDoc)
 	}
 
 }
+
+IJST_DEFINE_VALUE(
+		ValVecSt, IJST_TVEC(IJST_TST(NullableSt)), v, FDesc::Optional
+)
+
+IJST_DEFINE_STRUCT(
+		StSAXCheck
+		, (IJST_TST(StErrCheck), err_check, "f_err_check", FDesc::Optional)
+		, (IJST_TST(NotEmptySt), not_empty, "f_not_empty", FDesc::Optional)
+		, (IJST_TVEC(IJST_TST(NullableSt)), vec_nullable, "f_vec_nullable", FDesc::Optional)
+		, (IJST_TST(ValVecSt), val_vec, "f_val_vec", FDesc::Optional)
+		, (IJST_TMAP(IJST_TVEC(T_string)), map_vec, "f_map_vec", FDesc::Optional)
+		, (IJST_TVEC(IJST_TVEC(T_int)), vec_vec, "f_vec_vec", FDesc::Optional)
+		, (IJST_TMAP(IJST_TOBJ(T_int)), map_obj, "f_map_obj", FDesc::Optional)
+		, (T_raw, raw, "f_raw", FDesc::Optional)
+		, (T_raw, raw_not_default, "f_raw_nd", FDesc::Optional | FDesc::NotDefault)
+		, (T_string, str, "f_str", FDesc::Optional | FDesc::NotDefault)
+		, (T_double, d, "f_d", FDesc::Optional)
+		, (T_int64, i64, "f_i64", 0)
+)
+
+template<typename T>
+void CheckSAXModeSameAsDOMMode(const string& json, DeserFlag::Flag deserFlag = DeserFlag::kNoneFlag)
+{
+	T stDom;
+	string errMsgDom;
+	const int retDom = stDom._.Deserialize(json, errMsgDom, deserFlag);
+
+	T stSAX;
+	string errMsgSAX;
+	const int retSAX = stSAX._.Deserialize(json, errMsgSAX, deserFlag | DeserFlag::kNoIntermediateDoc);
+	ASSERT_EQ(retDom, retSAX) << json;
+	ASSERT_EQ(errMsgDom, errMsgSAX) << json;
+	if (retDom != 0) {
+		return;
+	}
+	string outDom, outSAX;
+	ASSERT_EQ(stDom._.Serialize(outDom), 0);
+	ASSERT_EQ(stSAX._.Serialize(outSAX), 0);
+	ASSERT_EQ(outDom, outSAX) << json;
+}
+
+TEST(Deserialize, NoIntermediateDoc)
+{
+	const char* jsons[] = {
+			// Succ
+			"{\"f_i64\": -1}",
+			"{\"f_i64\": 9007199254740993, \"f_d\": 1, \"f_str\": \"s\", \"f_raw\": {\"a\": [1, {\"b\": null}, \"c\"]}}",
+			"{\"f_i64\": 0, \"f_raw\": 1.5, \"f_raw_nd\": [], \"unk1\": {\"u\": [true, false, {}]}, \"unk2\": \"v\"}",
+			"{\"f_i64\": 0, \"f_err_check\": {\"f_v\": 1, \"f_map\": {\"m1\": 0, \"m2\": 1}, \"f_obj\": {\"o\": 1, \"o\": 0},"
+				"\"f_vec\": [1, 0], \"f_deq\": [], \"f_list\": [1], \"unk\": null}}",
+			"{\"f_i64\": 0, \"f_not_empty\": {\"vec\": [1], \"map\": {\"k\": 1}, \"obj\": {\"k\": 2}}}",
+			"{\"f_i64\": 0, \"f_vec_nullable\": [{\"int_val_2\": null}, {\"int_val_2\": 2, \"int_val_3\": null}], "
+				"\"f_val_vec\": [{\"int_val_2\": 1}]}",
+			"{\"f_i64\": 0, \"f_map_vec\": {\"k1\": [\"a\", \"b\"], \"k2\": []}}",
+			"{\"f_i64\": 0, \"f_vec_vec\": [[1, 2], [], [3]], \"f_map_obj\": {\"k1\": {\"o1\": 1}, \"k2\": {}}}",
+			// Type error
+			"[1, 2]",
+			"{\"f_i64\": \"1\"}",
+			"{\"f_i64\": 0, \"f_d\": [1]}",
+			"{\"f_i64\": 0, \"f_str\": {\"k\": \"v\"}}",
+			"{\"f_i64\": 0, \"f_err_check\": {\"f_map\": {\"m1\": 0, \"m2\": [2]}}}",
+			"{\"f_i64\": 0, \"f_err_check\": {\"f_obj\": {\"o1\": 0, \"o2\": \"2\"}}}",
+			"{\"f_i64\": 0, \"f_err_check\": {\"f_list\": [0, 1, {\"v\": 2}]}}",
+			"{\"f_i64\": 0, \"f_err_check\": [1]}",
+			"{\"f_i64\": 0, \"f_vec_nullable\": [{\"int_val_2\": null}, {\"int_val_2\": null, \"int_val_1\": null}]}",
+			"{\"f_i64\": 0, \"f_val_vec\": [{\"int_val_2\": 1}, 2]}",
+			"{\"f_i64\": 0, \"f_map_vec\": {\"k1\": [\"a\", 1]}}",
+			"{\"f_i64\": 0, \"f_vec_vec\": [[1, 2], [3, {}]]}",
+			"{\"f_i64\": 0, \"f_map_obj\": {\"k1\": {\"o1\": 1}, \"k2\": {\"o2\": [1]}}}",
+			// Value is default
+			"{\"f_i64\": 0, \"f_str\": \"\"}",
+			"{\"f_i64\": 0, \"f_raw_nd\": null}",
+			"{\"f_i64\": 0, \"f_not_empty\": {\"vec\": [1], \"deq\": []}}",
+			"{\"f_i64\": 0, \"f_not_empty\": {\"map\": {}}}",
+			// Map key duplicated
+			"{\"f_i64\": 0, \"f_map_vec\": {\"k1\": [], \"k1\": []}}",
+			// Missing member
+			"{}",
+			"{\"f_i64\": 0, \"f_vec_nullable\": [{\"int_val_1\": 1}]}",
+			// Parse error
+			"",
+			"{\"f_i64\": 0, \"f_str\": ",
+	};
+
+	for (size_t i = 0; i < sizeof(jsons) / sizeof(jsons[0]); ++i) {
+		CheckSAXModeSameAsDOMMode<StSAXCheck>(jsons[i]);
+		CheckSAXModeSameAsDOMMode<StSAXCheck>(jsons[i], DeserFlag::kIgnoreUnknown);
+		CheckSAXModeSameAsDOMMode<StSAXCheck>(jsons[i], DeserFlag::kErrorWhenUnknown);
+		CheckSAXModeSameAsDOMMode<StSAXCheck>(jsons[i], DeserFlag::kNotCheckFieldStatus);
+		CheckSAXModeSameAsDOMMode<ValVecSt>(jsons[i]);
+	}
+}
+
+IJST_DEFINE_STRUCT(
+		StFieldKinds
+		, (T_bool, b, "f_b", FDesc::Optional)
+		, (T_ubool, ub, "f_ub", FDesc::Optional)
+		, (T_wbool, wb, "f_wb", FDesc::Optional)
+		, (T_int, i, "f_i", FDesc::Optional | FDesc::Nullable)
+		, (T_int64, i64, "f_i64", FDesc::Optional)
+		, (T_uint, u, "f_u", FDesc::Optional)
+		, (T_uint64, u64, "f_u64", FDesc::Optional)
+		, (T_double, d, "f_d", FDesc::Optional)
+		, (T_string, str, "f_str", FDesc::Optional)
+		, (T_raw, raw, "f_raw", FDesc::Optional)
+		, (IJST_TVEC(T_int), vec, "f_vec", FDesc::Optional)
+		, (IJST_TDEQUE(T_string), deq, "f_deq", FDesc::Optional)
+		, (IJST_TLIST(T_double), list, "f_list", FDesc::Optional)
+		, (IJST_TMAP(T_int), map, "f_map", FDesc::Optional)
+		, (IJST_TOBJ(T_bool), obj, "f_obj", FDesc::Optional)
+		, (IJST_TFLATMAP(T_int), flat, "f_flat", FDesc::Optional)
+		, (IJST_TST(SimpleSt), st, "f_st", FDesc::Optional)
+		, (IJST_TST(ValVecSt), val, "f_val", FDesc::Optional)
+		, (T_int, intf, "f_intf", FDesc::Optional, (&IJSTI_FSERIALIZER_INS(T_uint, rapidjson::UTF8<>)))
+)
+
+TEST(Deserialize, EveryFieldKind)
+{
+	// Fields are deserialized by generated function in DOM mode, and by SerializerInterface in SAX mode
+	const string json = "{\"f_b\": true, \"f_ub\": false, \"f_wb\": true, \"f_i\": null, \"f_i64\": -9007199254740993"
+			", \"f_u\": 4294967295, \"f_u64\": 18446744073709551615, \"f_d\": 0.5, \"f_str\": \"s\\tr\""
+			", \"f_raw\": {\"k\": [1, null]}, \"f_vec\": [1, -2], \"f_deq\": [\"a\", \"\"], \"f_list\": [1.5]"
+			", \"f_map\": {\"m1\": 1, \"m2\": 2}, \"f_obj\": {\"o\": true, \"o\": false}, \"f_flat\": {\"k2\": 2, \"k1\": 1}"
+			", \"f_st\": {\"int_val_2\": 2, \"str_val_2\": \"v2\"}, \"f_val\": [{\"int_val_2\": null}]"
+			", \"f_intf\": 7, \"unk\": 1}";
+	const DeserFlag::Flag flags[] = {
+			DeserFlag::kNoneFlag, DeserFlag::kMoveFromIntermediateDoc, DeserFlag::kNoIntermediateDoc
+	};
+
+	string expectedOutput;
+	for (size_t i = 0; i < sizeof(flags) / sizeof(flags[0]); ++i) {
+		StFieldKinds st;
+		ASSERT_EQ(st._.Deserialize(json, flags[i]), 0);
+		ASSERT_TRUE(st.b);
+		ASSERT_EQ(st.ub, 0);
+		ASSERT_TRUE(st.wb);
+		ASSERT_EQ(IJST_GET_STATUS(st, i), (EFStatus)FStatus::kNull);
+		ASSERT_EQ(st.i64, -9007199254740993LL);
+		ASSERT_EQ(st.u, 4294967295u);
+		ASSERT_EQ(st.u64, 18446744073709551615ULL);
+		ASSERT_DOUBLE_EQ(st.d, 0.5);
+		ASSERT_STREQ(st.str.c_str(), "s\tr");
+		ASSERT_EQ(st.raw.V()["k"][0].GetInt(), 1);
+		ASSERT_TRUE(st.raw.V()["k"][1].IsNull());
+		ASSERT_EQ(st.vec.size(), 2u);
+		ASSERT_EQ(st.vec[1], -2);
+		ASSERT_EQ(st.deq.size(), 2u);
+		ASSERT_STREQ(st.deq[0].c_str(), "a");
+		ASSERT_EQ(st.list.size(), 1u);
+		ASSERT_DOUBLE_EQ(st.list.front(), 1.5);
+		ASSERT_EQ(st.map.size(), 2u);
+		ASSERT_EQ(st.map["m2"], 2);
+		ASSERT_EQ(st.obj.size(), 2u);
+		ASSERT_STREQ(st.obj[1].name.c_str(), "o");
+		ASSERT_FALSE(st.obj[1].value);
+		ASSERT_EQ(st.flat.size(), 2u);
+		ASSERT_EQ(st.flat.find("k1")->value, 1);
+		ASSERT_EQ(st.st.int_2, 2);
+		ASSERT_STREQ(st.st.str_2.c_str(), "v2");
+		ASSERT_EQ(st.val.v.size(), 1u);
+		ASSERT_EQ(IJST_GET_STATUS(st.val.v[0], int_2), (EFStatus)FStatus::kNull);
+		ASSERT_EQ(st.intf, 7);
+		ASSERT_EQ(st._.GetUnknown()["unk"].GetInt(), 1);
+
+		string output;
+		ASSERT_EQ(st._.Serialize(output), 0);
+		if (i == 0) {
+			expectedOutput = output;
+		}
+		ASSERT_EQ(output, expectedOutput);
+	}
+
+	// Error of each kind of field is reported in the same way
+	const char* errJsons[] = {
+			"{\"f_b\": 1}",
+			"{\"f_ub\": \"true\"}",
+			"{\"f_wb\": null}",
+			"{\"f_i\": 2147483648}",
+			"{\"f_i64\": 1.5}",
+			"{\"f_u\": -1}",
+			"{\"f_u64\": -1}",
+			"{\"f_d\": \"0.5\"}",
+			"{\"f_str\": 1}",
+			"{\"f_vec\": [1, \"2\"]}",
+			"{\"f_deq\": {}}",
+			"{\"f_list\": [true]}",
+			"{\"f_map\": {\"m1\": []}}",
+			"{\"f_obj\": [true]}",
+			"{\"f_flat\": {\"k\": \"v\"}}",
+			"{\"f_st\": {\"int_val_2\": \"2\", \"str_val_2\": \"v2\"}}",
+			"{\"f_st\": {\"int_val_2\": 2}}",
+			"{\"f_val\": [{}]}",
+			"{\"f_intf\": -1}",
+	};
+	for (size_t i = 0; i < sizeof(errJsons) / sizeof(errJsons[0]); ++i) {
+		StFieldKinds st;
+		ASSERT_NE(st._.Deserialize(errJsons[i]), 0) << errJsons[i];
+		CheckSAXModeSameAsDOMMode<StFieldKinds>(errJsons[i]);
+		CheckSAXModeSameAsDOMMode<StFieldKinds>(errJsons[i], DeserFlag::kMoveFromIntermediateDoc);
+	}
+}
+
+TEST(Deserialize, NoIntermediateDoc_API)
+{
+	const string json = "{\"int_val_2\": 2, \"str_val_2\": \"v2\"}";
+	// With length
+	{
+		SimpleSt st;
+		const string jsonWithTail = json + "{\"int_val_2\": 3}";
+		int ret = st._.Deserialize(jsonWithTail.c_str(), json.length(), DeserFlag::kNoIntermediateDoc);
+		ASSERT_EQ(ret, 0);
+		ASSERT_EQ(st.int_2, 2);
+		ASSERT_STREQ(st.str_2.c_str(), "v2");
+
+		ret = st._.Deserialize(jsonWithTail.c_str(), json.length() - 1, DeserFlag::kNoIntermediateDoc);
+		ASSERT_EQ(ret, ErrorCode::kDeserializeParseFailed);
+	}
+
+	// Parse flags
+	{
+		SimpleSt st;
+		const string jsonWithComment = "{\"int_val_2\": 2, /* comment */ \"str_val_2\": \"v2\",}";
+		int ret = st._.Deserialize<rapidjson::kParseCommentsFlag | rapidjson::kParseTrailingCommasFlag>(
+				jsonWithComment.c_str(), DeserFlag::kNoIntermediateDoc);
+		ASSERT_EQ(ret, 0);
+		ASSERT_EQ(st.int_2, 2);
+		ASSERT_STREQ(st.str_2.c_str(), "v2");
+	}
+
+	// Numbers as strings
+	{
+		SimpleSt st;
+		const string jsonNumber = "{\"str_val_2\": 1.50}";
+		int ret = st._.Deserialize<rapidjson::kParseNumbersAsStringsFlag>(
+				jsonNumber.c_str(), DeserFlag::kNoIntermediateDoc | DeserFlag::kNotCheckFieldStatus);
+		ASSERT_EQ(ret, 0);
+		ASSERT_STREQ(st.str_2.c_str(), "1.50");
+
+		ret = st._.Deserialize<rapidjson::kParseNumbersAsStringsFlag>(
+				json.c_str(), DeserFlag::kNoIntermediateDoc);
+		ASSERT_EQ(ret, ErrorCode::kDeserializeValueTypeError);
+	}
+}
+
+TEST(Deserialize, FromStream)
+{
+	const string json = "{\"int_val_1\": 1, \"int_val_2\": 2, \"str_val_2\": \"a long string value\", \"unk\": [1, 2]}";
+	const DeserFlag::Flag flags[] = {
+			DeserFlag::kNoneFlag, DeserFlag::kNoIntermediateDoc, DeserFlag::kMoveFromIntermediateDoc
+	};
+
+	for (size_t i = 0; i < sizeof(flags) / sizeof(flags[0]); ++i) {
+		// rapidjson stream
+		{
+			SimpleSt st;
+			rapidjson::StringStream is(json.c_str());
+			ASSERT_EQ(st._.DeserializeStream(is, flags[i]), 0);
+			ASSERT_EQ(st.int_2, 2);
+			ASSERT_STREQ(st.str_2.c_str(), "a long string value");
+			ASSERT_EQ(st._.GetUnknown()["unk"][1].GetInt(), 2);
+		}
+
+		// FILE*, with buffer smaller than input
+		{
+			std::FILE* fp = std::tmpfile();
+			ASSERT_TRUE(fp != NULL);
+			ASSERT_EQ(std::fwrite(json.data(), 1, json.size(), fp), json.size());
+			std::rewind(fp);
+			char buffer[7];
+			FileInputStream is(fp, buffer, sizeof(buffer));
+			SimpleSt st;
+			ASSERT_EQ(st._.DeserializeStream<rapidjson::kParseDefaultFlags>(is, flags[i]), 0);
+			ASSERT_EQ(st.int_1, 1);
+			ASSERT_STREQ(st.str_2.c_str(), "a long string value");
+			ASSERT_EQ(is.Tell(), json.size());
+			ASSERT_FALSE(is.HasError());
+
+			std::rewind(fp);
+			SimpleSt st2;
+			ASSERT_EQ(Deserialize(st2, fp, flags[i]), 0);
+			ASSERT_EQ(st2.int_2, 2);
+			ASSERT_STREQ(st2.str_2.c_str(), "a long string value");
+			std::fclose(fp);
+		}
+
+#if defined(__unix__) || defined(__APPLE__)
+		// File descriptor
+		{
+			std::FILE* fp = std::tmpfile();
+			ASSERT_TRUE(fp != NULL);
+			ASSERT_EQ(std::fwrite(json.data(), 1, json.size(), fp), json.size());
+			std::fflush(fp);
+			std::rewind(fp);
+			char buffer[5];
+			FdInputStream is(fileno(fp), buffer, sizeof(buffer));
+			SimpleSt st;
+			ASSERT_EQ(st._.DeserializeStream(is, flags[i]), 0);
+			ASSERT_EQ(st.int_2, 2);
+			ASSERT_STREQ(st.str_2.c_str(), "a long string value");
+
+			std::rewind(fp);
+			SimpleSt st2;
+			ASSERT_EQ(Deserialize(st2, fileno(fp), flags[i]), 0);
+			ASSERT_EQ(st2.int_2, 2);
+			ASSERT_STREQ(st2.str_2.c_str(), "a long string value");
+			std::fclose(fp);
+		}
+
+		// Read error of file descriptor is not reported as parse error
+		{
+			int fds[2];
+			ASSERT_EQ(pipe(fds), 0);
+			close(fds[0]);
+			close(fds[1]);
+			SimpleSt st;
+			rapidjson::Document errDoc;
+			ASSERT_EQ(Deserialize(st, fds[0], flags[i], &errDoc), ErrorCode::kReadFailed);
+			ASSERT_STREQ(errDoc["type"].GetString(), "ReadFailed");
+
+			char buffer[8];
+			FdInputStream is(-1, buffer, sizeof(buffer));
+			ASSERT_TRUE(is.HasError());
+			ASSERT_EQ(st._.DeserializeStream(is, flags[i]), ErrorCode::kReadFailed);
+		}
+#endif
+
+		// std::istream
+		{
+			std::istringstream iss(json);
+			SimpleSt st;
+			ASSERT_EQ(Deserialize(st, iss, flags[i]), 0);
+			ASSERT_EQ(st.int_2, 2);
+			ASSERT_STREQ(st.str_2.c_str(), "a long string value");
+		}
+
+		// Error
+		{
+			std::istringstream iss(json.substr(0, json.size() - 1));
+			char buffer[8];
+			IStreamInputStream is(iss, buffer, sizeof(buffer));
+			SimpleSt st;
+			rapidjson::Document errDoc;
+			ASSERT_EQ(st._.DeserializeStream(is, flags[i], &errDoc), ErrorCode::kDeserializeParseFailed);
+			ASSERT_STREQ(errDoc["type"].GetString(), "ParseError");
+
+			std::istringstream emptyIss;
+			ASSERT_EQ(Deserialize(st, emptyIss, flags[i]), ErrorCode::kDeserializeParseFailed);
+		}
+	}
+
+	// Parse flags
+	{
+		std::istringstream iss("{\"int_val_2\": 2, /* comment */ \"str_val_2\": \"v2\",}");
+		char buffer[4];
+		IStreamInputStream is(iss, buffer, sizeof(buffer));
+		SimpleSt st;
+		int ret = st._.DeserializeStream<rapidjson::kParseCommentsFlag | rapidjson::kParseTrailingCommasFlag>(is);
+		ASSERT_EQ(ret, 0);
+		ASSERT_STREQ(st.str_2.c_str(), "v2");
+	}
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+namespace {
+string WriteTempFile(const string& content)
+{
+	char path[] = "/tmp/ijst_test_XXXXXX";
+	const int fd = mkstemp(path);
+	EXPECT_GE(fd, 0);
+	EXPECT_EQ(write(fd, content.data(), content.size()), static_cast<ssize_t>(content.size()));
+	close(fd);
+	return path;
+}
+}	// namespace
+
+TEST(Deserialize, DeserializeFile)
+{
+	const string json = "{\"str\": \"s\\tr\", \"view\": \"v\\u0041\", \"vec_view\": [\"v1\", \"v2\"]"
+			", \"raw\": {\"k\": \"raw\"}, \"unknown\": \"unk\"}";
+	// Size of the second file is multiple of page size
+	const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+	const string paths[] = {WriteTempFile(json), WriteTempFile(json + string(pageSize - json.size(), ' '))};
+
+	for (size_t i = 0; i < sizeof(paths) / sizeof(paths[0]); ++i) {
+		const char* path = paths[i].c_str();
+
+		// Read only
+		const DeserFlag::Flag flags[] = {
+				DeserFlag::kNoneFlag, DeserFlag::kNoIntermediateDoc, DeserFlag::kMoveFromIntermediateDoc
+		};
+		for (size_t j = 0; j < sizeof(flags) / sizeof(flags[0]); ++j) {
+			StInsitu st;
+			ASSERT_EQ(DeserializeFile(st, path, flags[j]), 0);
+			ASSERT_EQ(st.str, "s\tr");
+			ASSERT_EQ(st.view.size(), 2u);
+			ASSERT_EQ(st.view[1], 'A');
+			ASSERT_STREQ(st.raw.V()["k"].GetString(), "raw");
+			ASSERT_STREQ(st._.GetUnknown()["unknown"].GetString(), "unk");
+		}
+
+		// Copy on write, strings refer to mapping
+		{
+			MappedFile file;
+			StInsitu st;
+			ASSERT_EQ(DeserializeFileInsitu(st, path, file), 0);
+			ASSERT_TRUE(file.IsOpen());
+			ASSERT_EQ(file.Data()[file.Size()], '\0');
+			const char* pBegin = file.Data();
+			const char* pEnd = file.Data() + file.Size();
+			ASSERT_EQ(st.str, "s\tr");
+			ASSERT_EQ(st.view, T_strview("vA"));
+			const char* pRawStr = st.raw.V()["k"].GetString();
+			const char* pUnknownStr = st._.GetUnknown()["unknown"].GetString();
+			ASSERT_STREQ(pRawStr, "raw");
+			ASSERT_STREQ(pUnknownStr, "unk");
+			ASSERT_TRUE(pRawStr >= pBegin && pRawStr < pEnd);
+			ASSERT_TRUE(pUnknownStr >= pBegin && pUnknownStr < pEnd);
+		}
+
+		// File is not modified
+		{
+			StInsitu st;
+			ASSERT_EQ(DeserializeFile<rapidjson::kParseDefaultFlags>(st, path), 0);
+			ASSERT_EQ(st.view, T_strview("vA"));
+		}
+		unlink(path);
+	}
+
+	// Error
+	{
+		StInsitu st;
+		rapidjson::Document errDoc;
+		ASSERT_EQ(DeserializeFile(st, "/nonexistent/ijst.json", DeserFlag::kNoneFlag, &errDoc),
+				  ErrorCode::kReadFailed);
+		ASSERT_STREQ(errDoc["type"].GetString(), "ReadFailed");
+		ASSERT_STREQ(errDoc["path"].GetString(), "/nonexistent/ijst.json");
+
+		MappedFile file;
+		ASSERT_EQ(DeserializeFileInsitu(st, "/tmp", file), ErrorCode::kReadFailed);
+		ASSERT_FALSE(file.IsOpen());
+
+		const string emptyPath = WriteTempFile("");
+		ASSERT_EQ(DeserializeFile(st, emptyPath.c_str()), ErrorCode::kDeserializeParseFailed);
+		ASSERT_EQ(DeserializeFileInsitu(st, emptyPath.c_str(), file), ErrorCode::kDeserializeParseFailed);
+		ASSERT_EQ(file.Size(), 0u);
+		unlink(emptyPath.c_str());
+	}
+}
+#endif
+
+TEST(Deserialize, NoIntermediateDoc_Allocator)
+{
+	const std::string srcJson =
+			"{"
+				"\"val\": {\"unk1\": \"v1\"}, "
+				"\"vec\": [{\"unk2\": \"v2\"}, {\"unk22\": \"v22\"}], "
+				"\"deq\": [{\"unk3\": \"v3\"}, {\"unk33\": \"v33\"}], "
+				"\"list\": [{\"unk4\": \"v4\"}, {\"unk44\": \"v44\"}], "
+				"\"map\": {\"k1\": {\"unk5\": \"v5\"}, \"k11\": {\"unk55\": \"v55\"}}, "
+				"\"obj\": {\"k2\": {\"unk6\": \"v6\"}, \"k22\": {\"unk66\": \"v66\"}}, "
+				"\"raw\": \"v7\""
+			"}";
+
+	StAllocShrink st;
+	int ret = st._.Deserialize(srcJson, DeserFlag::kNoIntermediateDoc | DeserFlag::kMoveFromIntermediateDoc);
+	ASSERT_EQ(ret, 0);
+	ASSERT_EQ(st._.GetAllocator().Size(), 0u);
+	CheckUseOwnAllocator(st);
+
+	std::string destJson;
+	st._.Serialize(destJson);
+	rapidjson::Document srcDoc, destDoc;
+	srcDoc.Parse(srcJson.c_str());
+	destDoc.Parse(destJson.c_str());
+	ASSERT_EQ(srcDoc, destDoc);
+}
+
+IJST_DEFINE_STRUCT(
+		KeyPredictionSt
+		, (T_int, int_1, "i1", FDesc::Optional)
+		, (T_int, int_2, "i2", FDesc::Optional)
+		, (T_int, int_3, "i3", FDesc::Optional)
+)
+
+TEST(Deserialize, KeyPrediction)
+{
+	const MetaClassInfo<char>& metaInfo = ijst::GetMetaInfo<KeyPredictionSt>();
+	const char* jsons[] = {
+			// in order
+			"{\"i1\": 1, \"i2\": 2, \"i3\": 3}",
+			// unknown member between
+			"{\"i1\": 1, \"unk\": 0, \"i2\": 2, \"i3\": 3}",
+			// out of order
+			"{\"i3\": 3, \"i1\": 1, \"i2\": 2}",
+	};
+	const size_t expectedHit[] = {3, 3, 1};
+	const size_t expectedMiss[] = {0, 1, 2};
+	const DeserFlag::Flag flags[] = {DeserFlag::kNoneFlag, DeserFlag::kNoIntermediateDoc};
+
+	for (size_t iFlag = 0; iFlag < sizeof(flags) / sizeof(flags[0]); ++iFlag) {
+		for (size_t i = 0; i < sizeof(jsons) / sizeof(jsons[0]); ++i) {
+			metaInfo.ResetKeyPredictionStat();
+			KeyPredictionSt st;
+			ASSERT_EQ(st._.Deserialize(jsons[i], flags[iFlag]), 0);
+			ASSERT_EQ(st.int_1, 1);
+			ASSERT_EQ(st.int_2, 2);
+			ASSERT_EQ(st.int_3, 3);
+#if IJST_KEY_PREDICTION_STAT
+			ASSERT_EQ(metaInfo.GetKeyPredictionHit(), expectedHit[i]);
+			ASSERT_EQ(metaInfo.GetKeyPredictionMiss(), expectedMiss[i]);
+#else
+			(void)expectedHit; (void)expectedMiss;
+#endif
+		}
+	}
+
+	// FromJson with const value
+	{
+		metaInfo.ResetKeyPredictionStat();
+		rapidjson::Document doc;
+		doc.Parse(jsons[1]);
+		KeyPredictionSt st;
+		ASSERT_EQ(st._.FromJson(doc), 0);
+		ASSERT_EQ(st.int_3, 3);
+#if IJST_KEY_PREDICTION_STAT
+		ASSERT_EQ(metaInfo.GetKeyPredictionHit(), 3u);
+		ASSERT_EQ(metaInfo.GetKeyPredictionMiss(), 1u);
+#endif
+	}
+}
+
+IJST_DEFINE_STRUCT(
+		DupJsonNameSt
+		, (T_int, int_1, "k", FDesc::Optional)
+		, (T_int, int_2, "d", FDesc::Optional)
+		, (T_int, int_3, "k", FDesc::Optional)
+)
+
+TEST(Deserialize, KeyPredictionDupJsonName)
+{
+	// The first field wins whatever the order of keys is
+	const char* jsons[] = {
+			"{\"k\": 1, \"d\": 2}",
+			"{\"d\": 2, \"k\": 1}",
+	};
+	const DeserFlag::Flag flags[] = {DeserFlag::kNoneFlag, DeserFlag::kNoIntermediateDoc};
+
+	for (size_t iFlag = 0; iFlag < sizeof(flags) / sizeof(flags[0]); ++iFlag) {
+		for (size_t i = 0; i < sizeof(jsons) / sizeof(jsons[0]); ++i) {
+			DupJsonNameSt st;
+			ASSERT_EQ(st._.Deserialize(jsons[i], flags[iFlag]), 0);
+			ASSERT_EQ(IJST_GET_STATUS(st, int_1), (EFStatus)FStatus::kValid);
+			ASSERT_EQ(st.int_1, 1);
+			ASSERT_EQ(st.int_2, 2);
+			ASSERT_EQ(IJST_GET_STATUS(st, int_3), (EFStatus)FStatus::kMissing);
+		}
+	}
+}
@@ -100,3 +100,46 @@ TEST(Detail, CancelableWriter)
 	ASSERT_TRUE(val[9].IsNull());
 	ASSERT_EQ(val.Size(), 10u);
 }
+
+TEST(Detail, ResourcePool)
+{
+#if __cplusplus >= 201103L
+	typedef detail::ResourcePool Pool;
+	Pool::Trim();
+	ASSERT_EQ(Pool::GetCachedCount(), 0u);
+
+	// blocks in same size class are recycled
+	void* p1 = Pool::Alloc(20);
+	Pool::Free(p1, 20);
+	ASSERT_EQ(Pool::GetCachedCount(), 1u);
+	void* p2 = Pool::Alloc(30);
+	ASSERT_EQ(p2, p1);
+	ASSERT_EQ(Pool::GetCachedCount(), 0u);
+
+	// blocks in different size class
+	void* p3 = Pool::Alloc(40);
+	Pool::Free(p2, 30);
+	Pool::Free(p3, 40);
+	ASSERT_EQ(Pool::GetCachedCount(), 2u);
+	ASSERT_EQ(Pool::Alloc(33), p3);
+	Pool::Free(p3, 33);
+
+	// large block is not cached
+	void* pLarge = Pool::Alloc(Pool::kAlignSize * Pool::kClassCount + 1);
+	Pool::Free(pLarge, Pool::kAlignSize * Pool::kClassCount + 1);
+	ASSERT_EQ(Pool::GetCachedCount(), 2u);
+
+	// count of cached blocks is limited
+	std::vector<void*> blocks;
+	for (size_t i = 0; i < Pool::kMaxCachedPerClass + 2; ++i) {
+		blocks.push_back(Pool::Alloc(8));
+	}
+	for (size_t i = 0; i < blocks.size(); ++i) {
+		Pool::Free(blocks[i], 8);
+	}
+	ASSERT_EQ(Pool::GetCachedCount(), Pool::kMaxCachedPerClass + 2);
+
+	Pool::Trim();
+	ASSERT_EQ(Pool::GetCachedCount(), 0u);
+#endif
+}
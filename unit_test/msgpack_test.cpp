@@ -0,0 +1,479 @@
+//
+// Test of MessagePack writer and reader
+//
+#include "util.h"
+#include <ijst/msgpack.h>
+
+using std::string;
+using std::vector;
+using namespace ijst;
+
+namespace {
+
+string Bytes(const char* hex)
+{
+	string ret;
+	for (const char* p = hex; *p != '\0'; ) {
+		if (*p == ' ') {
+			++p;
+			continue;
+		}
+		ret.push_back(static_cast<char>(std::strtol(string(p, 2).c_str(), NULL, 16)));
+		p += 2;
+	}
+	return ret;
+}
+
+template<typename Func>
+string Write(Func func)
+{
+	string out;
+	MsgPackWriter writer(out);
+	func(writer);
+	return out;
+}
+
+void CheckReadAsJson(const string& msgpack, const char* json)
+{
+	MsgPackReader reader(msgpack.data(), msgpack.size());
+	rapidjson::Document doc;
+	doc.Populate(reader);
+	ASSERT_FALSE(reader.HasParseError());
+
+	rapidjson::Document expected;
+	expected.Parse(json);
+	ASSERT_EQ(doc, expected);
+}
+
+struct WriteInt64 {
+	int64_t v;
+	void operator()(MsgPackWriter& w) const { w.Int64(v); }
+};
+struct WriteUint64 {
+	uint64_t v;
+	void operator()(MsgPackWriter& w) const { w.Uint64(v); }
+};
+
+string Int64Bytes(int64_t v) { WriteInt64 f = {v}; return Write(f); }
+string Uint64Bytes(uint64_t v) { WriteUint64 f = {v}; return Write(f); }
+
+}	// namespace
+
+TEST(MsgPack, WriteScalar)
+{
+	// int
+	ASSERT_EQ(Int64Bytes(0), Bytes("00"));
+	ASSERT_EQ(Int64Bytes(127), Bytes("7f"));
+	ASSERT_EQ(Int64Bytes(-1), Bytes("ff"));
+	ASSERT_EQ(Int64Bytes(-32), Bytes("e0"));
+	ASSERT_EQ(Int64Bytes(-33), Bytes("d0 df"));
+	ASSERT_EQ(Int64Bytes(-129), Bytes("d1 ff 7f"));
+	ASSERT_EQ(Int64Bytes(-32769), Bytes("d2 ff ff 7f ff"));
+	ASSERT_EQ(Int64Bytes(-2147483649LL), Bytes("d3 ff ff ff ff 7f ff ff ff"));
+	ASSERT_EQ(Uint64Bytes(128), Bytes("cc 80"));
+	ASSERT_EQ(Uint64Bytes(256), Bytes("cd 01 00"));
+	ASSERT_EQ(Uint64Bytes(65536), Bytes("ce 00 01 00 00"));
+	ASSERT_EQ(Uint64Bytes(18446744073709551615ULL), Bytes("cf ff ff ff ff ff ff ff ff"));
+
+	string out;
+	MsgPackWriter writer(out);
+	writer.Null();
+	writer.Bool(false);
+	writer.Bool(true);
+	writer.Double(1.5);
+	writer.String("abc", 3);
+	ASSERT_EQ(out, Bytes("c0 c2 c3 cb 3f f8 00 00 00 00 00 00 a3 61 62 63"));
+
+	// str length
+	out.clear();
+	const string str31(31, 'a'), str32(32, 'a'), str256(256, 'a');
+	writer.String(str31.data(), 31);
+	ASSERT_EQ(out, Bytes("bf") + str31);
+	out.clear();
+	writer.String(str32.data(), 32);
+	ASSERT_EQ(out, Bytes("d9 20") + str32);
+	out.clear();
+	writer.String(str256.data(), 256);
+	ASSERT_EQ(out, Bytes("da 01 00") + str256);
+}
+
+TEST(MsgPack, WriteContainer)
+{
+	string out;
+	MsgPackWriter writer(out);
+	writer.StartObject();
+	writer.Key("a", 1);
+	writer.StartArray();
+	for (int i = 0; i < 16; ++i) {
+		writer.Int(i);
+	}
+	writer.EndArray(16);
+	writer.Key("b", 1);
+	writer.StartArray();
+	writer.StartObject();
+	writer.EndObject(0);
+	writer.EndArray(1);
+	writer.EndObject(2);
+	ASSERT_TRUE(writer.IsComplete());
+	ASSERT_EQ(out, Bytes("82 a1 61 dc 00 10 00 01 02 03 04 05 06 07 08 09 0a 0b 0c 0d 0e 0f a1 62 91 80"));
+
+	// Mismatched end
+	string out2;
+	MsgPackWriter writer2(out2);
+	ASSERT_FALSE(writer2.EndArray());
+	writer2.StartArray();
+	ASSERT_FALSE(writer2.Key("k", 1));
+	ASSERT_FALSE(writer2.EndObject());
+	ASSERT_FALSE(writer2.IsComplete());
+}
+
+TEST(MsgPack, Read)
+{
+	CheckReadAsJson(Bytes("82 a1 61 dc 00 03 00 ff cc 80 a1 62 93 c0 c2 c3"), "{\"a\": [0, -1, 128], \"b\": [null, false, true]}");
+	CheckReadAsJson(Bytes("93 cb 3f f8 00 00 00 00 00 00 ca 3f c0 00 00 d9 03 61 62 63"), "[1.5, 1.5, \"abc\"]");
+	CheckReadAsJson(Bytes("94 d0 df d1 ff 7f d2 ff ff 7f ff d3 ff ff ff ff 7f ff ff ff"), "[-33, -129, -32769, -2147483649]");
+	CheckReadAsJson(Bytes("93 cd 01 00 ce 00 01 00 00 cf ff ff ff ff ff ff ff ff"), "[256, 65536, 18446744073709551615]");
+	CheckReadAsJson(Bytes("de 00 01 da 00 01 6b dd 00 00 00 00"), "{\"k\": []}");
+
+	// Errors
+	struct ErrCase {
+		const char* hex;
+		rapidjson::ParseErrorCode code;
+		size_t offset;
+	} errCases[] = {
+		{"", rapidjson::kParseErrorDocumentEmpty, 0},
+		{"92 01", rapidjson::kParseErrorValueInvalid, 2},
+		{"cd 01", rapidjson::kParseErrorValueInvalid, 1},
+		{"a3 61 62", rapidjson::kParseErrorValueInvalid, 0},
+		{"81 01 01", rapidjson::kParseErrorObjectMissName, 1},
+		{"91 c4 01 00", rapidjson::kParseErrorValueInvalid, 1},
+		{"01 02", rapidjson::kParseErrorDocumentRootNotSingular, 1},
+	};
+	for (size_t i = 0; i < sizeof(errCases) / sizeof(errCases[0]); ++i) {
+		const string data = Bytes(errCases[i].hex);
+		MsgPackReader reader(data.data(), data.size());
+		rapidjson::Document doc;
+		const rapidjson::ParseResult ret = reader.Parse(doc);
+		ASSERT_TRUE(ret.IsError()) << errCases[i].hex;
+		ASSERT_EQ(ret.Code(), errCases[i].code) << errCases[i].hex;
+		ASSERT_EQ(ret.Offset(), errCases[i].offset) << errCases[i].hex;
+	}
+}
+
+IJST_DEFINE_STRUCT(
+		MsgPackInner
+		, (T_int, i, "i", 0)
+		, (T_string, s, "s", 0)
+)
+
+IJST_DEFINE_STRUCT(
+		MsgPackSt
+		, (T_bool, b, "b", 0)
+		, (T_int64, i64, "i64", 0)
+		, (T_uint64, u64, "u64", 0)
+		, (T_double, d, "d", 0)
+		, (T_string, s, "s", 0)
+		, (IJST_TVEC(T_int), vi, "vi", 0)
+		, (IJST_TMAP(IJST_TST(MsgPackInner)), map, "map", 0)
+		, (T_raw, raw, "raw", 0)
+		, (T_int, nullVal, "null_val", FDesc::Nullable)
+)
+
+TEST(MsgPack, Accessor)
+{
+	const string json = "{\"b\": true, \"i64\": -4294967296, \"u64\": 18446744073709551615, \"d\": 0.5, \"s\": \"str\""
+			", \"vi\": [1, -2, 300], \"map\": {\"k1\": {\"i\": 1, \"s\": \"s1\"}, \"k2\": {\"i\": 2, \"s\": \"s2\"}}"
+			", \"raw\": {\"r\": [null, 1.25]}, \"null_val\": null, \"unknown\": [\"u\"]}";
+	MsgPackSt src;
+	ASSERT_EQ(src._.Deserialize(json), 0);
+	string msgpack;
+	ASSERT_EQ(SerializeMsgPack(src, msgpack), 0);
+	ASSERT_LT(msgpack.size(), json.size());
+
+	string expectedJson;
+	ASSERT_EQ(src._.Serialize(expectedJson), 0);
+
+	const DeserFlag::Flag flags[] = {DeserFlag::kNoneFlag, DeserFlag::kNoIntermediateDoc};
+	for (size_t i = 0; i < sizeof(flags) / sizeof(flags[0]); ++i)
+	{
+		MsgPackSt st;
+		ASSERT_EQ(DeserializeMsgPack(st, msgpack.data(), msgpack.size(), flags[i]), 0);
+		ASSERT_EQ(st.u64, 18446744073709551615ULL);
+		ASSERT_EQ(st.map["k2"].s, "s2");
+		ASSERT_EQ(st._.GetUnknown()["unknown"][0], "u");
+		ASSERT_EQ(IJST_GET_STATUS(st, nullVal), FStatus::kNull);
+		string outJson;
+		ASSERT_EQ(st._.Serialize(outJson), 0);
+		ASSERT_EQ(outJson, expectedJson);
+
+		// Parse error
+		rapidjson::Document errDoc;
+		ASSERT_EQ(DeserializeMsgPack(st, msgpack.data(), msgpack.size() - 1, flags[i], &errDoc),
+				  ErrorCode::kDeserializeParseFailed);
+		ASSERT_STREQ(errDoc["type"].GetString(), "ParseError");
+
+		// Type error
+		string errMsgPack;
+		MsgPackWriter writer(errMsgPack);
+		writer.StartObject();
+		writer.Key("vi", 2);
+		writer.StartArray();
+		writer.String("1", 1);
+		writer.EndArray();
+		writer.EndObject();
+		ASSERT_EQ(DeserializeMsgPack(st, errMsgPack.data(), errMsgPack.size(), flags[i], &errDoc),
+				  ErrorCode::kDeserializeValueTypeError);
+		ASSERT_STREQ(errDoc["member"].GetString(), "vi");
+	}
+}
+
+TEST(MsgPack, PackedArray)
+{
+	string out;
+	MsgPackWriter writer(out);
+	const int ints[] = {1, -1};
+	writer.PackedArray(ints, 2);
+	ASSERT_EQ(out, Bytes("c7 08 01 01 00 00 00 ff ff ff ff"));
+	CheckReadAsJson(out, "[1, -1]");
+
+	out.clear();
+	const double doubles[] = {1.5};
+	writer.PackedArray(doubles, 1);
+	ASSERT_EQ(out, Bytes("c7 08 05 00 00 00 00 00 00 f8 3f"));
+	CheckReadAsJson(out, "[1.5]");
+
+	const uint64_t u64s[] = {0, 18446744073709551615ULL};
+	const int64_t i64s[] = {-4294967296LL};
+	const unsigned uints[] = {4294967295u};
+	out.clear();
+	writer.StartArray();
+	writer.PackedArray(u64s, 2);
+	writer.PackedArray(i64s, 1);
+	writer.PackedArray(uints, 1);
+	writer.PackedArray(ints, 0);
+	writer.EndArray();
+	CheckReadAsJson(out, "[[0, 18446744073709551615], [-4294967296], [4294967295], []]");
+
+	// Length is not multiple of element size, or unknown ext type
+	const char* errCases[] = {"c7 03 01 00 00 00", "c7 01 06 00", "c7 04 01 00 00"};
+	for (size_t i = 0; i < sizeof(errCases) / sizeof(errCases[0]); ++i) {
+		const string data = Bytes(errCases[i]);
+		MsgPackReader reader(data.data(), data.size());
+		rapidjson::Document doc;
+		ASSERT_EQ(reader.Parse(doc).Code(), rapidjson::kParseErrorValueInvalid) << errCases[i];
+	}
+}
+
+IJST_DEFINE_STRUCT(
+		BinaryInner
+		, (T_int, i, "i", 0)
+		, (IJST_TVEC(T_double), vd, "vd", FDesc::Optional)
+)
+
+IJST_DEFINE_STRUCT(
+		BinarySt
+		, (T_string, s, "s", 0)
+		, (IJST_TVEC(T_int), vi, "vi", 0)
+		, (IJST_TVEC(T_uint64), vu64, "vu64", FDesc::Optional)
+		, (IJST_TST(BinaryInner), inner, "inner", 0)
+		, (IJST_TST(BinaryInner), nullInner, "null_inner", FDesc::Nullable)
+		, (IJST_TVEC(IJST_TST(BinaryInner)), vst, "vst", 0)
+		, (T_int, nullVal, "null_val", FDesc::Nullable)
+)
+
+IJST_DEFINE_STRUCT(
+		BinaryInnerRenamed
+		, (T_int, i, "i2", 0)
+		, (IJST_TVEC(T_double), vd, "vd", FDesc::Optional)
+)
+
+// Structs with the same name in different namespaces, which differ only in type of field
+namespace fp_int {
+IJST_DEFINE_STRUCT(
+		FingerprintSt
+		, (T_int, v, "v", 0)
+		, (IJST_TVEC(T_int), vec, "vec", 0)
+)
+}	// namespace fp_int
+
+namespace fp_same {
+IJST_DEFINE_STRUCT(
+		FingerprintSt
+		, (T_int, v, "v", 0)
+		, (IJST_TLIST(T_int), vec, "vec", 0)
+)
+}	// namespace fp_same
+
+namespace fp_string {
+IJST_DEFINE_STRUCT(
+		FingerprintSt
+		, (T_string, v, "v", 0)
+		, (IJST_TVEC(T_int), vec, "vec", 0)
+)
+}	// namespace fp_string
+
+namespace fp_elem {
+IJST_DEFINE_STRUCT(
+		FingerprintSt
+		, (T_int, v, "v", 0)
+		, (IJST_TVEC(T_int64), vec, "vec", 0)
+)
+}	// namespace fp_elem
+
+namespace fp_st {
+IJST_DEFINE_STRUCT(
+		FingerprintSt
+		, (IJST_TST(fp_int::FingerprintSt), v, "v", 0)
+		, (IJST_TVEC(T_int), vec, "vec", 0)
+)
+}	// namespace fp_st
+
+namespace fp_raw {
+IJST_DEFINE_STRUCT(
+		FingerprintSt
+		, (T_raw, v, "v", 0)
+		, (IJST_TVEC(T_int), vec, "vec", 0)
+)
+}	// namespace fp_raw
+
+namespace fp_st2 {
+IJST_DEFINE_STRUCT(
+		FingerprintSt
+		, (IJST_TST(fp_string::FingerprintSt), v, "v", 0)
+		, (IJST_TVEC(T_int), vec, "vec", 0)
+)
+}	// namespace fp_st2
+
+TEST(MsgPack, SchemaFingerprintOfType)
+{
+	const uint64_t fpInt = GetMetaInfo<fp_int::FingerprintSt>().GetSchemaFingerprint();
+	// Containers with the same encoding
+	ASSERT_EQ(fpInt, GetMetaInfo<fp_same::FingerprintSt>().GetSchemaFingerprint());
+	// Type of field
+	ASSERT_NE(fpInt, GetMetaInfo<fp_string::FingerprintSt>().GetSchemaFingerprint());
+	// Type of element
+	ASSERT_NE(fpInt, GetMetaInfo<fp_elem::FingerprintSt>().GetSchemaFingerprint());
+	// Nested struct and raw
+	const uint64_t fpSt = GetMetaInfo<fp_st::FingerprintSt>().GetSchemaFingerprint();
+	ASSERT_NE(fpSt, GetMetaInfo<fp_raw::FingerprintSt>().GetSchemaFingerprint());
+	// Nested structs with the same name
+	ASSERT_NE(fpSt, GetMetaInfo<fp_st2::FingerprintSt>().GetSchemaFingerprint());
+
+	// Mismatched peers are detected
+	fp_int::FingerprintSt src;
+	src.v = 1;
+	src.vec.push_back(2);
+	string binary;
+	ASSERT_EQ(SerializeBinary(src, binary), 0);
+	fp_string::FingerprintSt dest;
+	ASSERT_EQ(DeserializeBinary(dest, binary.data(), binary.size()), ErrorCode::kDeserializeSchemaMismatch);
+	fp_same::FingerprintSt same;
+	ASSERT_EQ(DeserializeBinary(same, binary.data(), binary.size()), 0);
+	ASSERT_EQ(same.vec.front(), 2);
+}
+
+TEST(MsgPack, Binary)
+{
+	const string json = "{\"s\": \"str\", \"vi\": [1, -2, 300], \"vu64\": [18446744073709551615]"
+			", \"inner\": {\"i\": 1, \"vd\": [0.5, 1.5], \"inner_unknown\": 1}, \"null_inner\": null"
+			", \"vst\": [{\"i\": 2}, {\"i\": 3, \"vd\": []}], \"null_val\": null, \"unknown\": [\"u\"]}";
+	BinarySt src;
+	ASSERT_EQ(src._.Deserialize(json), 0);
+	string binary;
+	ASSERT_EQ(SerializeBinary(src, binary), 0);
+	ASSERT_LT(binary.size(), json.size());
+
+	// Fingerprint
+	const uint64_t fingerprint = src._.GetMetaInfo().GetSchemaFingerprint();
+	for (int i = 0; i < 8; ++i) {
+		ASSERT_EQ(static_cast<unsigned char>(binary[i]), static_cast<unsigned char>(fingerprint >> (8 * i)));
+	}
+	ASSERT_NE(GetMetaInfo<BinaryInner>().GetSchemaFingerprint(), GetMetaInfo<BinaryInnerRenamed>().GetSchemaFingerprint());
+
+	string expectedJson;
+	ASSERT_EQ(src._.Serialize(expectedJson), 0);
+	{
+		BinarySt st;
+		ASSERT_EQ(DeserializeBinary(st, binary.data(), binary.size()), 0);
+		ASSERT_EQ(st.vu64[0], 18446744073709551615ULL);
+		ASSERT_EQ(st.inner.vd[1], 1.5);
+		ASSERT_EQ(st.inner._.GetUnknown()["inner_unknown"].GetInt(), 1);
+		ASSERT_EQ(IJST_GET_STATUS(st, nullInner), FStatus::kNull);
+		ASSERT_EQ(IJST_GET_STATUS(st, nullVal), FStatus::kNull);
+		string outJson;
+		ASSERT_EQ(st._.Serialize(outJson), 0);
+		ASSERT_EQ(outJson, expectedJson);
+	}
+
+	// Serialize flags
+	{
+		string binaryIgnore;
+		ASSERT_EQ(SerializeBinary(src, binaryIgnore, SerFlag::kIgnoreNull | SerFlag::kIgnoreUnknown), 0);
+		BinarySt st;
+		// Null fields are required
+		ASSERT_EQ(DeserializeBinary(st, binaryIgnore.data(), binaryIgnore.size()), ErrorCode::kDeserializeSomeFieldsInvalid);
+		ASSERT_EQ(DeserializeBinary(st, binaryIgnore.data(), binaryIgnore.size(), DeserFlag::kNotCheckFieldStatus), 0);
+		ASSERT_EQ(IJST_GET_STATUS(st, nullVal), FStatus::kMissing);
+		ASSERT_TRUE(st._.GetUnknown().ObjectEmpty());
+		ASSERT_TRUE(st.inner._.GetUnknown().ObjectEmpty());
+	}
+
+	// Unknown
+	{
+		BinarySt st;
+		ASSERT_EQ(DeserializeBinary(st, binary.data(), binary.size(), DeserFlag::kIgnoreUnknown), 0);
+		ASSERT_TRUE(st._.GetUnknown().ObjectEmpty());
+		rapidjson::Document errDoc;
+		ASSERT_EQ(DeserializeBinary(st, binary.data(), binary.size(), DeserFlag::kErrorWhenUnknown, &errDoc),
+				  ErrorCode::kDeserializeSomeUnknownMember);
+		ASSERT_STREQ(errDoc["err"]["jsonKey"].GetString(), "inner_unknown");
+	}
+
+	// Schema mismatch
+	{
+		BinarySt st;
+		rapidjson::Document errDoc;
+		string errBinary = binary;
+		errBinary[0] = static_cast<char>(errBinary[0] + 1);
+		ASSERT_EQ(DeserializeBinary(st, errBinary.data(), errBinary.size(), DeserFlag::kNoneFlag, &errDoc),
+				  ErrorCode::kDeserializeSchemaMismatch);
+		ASSERT_STREQ(errDoc["type"].GetString(), "SchemaMismatch");
+		ASSERT_STREQ(errDoc["struct"].GetString(), "BinarySt");
+
+		BinaryInnerRenamed inner;
+		string innerBinary;
+		ASSERT_EQ(SerializeBinary(inner, innerBinary, SerFlag::kIgnoreMissing), 0);
+		BinarySt outer;
+		outer.s = "s";
+		IJST_MARK_VALID(outer, s);
+		string outerBinary;
+		ASSERT_EQ(SerializeBinary(outer, outerBinary, SerFlag::kIgnoreMissing), 0);
+		// Replace the end of fields and unknown by the field of inner
+		errBinary = outerBinary.substr(0, outerBinary.size() - 2);
+		SchemaBinaryWriter writer(errBinary);
+		writer.Varint((3 + 1) * 2);
+		errBinary += innerBinary;
+		writer.Varint(0);
+		writer.Varint(0);
+		ASSERT_EQ(DeserializeBinary(st, errBinary.data(), errBinary.size(), DeserFlag::kNoneFlag, &errDoc),
+				  ErrorCode::kDeserializeSchemaMismatch);
+		ASSERT_STREQ(errDoc["type"].GetString(), "ErrInObject");
+		ASSERT_STREQ(errDoc["member"].GetString(), "inner");
+		ASSERT_STREQ(errDoc["err"]["struct"].GetString(), "BinaryInner");
+	}
+
+	// Parse error
+	{
+		BinarySt st;
+		rapidjson::Document errDoc;
+		for (size_t len = 0; len < binary.size(); len += 7) {
+			ASSERT_EQ(DeserializeBinary(st, binary.data(), len, DeserFlag::kNoneFlag, &errDoc),
+					  ErrorCode::kDeserializeParseFailed) << len;
+			ASSERT_STREQ(errDoc["type"].GetString(), "ParseError");
+		}
+		const string tail = binary + Bytes("00");
+		ASSERT_EQ(DeserializeBinary(st, tail.data(), tail.size(), DeserFlag::kNoneFlag, &errDoc),
+				  ErrorCode::kDeserializeParseFailed);
+		ASSERT_EQ(errDoc["errCode"].GetInt(), rapidjson::kParseErrorDocumentRootNotSingular);
+	}
+}
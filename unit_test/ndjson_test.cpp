@@ -0,0 +1,171 @@
+//
+// Test of newline-delimited JSON reader and writer
+//
+// Split input into small chunks so that multiple threads are used in tests
+#define IJST_NDJSON_MIN_CHUNK_SIZE 1
+#include "util.h"
+#include <ijst/ndjson.h>
+#include <ijst/stream.h>
+#include <sstream>
+
+using std::string;
+using std::vector;
+using namespace ijst;
+
+IJST_DEFINE_STRUCT(
+		NdSt
+		, (T_int, id, "id", 0)
+		, (T_string, name, "name", FDesc::Optional)
+		, (IJST_TVEC(T_int), vec, "vec", FDesc::Optional)
+)
+
+namespace {
+string NdLine(int id)
+{
+	std::ostringstream oss;
+	oss << "{\"id\": " << id << ", \"name\": \"name_" << id << "\", \"vec\": [" << id << ", " << id * 2 << "]}";
+	return oss.str();
+}
+}	// namespace
+
+TEST(Ndjson, Deserialize)
+{
+	// Line numbers of errors: 3 (blank line 2 is skipped), 50 (parse error), 51 (type error), 100 (missing member)
+	string input;
+	vector<int> expectedIds;
+	for (int line = 1; line <= 100; ++line) {
+		if (line == 2) {
+			input += " \t\r\n";
+		}
+		else if (line == 3) {
+			input += "{\"id\": \"3\"}\n";
+		}
+		else if (line == 50) {
+			input += "{\"id\": 50,\n";
+		}
+		else if (line == 51) {
+			input += "{\"id\": 51, \"vec\": [\"1\"]}\r\n";
+		}
+		else if (line == 100) {
+			// Last line without '\n'
+			input += "{}";
+		}
+		else {
+			input += NdLine(line) + "\n";
+			expectedIds.push_back(line);
+		}
+	}
+
+	const DeserFlag::Flag flags[] = {
+			DeserFlag::kNoneFlag, DeserFlag::kNoIntermediateDoc, DeserFlag::kMoveFromIntermediateDoc
+	};
+	const unsigned threadCounts[] = {1, 3, 8, 0, 200};
+	for (size_t i = 0; i < sizeof(flags) / sizeof(flags[0]); ++i) {
+		for (size_t j = 0; j < sizeof(threadCounts) / sizeof(threadCounts[0]); ++j) {
+			vector<NdSt> output(1);
+			rapidjson::Document errDoc;
+			int ret = DeserializeNdjson(input.c_str(), input.size(), output, flags[i], &errDoc, threadCounts[j]);
+			ASSERT_EQ(ret, ErrorCode::kDeserializeValueTypeError);
+
+			// Appended in order
+			ASSERT_EQ(output.size(), expectedIds.size() + 1);
+			for (size_t k = 0; k < expectedIds.size(); ++k) {
+				const NdSt& st = output[k + 1];
+				ASSERT_EQ(st.id, expectedIds[k]);
+				ASSERT_EQ(st.name, "name_" + std::to_string(st.id));
+				ASSERT_EQ(st.vec.size(), 2u);
+				ASSERT_EQ(st.vec[1], st.id * 2);
+			}
+
+			// Errors
+			ASSERT_TRUE(errDoc.IsArray());
+			ASSERT_EQ(errDoc.Size(), 4u);
+			const unsigned errLines[] = {3, 50, 51, 100};
+			const char* errTypes[] = {"ErrInObject", "ParseError", "ErrInObject", "MissingMember"};
+			for (rapidjson::SizeType k = 0; k < errDoc.Size(); ++k) {
+				ASSERT_STREQ(errDoc[k]["type"].GetString(), "ErrInLine");
+				ASSERT_EQ(errDoc[k]["line"].GetUint(), errLines[k]);
+				ASSERT_STREQ(errDoc[k]["err"]["type"].GetString(), errTypes[k]);
+			}
+		}
+	}
+
+	// Without error doc
+	{
+		vector<NdSt> output;
+		ASSERT_EQ(DeserializeNdjson(input.c_str(), input.size(), output, DeserFlag::kNoneFlag, NULL, 4),
+				  ErrorCode::kDeserializeValueTypeError);
+		ASSERT_EQ(output.size(), expectedIds.size());
+	}
+
+	// Empty input
+	{
+		vector<NdSt> output;
+		rapidjson::Document errDoc;
+		ASSERT_EQ(DeserializeNdjson(input.c_str(), 0, output, DeserFlag::kNoneFlag, &errDoc, 4), 0);
+		ASSERT_TRUE(output.empty());
+		ASSERT_TRUE(errDoc.IsArray());
+		ASSERT_EQ(errDoc.Size(), 0u);
+	}
+
+	// Parse flags
+	{
+		const string jsonWithComment = "{\"id\": 1, /* comment */}\n{\"id\": 2}\n";
+		vector<NdSt> output;
+		int ret = DeserializeNdjson<rapidjson::kParseCommentsFlag | rapidjson::kParseTrailingCommasFlag>(
+				jsonWithComment.c_str(), jsonWithComment.size(), output);
+		ASSERT_EQ(ret, 0);
+		ASSERT_EQ(output.size(), 2u);
+		ASSERT_EQ(output[0].id, 1);
+		ASSERT_EQ(output[1].id, 2);
+	}
+}
+
+TEST(Ndjson, Serialize)
+{
+	vector<NdSt> input(20);
+	for (size_t i = 0; i < input.size(); ++i) {
+		IJST_SET(input[i], id, static_cast<int>(i));
+		if (i % 2 == 0) {
+			IJST_SET(input[i], name, "n\n" + std::to_string(i));
+		}
+	}
+
+	string expected;
+	for (size_t i = 0; i < input.size(); ++i) {
+		string json;
+		ASSERT_EQ(input[i]._.Serialize(json), 0);
+		expected += json + "\n";
+	}
+
+	// To string, appended
+	string output = "head\n";
+	ASSERT_EQ(SerializeNdjson(input.begin(), input.end(), output), 0);
+	ASSERT_EQ(output, "head\n" + expected);
+
+	// To stream
+	rapidjson::StringBuffer sb;
+	ASSERT_EQ(SerializeNdjsonToStream(input.begin(), input.end(), sb), 0);
+	ASSERT_EQ(string(sb.GetString(), sb.GetSize()), expected);
+
+	// Round trip
+	vector<NdSt> values;
+	ASSERT_EQ(DeserializeNdjson(expected.c_str(), expected.size(), values, DeserFlag::kNoneFlag, NULL, 4), 0);
+	ASSERT_EQ(values.size(), input.size());
+	for (size_t i = 0; i < values.size(); ++i) {
+		ASSERT_EQ(values[i].id, input[i].id);
+		ASSERT_EQ(values[i].name, input[i].name);
+	}
+
+#if defined(__unix__) || defined(__APPLE__)
+	// Write failed
+	{
+		std::FILE* fp = std::fopen("/dev/null", "r");
+		ASSERT_TRUE(fp != NULL);
+		char buffer[16];
+		FileOutputStream os(fp, buffer, sizeof(buffer));
+		ASSERT_EQ(SerializeNdjsonToStream(input.begin(), input.end(), os), ErrorCode::kWriteFailed);
+		std::fclose(fp);
+	}
+#endif
+}
@@ -0,0 +1,107 @@
+//
+// Test of deserializing array in threads with DeserFlag::kParallelArray, requires IJST_ENABLE_PARALLEL_ARRAY=1
+//
+#include "util.h"
+#include <sstream>
+
+using std::string;
+using std::vector;
+using namespace ijst;
+
+IJST_DEFINE_STRUCT(
+		PaArrInner
+		, (T_int, v, "v", 0)
+)
+
+IJST_DEFINE_STRUCT(
+		PaArrElem
+		, (T_int, id, "id", 0)
+		, (T_string, name, "name", FDesc::Optional)
+		, (IJST_TVEC(IJST_TST(PaArrInner)), inners, "inners", FDesc::Optional)
+		, (IJST_TMAP(IJST_TST(PaArrInner)), innerMap, "inner_map", FDesc::Optional)
+)
+
+IJST_DEFINE_STRUCT(
+		PaArraySt
+		, (IJST_TVEC(IJST_TST(PaArrElem)), vec, "vec", 0)
+		, (IJST_TLIST(IJST_TST(PaArrInner)), lst, "lst", FDesc::Optional)
+)
+
+namespace {
+string PaArrInput(int id)
+{
+	std::ostringstream oss;
+	oss << "{\"id\": " << id << ", \"name\": \"name_" << id << "\", \"inners\": [{\"v\": " << id
+		<< "}], \"inner_map\": {\"k\": {\"v\": " << id * 2 << "}}}";
+	return oss.str();
+}
+
+void CheckPaArrOutput(const PaArrElem& st, int id)
+{
+	ASSERT_EQ(st.id, id);
+	ASSERT_EQ(st.name, "name_" + std::to_string(id));
+	ASSERT_EQ(st.inners.size(), 1u);
+	ASSERT_EQ(st.inners[0].v, id);
+	ASSERT_EQ(st.innerMap.size(), 1u);
+	ASSERT_EQ(st.innerMap.at("k").v, id * 2);
+}
+}	// namespace
+
+TEST(Parallel, ParallelArray)
+{
+	// Large enough to be split into shards, see IJST_PARALLEL_ARRAY_MIN_SHARD_SIZE
+	const int size = 5000;
+	string json = "{\"vec\": [";
+	string lstJson = "\"lst\": [";
+	for (int i = 0; i < size; ++i) {
+		json += (i == 0 ? "" : ", ") + PaArrInput(i);
+		lstJson += (i == 0 ? "{\"v\": " : ", {\"v\": ") + std::to_string(i) + "}";
+	}
+	json += "], " + lstJson + "]}";
+
+	const DeserFlag::Flag flags[] = {
+			DeserFlag::kNoneFlag, DeserFlag::kMoveFromIntermediateDoc, DeserFlag::kReuseFields
+	};
+	for (size_t i = 0; i < sizeof(flags) / sizeof(flags[0]); ++i) {
+		PaArraySt st;
+		int ret = st._.Deserialize(json, DeserFlag::kParallelArray | flags[i]);
+		ASSERT_EQ(ret, 0);
+		ASSERT_EQ(st.vec.size(), static_cast<size_t>(size));
+		for (int k = 0; k < size; ++k) {
+			CheckPaArrOutput(st.vec[k], k);
+		}
+		ASSERT_EQ(st.lst.size(), static_cast<size_t>(size));
+		int k = 0;
+		for (std::list<PaArrInner>::const_iterator it = st.lst.begin(); it != st.lst.end(); ++it, ++k) {
+			ASSERT_EQ(it->v, k);
+		}
+
+		// Elements deserialized in threads do not share allocator of parent
+		ASSERT_NE(&st.vec[size - 1]._.GetAllocator(), &st._.GetAllocator());
+	}
+
+	// Error is reported at the first failed element
+	{
+		string errJson = json;
+		const string failed1 = "\"name\": \"name_4500\"";
+		errJson.replace(errJson.find(failed1), failed1.size(), "\"name\": 4500");
+		const string failed2 = "\"name\": \"name_3000\"";
+		errJson.replace(errJson.find(failed2), failed2.size(), "\"name\": 3000");
+
+		PaArraySt st;
+		rapidjson::Document errDoc;
+		int ret = st._.Deserialize(errJson, DeserFlag::kParallelArray, &errDoc);
+		ASSERT_EQ(ret, ErrorCode::kDeserializeValueTypeError);
+		ASSERT_EQ(st.vec.size(), 3000u);
+		ASSERT_STREQ(errDoc["err"]["type"].GetString(), "ErrInArray");
+		ASSERT_EQ(errDoc["err"]["index"].GetUint(), 3000u);
+		ASSERT_STREQ(errDoc["err"]["err"]["member"].GetString(), "name");
+
+		// Same as deserializing in one thread
+		PaArraySt serialSt;
+		rapidjson::Document serialErrDoc;
+		ret = serialSt._.Deserialize(errJson, DeserFlag::kNoneFlag, &serialErrDoc);
+		ASSERT_EQ(ret, ErrorCode::kDeserializeValueTypeError);
+		ASSERT_TRUE(errDoc == serialErrDoc);
+	}
+}
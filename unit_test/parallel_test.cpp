@@ -0,0 +1,162 @@
+//
+// Test of thread pool and batch deserialization
+//
+#include "util.h"
+#include <ijst/parallel.h>
+#include <atomic>
+#include <sstream>
+
+using std::string;
+using std::vector;
+using namespace ijst;
+
+IJST_DEFINE_STRUCT(
+		PaInner
+		, (T_int, v, "v", 0)
+)
+
+IJST_DEFINE_STRUCT(
+		PaSt
+		, (T_int, id, "id", 0)
+		, (T_string, name, "name", FDesc::Optional)
+		, (IJST_TVEC(IJST_TST(PaInner)), inners, "inners", FDesc::Optional)
+		, (IJST_TMAP(IJST_TST(PaInner)), innerMap, "inner_map", FDesc::Optional)
+)
+
+namespace {
+string PaInput(int id)
+{
+	std::ostringstream oss;
+	oss << "{\"id\": " << id << ", \"name\": \"name_" << id << "\", \"inners\": [{\"v\": " << id
+		<< "}], \"inner_map\": {\"k\": {\"v\": " << id * 2 << "}}}";
+	return oss.str();
+}
+
+void CheckPaOutput(const PaSt& st, int id)
+{
+	ASSERT_EQ(st.id, id);
+	ASSERT_EQ(st.name, "name_" + std::to_string(id));
+	ASSERT_EQ(st.inners.size(), 1u);
+	ASSERT_EQ(st.inners[0].v, id);
+	ASSERT_EQ(st.innerMap.size(), 1u);
+	ASSERT_EQ(st.innerMap.at("k").v, id * 2);
+}
+}	// namespace
+
+TEST(Parallel, ThreadPool)
+{
+	const unsigned threadCounts[] = {1, 2, 4, 0};
+	for (size_t i = 0; i < sizeof(threadCounts) / sizeof(threadCounts[0]); ++i) {
+		ThreadPool pool(threadCounts[i]);
+		if (threadCounts[i] != 0) {
+			ASSERT_EQ(pool.GetThreadCount(), threadCounts[i]);
+		}
+
+		// Each task runs exactly once, tasks with uneven costs
+		const size_t taskCounts[] = {0, 1, 3, 1000};
+		for (size_t j = 0; j < sizeof(taskCounts) / sizeof(taskCounts[0]); ++j) {
+			vector<std::atomic<int> > counters(taskCounts[j]);
+			for (size_t k = 0; k < counters.size(); ++k) {
+				counters[k] = 0;
+			}
+			pool(taskCounts[j], [&counters](size_t k) {
+				if (k < 10) {
+					std::this_thread::sleep_for(std::chrono::milliseconds(1));
+				}
+				++counters[k];
+			});
+			for (size_t k = 0; k < counters.size(); ++k) {
+				ASSERT_EQ(counters[k].load(), 1);
+			}
+		}
+
+		// Nested call runs in the calling thread
+		std::atomic<int> sum(0);
+		pool(8, [&pool, &sum](size_t k) {
+			pool(8, [&sum, k](size_t l) { sum += static_cast<int>(k * 8 + l); });
+		});
+		ASSERT_EQ(sum.load(), 63 * 64 / 2);
+	}
+}
+
+TEST(Parallel, BatchDeserialize)
+{
+	vector<string> inputs;
+	for (int i = 0; i < 200; ++i) {
+		if (i == 10) {
+			inputs.push_back("{\"id\": 10,");
+		}
+		else if (i == 150) {
+			inputs.push_back("{\"id\": 150, \"inners\": [{\"v\": \"1\"}]}");
+		}
+		else {
+			inputs.push_back(PaInput(i));
+		}
+	}
+
+	const DeserFlag::Flag flags[] = {
+			DeserFlag::kNoneFlag, DeserFlag::kNoIntermediateDoc, DeserFlag::kMoveFromIntermediateDoc
+	};
+	ThreadPool pool(4);
+	for (size_t i = 0; i < sizeof(flags) / sizeof(flags[0]); ++i) {
+		// Run twice to reuse contexts of workers
+		for (int round = 0; round < 2; ++round) {
+			vector<PaSt> outputs(1);
+			vector<string> errMsgs;
+			vector<int> rets = BatchDeserialize(inputs, outputs, pool, flags[i], &errMsgs);
+			ASSERT_EQ(rets.size(), inputs.size());
+			ASSERT_EQ(outputs.size(), inputs.size());
+			ASSERT_EQ(errMsgs.size(), inputs.size());
+			for (int k = 0; k < static_cast<int>(inputs.size()); ++k) {
+				if (k == 10) {
+					ASSERT_EQ(rets[k], ErrorCode::kDeserializeParseFailed);
+					ASSERT_NE(errMsgs[k].find("\"ParseError\""), string::npos);
+				}
+				else if (k == 150) {
+					ASSERT_EQ(rets[k], ErrorCode::kDeserializeValueTypeError);
+					ASSERT_NE(errMsgs[k].find("\"inners\""), string::npos);
+				}
+				else {
+					ASSERT_EQ(rets[k], 0);
+					ASSERT_TRUE(errMsgs[k].empty());
+					CheckPaOutput(outputs[k], k);
+				}
+			}
+		}
+	}
+
+	// User-supplied executor
+	{
+		vector<PaSt> outputs;
+		size_t calledCount = 0;
+		vector<int> rets = BatchDeserialize(
+				inputs, outputs,
+				[&calledCount](size_t taskCount, const std::function<void(size_t)>& task) {
+					++calledCount;
+					for (size_t k = 0; k < taskCount; ++k) {
+						task(k);
+					}
+				});
+		ASSERT_EQ(calledCount, 1u);
+		ASSERT_EQ(rets[10], ErrorCode::kDeserializeParseFailed);
+		ASSERT_EQ(rets[150], ErrorCode::kDeserializeValueTypeError);
+		CheckPaOutput(outputs[199], 199);
+	}
+
+	// Default thread pool
+	{
+		vector<PaSt> outputs;
+		vector<int> rets = BatchDeserialize(inputs, outputs);
+		ASSERT_EQ(rets[10], ErrorCode::kDeserializeParseFailed);
+		ASSERT_EQ(rets[0], 0);
+		CheckPaOutput(outputs[0], 0);
+	}
+
+	// Empty inputs
+	{
+		vector<PaSt> outputs(2);
+		vector<int> rets = BatchDeserialize(vector<string>(), outputs, pool);
+		ASSERT_TRUE(rets.empty());
+		ASSERT_TRUE(outputs.empty());
+	}
+}
@@ -59,6 +59,12 @@ string GetJsonVal<string>(rapidjson::Value& jVal)
 	return string(jVal.GetString(), jVal.GetStringLength());
 }
 
+template <>
+T_strview GetJsonVal<T_strview>(rapidjson::Value& jVal)
+{
+	return T_strview(jVal.GetString(), jVal.GetStringLength());
+}
+
 #define UTEST_DEFINE_STRUCT(StName, PrimType) 				\
 	IJST_DEFINE_STRUCT(										\
 		StName												\
@@ -449,6 +455,73 @@ TEST(Primitive, Str)
 }
 
 
+UTEST_DEFINE_STRUCT(StStrView, T_strview)
+TEST(Primitive, StrView)
+{
+	// Deserialize error
+	{
+		string errorJson = "{\"f_v\": 0}";
+		TestMemberTypeMismatch<StStrView>(errorJson, "string", "0");
+	}
+
+	const string json = "{\"f_vd\": \"\", \"f_v\": \"true\""
+			", \"f_map\": {\"v1\": \"false\", \"v2\": \"v22\"}, \"f_obj\": {\"o0\": \"o0\", \"o1\": \"o1\"}"
+			", \"f_vec\": [\"0\", \"1\"], \"f_deq\": [\"\", \"null\"], \"f_list\": [\"0\", \"NaN\"]}";
+
+	TestSt<StStrView, T_strview>(
+			json, "\"\"", ""
+			, "true", "false", "v22", "0", "1", "", "null", "0", "NaN", "o0", "o1"
+			, "false", "0.2", "0.4", "map1", "true", "map3", "", "0", "NaN", "null", "o00", "o11"
+	);
+
+	// Basic API
+	{
+		const string str = "string";
+		T_strview view(str);
+		ASSERT_EQ(view.data(), str.data());
+		ASSERT_EQ(view.size(), str.size());
+		ASSERT_EQ(view.str(), str);
+		ASSERT_EQ(view[1], 't');
+		ASSERT_TRUE(T_strview().empty());
+		ASSERT_TRUE(T_strview("str") < T_strview("string"));
+		ASSERT_TRUE(T_strview("string") < T_strview("strinh"));
+		ASSERT_TRUE(T_strview("str") != T_strview("string"));
+	}
+
+	// Point to the source buffer when moving from document parsed in situ
+	const string longJson = "{\"f_v\": \"a long string that is not stored in the value itself\""
+			", \"f_vec\": [\"v1\"], \"f_map\": {\"k\": \"a long string in map that is not stored in the value\"}}";
+	{
+		vector<char> buffer(longJson.begin(), longJson.end());
+		buffer.push_back('\0');
+		rapidjson::Document doc;
+		doc.ParseInsitu(&buffer[0]);
+		ASSERT_FALSE(doc.HasParseError());
+
+		StStrView st;
+		ASSERT_EQ(st._.MoveFromJson(doc, DeserFlag::kNotCheckFieldStatus), 0);
+		ASSERT_EQ(st.v.str(), "a long string that is not stored in the value itself");
+		ASSERT_GE(st.v.data(), &buffer.front());
+		ASSERT_LE(st.v.data(), &buffer.back());
+		ASSERT_GE(st.map_v["k"].data(), &buffer.front());
+		ASSERT_LE(st.map_v["k"].data(), &buffer.back());
+		ASSERT_EQ(st.vec_v[0], T_strview("v1"));
+	}
+
+	// Copy to allocator of accessor
+	const DeserFlag::Flag flags[] = {DeserFlag::kNoneFlag, DeserFlag::kNoIntermediateDoc};
+	for (size_t i = 0; i < sizeof(flags) / sizeof(flags[0]); ++i)
+	{
+		StStrView st;
+		ASSERT_EQ(st._.Deserialize(longJson, flags[i] | DeserFlag::kNotCheckFieldStatus), 0);
+		ASSERT_EQ(st.v.str(), "a long string that is not stored in the value itself");
+		ASSERT_EQ(st.map_v["k"].str(), "a long string in map that is not stored in the value");
+		ASSERT_EQ(st.vec_v[0], T_strview("v1"));
+		ASSERT_GT(st._.GetAllocator().Size(), st.v.size() + st.map_v["k"].size());
+		ASSERT_EQ(st._.GetMemoryUsage().stringBytes, 0u);
+	}
+}
+
 UTEST_DEFINE_STRUCT(StRaw, T_raw)
 
 void CheckStRawDeserialize(StRaw &st)
@@ -3,8 +3,10 @@
 //
 
 #include "util.h"
+#include <ijst/stream.h>
 
 #include <rapidjson/prettywriter.h>
+#include <limits>
 #include <sstream>
 
 using std::vector;
@@ -186,6 +188,149 @@ TEST(Serialize, Unknown)
 	}
 }
 
+TEST(Serialize, ToBuffer)
+{
+	ObjRefSt st;
+	st._.GetUnknown().AddMember("addi_o1", rapidjson::Value().SetString("str_\xe4\xb8\xad").Move(), st._.GetAllocator());
+	IJST_MARK_VALID(st, inner);
+	IJST_SET(st.inner, int_2, 11);
+	st.inner_v.resize(2);
+	IJST_MARK_VALID(st, inner_v);
+
+	string expected;
+	ASSERT_EQ(st._.Serialize(expected, SerFlag::kIgnoreMissing), 0);
+
+	// Dry run
+	ASSERT_EQ(st._.GetSerializedSize(SerFlag::kIgnoreMissing), expected.size());
+	ASSERT_GT(st._.GetSerializedSize(), expected.size());
+	std::basic_string<rapidjson::UTF16<>::Ch> u16Expected;
+	ASSERT_EQ(st._.Serialize<rapidjson::UTF16<> >(u16Expected, SerFlag::kIgnoreMissing), 0);
+	ASSERT_EQ(st._.GetSerializedSize<rapidjson::UTF16<> >(SerFlag::kIgnoreMissing), u16Expected.size());
+
+	// Append to string
+	string output = "prefix";
+	output.reserve(output.size() + st._.GetSerializedSize(SerFlag::kIgnoreMissing));
+	ASSERT_EQ(st._.SerializeAppend(output, SerFlag::kIgnoreMissing), 0);
+	ASSERT_EQ(output, "prefix" + expected);
+	ASSERT_EQ(st._.Serialize(output, SerFlag::kIgnoreMissing), 0);
+	ASSERT_EQ(output, expected);
+
+	// Buffer
+	std::vector<char> buffer(expected.size() + 1, 'x');
+	size_t size = 0;
+	ASSERT_EQ(st._.Serialize(&buffer[0], buffer.size(), size, SerFlag::kIgnoreMissing), 0);
+	ASSERT_EQ(size, expected.size());
+	ASSERT_EQ(string(&buffer[0], size), expected);
+	ASSERT_EQ(buffer.back(), 'x');
+
+	// Buffer is not enough
+	std::fill(buffer.begin(), buffer.end(), 'x');
+	ASSERT_EQ(st._.Serialize(&buffer[0], 5, size, SerFlag::kIgnoreMissing), ErrorCode::kWriteFailed);
+	ASSERT_EQ(size, expected.size());
+	ASSERT_EQ(string(&buffer[0], 5), expected.substr(0, 5));
+	ASSERT_EQ(buffer[5], 'x');
+	ASSERT_EQ(st._.Serialize(NULL, 0, size, SerFlag::kIgnoreMissing), ErrorCode::kWriteFailed);
+	ASSERT_EQ(size, expected.size());
+}
+
+IJST_DEFINE_STRUCT(
+		DoubleSt
+		, (T_int, int_1, "int_val_1", 0)
+		, (T_double, double_1, "double_val_1", 0)
+)
+
+TEST(Serialize, OutputNotModifiedOnError)
+{
+	DoubleSt st;
+	IJST_SET(st, int_1, 1);
+	// NaN could not be written by rapidjson::Writer
+	IJST_SET(st, double_1, std::numeric_limits<double>::quiet_NaN());
+
+	string output = "untouched";
+	ASSERT_EQ(st._.Serialize(output), ErrorCode::kWriteFailed);
+	ASSERT_EQ(output, "untouched");
+	ASSERT_EQ(ijst::Serialize(st, output), ErrorCode::kWriteFailed);
+	ASSERT_EQ(output, "untouched");
+
+	// SerializeAppend() keeps the part which has been written
+	ASSERT_EQ(st._.SerializeAppend(output), ErrorCode::kWriteFailed);
+	ASSERT_EQ(output.compare(0, 10, "untouched{"), 0);
+}
+
+namespace {
+string ReadFile(std::FILE* fp)
+{
+	std::rewind(fp);
+	string ret;
+	char buf[64];
+	size_t n;
+	while ((n = std::fread(buf, 1, sizeof(buf), fp)) > 0) {
+		ret.append(buf, n);
+	}
+	return ret;
+}
+}	// namespace
+
+TEST(Serialize, ToStream)
+{
+	ObjRefSt st;
+	st._.GetUnknown().AddMember("addi_o1", rapidjson::Value().SetString("str_o1").Move(), st._.GetAllocator());
+	IJST_MARK_VALID(st, inner);
+	IJST_SET(st.inner, int_2, 11);
+	st.inner_v.resize(20);
+	IJST_MARK_VALID(st, inner_v);
+
+	string expected;
+	ASSERT_EQ(st._.Serialize(expected, SerFlag::kIgnoreMissing), 0);
+	ASSERT_GT(expected.size(), 64u);
+
+	// rapidjson stream
+	{
+		rapidjson::StringBuffer sb;
+		ASSERT_EQ(st._.SerializeToStream(sb, SerFlag::kIgnoreMissing), 0);
+		ASSERT_EQ(string(sb.GetString(), sb.GetSize()), expected);
+	}
+
+	// FILE*, with buffer smaller than output
+	{
+		std::FILE* fp = std::tmpfile();
+		ASSERT_TRUE(fp != NULL);
+		char buffer[16];
+		FileOutputStream os(fp, buffer, sizeof(buffer));
+		ASSERT_EQ(st._.SerializeToStream(os, SerFlag::kIgnoreMissing), 0);
+		ASSERT_FALSE(os.HasError());
+		ASSERT_EQ(ReadFile(fp), expected);
+		std::fclose(fp);
+	}
+
+#if defined(__unix__) || defined(__APPLE__)
+	// Write to read-only file
+	{
+		std::FILE* fp = std::fopen("/dev/null", "r");
+		ASSERT_TRUE(fp != NULL);
+		char buffer[16];
+		FileOutputStream os(fp, buffer, sizeof(buffer));
+		ASSERT_EQ(st._.SerializeToStream(os), ErrorCode::kWriteFailed);
+		ASSERT_TRUE(os.HasError());
+		std::fclose(fp);
+	}
+
+	// File descriptor
+	{
+		std::FILE* fp = std::tmpfile();
+		ASSERT_TRUE(fp != NULL);
+		char buffer[16];
+		FdOutputStream os(fileno(fp), buffer, sizeof(buffer));
+		ASSERT_EQ(st._.SerializeToStream(os, SerFlag::kIgnoreMissing), 0);
+		ASSERT_EQ(ReadFile(fp), expected);
+		std::fclose(fp);
+
+		FdOutputStream errOs(-1, buffer, sizeof(buffer));
+		ASSERT_EQ(st._.SerializeToStream(errOs), ErrorCode::kWriteFailed);
+	}
+#endif
+}
+
 IJST_DEFINE_STRUCT(
 		Complicate1
 		, (IJST_TST(Inner), i1, "i1_v", 0)
@@ -519,3 +664,145 @@ TEST(Serialize, GeneratorWrapper)
 		CheckComplicate3Serialized(doc);
 	}
 }
+
+IJST_DEFINE_STRUCT(
+	StaticSerSt
+	, (T_int, i, "i_v", FDesc::Nullable)
+	, (T_double, d)
+	, (T_string, s, FDesc::Optional)
+	, (T_raw, raw, "raw_v", FDesc::Optional)
+	, (IJST_TVEC(IJST_TST(Inner)), vo, "vo_v", FDesc::Optional)
+	, (IJST_TMAP(IJST_TVEC(T_int)), mv, "mv_v", FDesc::Optional)
+	, (IJST_TOBJ(T_bool), obj, "obj_v", FDesc::Optional)
+	, (T_int, ui, (&IJSTI_FSERIALIZER_INS(T_uint, rapidjson::UTF8<>)))
+	, (T_int, ui2, "ui2_v", FDesc::Optional, (&IJSTI_FSERIALIZER_INS(T_uint, rapidjson::UTF8<>)))
+)
+
+IJST_DEFINE_VALUE(
+	StaticSerVal, IJST_TVEC(IJST_TST(StaticSerSt)), v, 0
+)
+
+template<typename T>
+void CheckStaticSerializeSameAsIntf(const T& st, SerFlag::Flag serFlag)
+{
+	std::string expected;
+	ASSERT_EQ(st._.Serialize(expected, serFlag), 0);
+
+	// To string
+	std::string json;
+	ASSERT_EQ(ijst::Serialize(st, json, serFlag), 0);
+	ASSERT_EQ(json, expected);
+
+	// To writer
+	rapidjson::StringBuffer buf;
+	rapidjson::Writer<rapidjson::StringBuffer> writer(buf);
+	ASSERT_EQ(ijst::Serialize(st, writer, serFlag), 0);
+	ASSERT_EQ(std::string(buf.GetString(), buf.GetSize()), expected);
+}
+
+TEST(Serialize, StaticDispatch)
+{
+	StaticSerSt st;
+	st.d = 1.5;
+	st.s = "str";
+	IJST_MARK_NULL(st, i);
+	st.raw.V().SetObject().AddMember("rk", 1, st.raw.GetAllocator());
+	st.vo.resize(2);
+	st.vo[1].int_1 = 1;
+	IJST_SET(st.vo[1], str_2, "v2");
+	st.mv["k1"].push_back(1);
+	st.mv["k2"];
+	st.obj.push_back(T_Member<T_bool>("b1", true));
+	st.ui = -1;
+	st.ui2 = 2;
+	IJST_MARK_VALID(st, d);
+	IJST_MARK_VALID(st, s);
+	IJST_MARK_VALID(st, raw);
+	IJST_MARK_VALID(st, vo);
+	IJST_MARK_VALID(st, mv);
+	IJST_MARK_VALID(st, obj);
+	IJST_MARK_VALID(st, ui);
+
+	// Fields are serialized via the generated code
+	CheckStaticSerializeSameAsIntf(st, SerFlag::kNoneFlag);
+	CheckStaticSerializeSameAsIntf(st, SerFlag::kIgnoreMissing);
+	CheckStaticSerializeSameAsIntf(st, SerFlag::kIgnoreNull | SerFlag::kIgnoreMissing);
+
+	// Serialize intf declared in IDL is still used
+	{
+		rapidjson::Document doc;
+		std::string json;
+		ASSERT_EQ(ijst::Serialize(st, json), 0);
+		doc.Parse(json.c_str());
+		ASSERT_FALSE(doc.HasParseError());
+		ASSERT_EQ(doc["ui"].GetUint(), 4294967295u);
+		ASSERT_TRUE(doc["i_v"].IsNull());
+		ASSERT_EQ(doc["raw_v"]["rk"].GetInt(), 1);
+	}
+
+	// Unknown
+	{
+		StaticSerSt st2;
+		const std::string json = "{\"i_v\": 3, \"d\": 2.5, \"ui\": 1, \"unknown\": [1, {\"x\": null}]}";
+		ASSERT_EQ(st2._.Deserialize(json), 0);
+		CheckStaticSerializeSameAsIntf(st2, SerFlag::kNoneFlag);
+		CheckStaticSerializeSameAsIntf(st2, SerFlag::kIgnoreUnknown);
+	}
+
+	// Value
+	{
+		StaticSerVal val;
+		val.v.push_back(st);
+		val.v.push_back(StaticSerSt());
+		CheckStaticSerializeSameAsIntf(val, SerFlag::kNoneFlag);
+	}
+
+	// Big struct
+	{
+		Complicate3 st3;
+		InitComplicate3(st3);
+		CheckStaticSerializeSameAsIntf(st3, SerFlag::kNoneFlag);
+	}
+}
+
+IJST_DEFINE_STRUCT(
+		NumberVecSt
+		, (IJST_TVEC(T_int), vi, "vi", 0)
+		, (IJST_TVEC(T_uint), vu, "vu", 0)
+		, (IJST_TVEC(T_int64), vi64, "vi64", 0)
+		, (IJST_TVEC(T_uint64), vu64, "vu64", 0)
+		, (IJST_TVEC(T_double), vd, "vd", 0)
+		, (IJST_TVEC(IJST_TVEC(T_double)), vvd, "vvd", 0)
+)
+
+TEST(Serialize, NumberVector)
+{
+	NumberVecSt st;
+	st.vi.push_back(-1);
+	st.vi.push_back(2);
+	st.vu.push_back(4294967295u);
+	st.vi64.push_back(-4294967296LL);
+	st.vu64.push_back(18446744073709551615ULL);
+	st.vd.push_back(1.5);
+	st.vd.push_back(-2.0);
+	st.vvd.resize(2);
+	st.vvd[1].push_back(0.25);
+
+	const std::string expected = "{\"vi\":[-1,2],\"vu\":[4294967295],\"vi64\":[-4294967296],\"vu64\":[18446744073709551615]"
+			",\"vd\":[1.5,-2.0],\"vvd\":[[],[0.25]]}";
+	// Via HandlerBase
+	std::string json;
+	ASSERT_EQ(st._.Serialize(json), 0);
+	ASSERT_EQ(json, expected);
+	// Via static dispatch
+	CheckStaticSerializeSameAsIntf(st, SerFlag::kNoneFlag);
+
+	// Whole array is written by HandlerWrapper
+	rapidjson::StringBuffer buf;
+	rapidjson::Writer<rapidjson::StringBuffer> writer(buf);
+	ijst::HandlerWrapper<rapidjson::Writer<rapidjson::StringBuffer> > writerWrapper(writer);
+	ASSERT_TRUE(writerWrapper.StartArray());
+	ASSERT_TRUE(writerWrapper.IntArray(&st.vi[0], 2));
+	ASSERT_TRUE(writerWrapper.EndArray());
+	ASSERT_STREQ(buf.GetString(), "[[-1,2]]");
+}